@@ -10,8 +10,810 @@
  *	ainsi que la fonction check_gain() de data_models.c pour vérifier si un
  *	état donné correspond à une fin de jeu ou non.
  */
+#include <SDL_timer.h>
+#include <SDL_thread.h>
+
 #include "ai.h"
+#include "resolues.h"
+#include "ouvertures.h"
+
+static etat_recherche recherche; ///< Budget et compteurs de la recherche AlphaBeta en cours
+static etat_recherche budget_impose = {0, 0, 0, 0, -1, false, 0}; ///< Budget imposé par #fixe_budget_recherche() (aucun par défaut)
+
+static bool ordonnancement_actif = true; ///< Vrai si les coups de l'AlphaBeta sont ordonnés (voir #genere_coups())
+static bool connexions_actives = true; ///< Vrai si l'AlphaBeta consulte les connexions virtuelles (voir #verdict_connexions())
+static bool inferieures_actives = true; ///< Vrai si l'AlphaBeta écarte les cases inférieures (voir #cases_inferieures())
+static int nombre_fils = 0; ///< Nombre de fils d'exécution des recherches (0: autant que de processeurs)
+static int mode_parallele = PARALLELE_RACINE; ///< Mode de recherche parallèle (voir #fixe_mode_parallele())
+static unsigned int graine_recherche = 0; ///< Graine du mode reproductible (0 si le mode est désactivé)
+static contexte_recherche contextes[NB_FILS_MAX]; ///< Contextes des fils de recherche (conservés d'une recherche à l'autre)
+
+/*!
+ *	\brief	Répartition des coups à la racine d'une itération entre les fils de recherche
+ *	\author	Julien Laurent
+ *
+ *	Chaque fil prend le prochain coup non cherché, le cherche sur sa propre copie du plateau, puis
+ *	relève si besoin la meilleure valeur trouvée (\a alpha), que les fils suivants utilisent pour
+ *	restreindre leur fenêtre de recherche.
+ */
+struct travail_racine
+{
+	const plateau *p; ///< Plateau à la racine (que chaque fil recopie)
+	char pion; ///< Couleur du pion joué par l'IA
+	int (*eval) (plateau *, char); ///< Fonction d'évaluation des feuilles
+	int horizon; ///< Horizon de l'itération
+	int coups[DIM_MAX*DIM_MAX]; ///< Coups à chercher (indices dans les #bitboard), dans l'ordre
+	int valeurs[DIM_MAX*DIM_MAX]; ///< Valeur (ou majorant, voir #cherche_racine()) trouvée pour chaque coup
+	int nb_coups; ///< Nombre de coups à chercher
+	volatile int prochain; ///< Rang du prochain coup à chercher (partagé entre les fils)
+	volatile int alpha; ///< Meilleure valeur exacte trouvée jusqu'ici (partagée entre les fils)
+};
+typedef struct travail_racine travail_racine; ///< Raccourci d'utilisation du type #travail_racine
+
+/*!
+ *	\brief	Paramètres d'un fil de recherche à la racine
+ *	\author	Julien Laurent
+ */
+struct fil_racine
+{
+	travail_racine *travail; ///< Travail partagé de l'itération
+	contexte_recherche *ctx; ///< Contexte propre au fil
+};
+typedef struct fil_racine fil_racine; ///< Raccourci d'utilisation du type #fil_racine
+
+/*!
+ *	\brief	Paramètres d'un fil auxiliaire de la recherche "Lazy SMP"
+ *	\author	Julien Laurent
+ *
+ *	Chaque fil auxiliaire mène sa propre recherche par approfondissement itératif, sur son propre
+ *	#travail_racine (dont il est le seul fil), jusqu'à ce que le fil principal ait terminé.
+ */
+struct fil_auxiliaire
+{
+	travail_racine travail; ///< Travail privé du fil
+	fil_racine fil; ///< Paramètres transmis à #cherche_racine()
+	int numero; ///< Numéro du fil (de 1 au nombre de fils moins un)
+	int horizon_limite; ///< Horizon au-delà duquel il est inutile de chercher
+};
+typedef struct fil_auxiliaire fil_auxiliaire; ///< Raccourci d'utilisation du type #fil_auxiliaire
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	level Niveau de l'IA (la difficulté choisie dans les menus, de 5 à 9)
+ *	\return	Temps de réflexion accordé, en millisecondes
+ *
+ *	Chaque niveau double le temps de réflexion: de 0,5 s pour "Facile" (5) à 8 s pour "Nash 2 en 1" (9).
+ */
+unsigned int duree_reflexion(int level)
+{
+	if(level < 4)
+	{
+		level = 4;
+	}
+	else if(level > 9)
+	{
+		level = 9;
+	}
+	return DUREE_REFLEXION_BASE << (level - 4);
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	duree_max Temps de réflexion (en ms, 0 si illimité)
+ *	\param	noeuds_max Nombre maximal de nœuds (0 si illimité)
+ *	\param	horizon_max Horizon maximal (négatif si illimité)
+ *
+ *	Le budget imposé remplace celui qui découle du niveau des IA: un horizon fixe sans limite de
+ *	temps permet par exemple des mesures reproductibles. L'appel avec (0, 0, -1) rétablit le
+ *	fonctionnement normal.
+ */
+void fixe_budget_recherche(unsigned int duree_max, unsigned long noeuds_max, int horizon_max)
+{
+	budget_impose.duree_max = duree_max;
+	budget_impose.noeuds_max = noeuds_max;
+	budget_impose.horizon_max = horizon_max;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\return	Nombre de nœuds cherchés (feuilles comprises) lors de la dernière recherche
+ */
+unsigned long noeuds_recherche(void)
+{
+	return recherche.noeuds;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\return	Valeur du meilleur coup de la dernière itération complète (100 pour une victoire assurée, 0 si aucune itération n'a abouti)
+ *
+ *	Permet aux bancs d'essai de vérifier qu'une amélioration de la recherche n'en change pas le résultat.
+ */
+int valeur_recherche(void)
+{
+	return recherche.valeur;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	actif Vrai pour ordonner les coups (par défaut), faux pour les parcourir dans l'ordre des cases
+ *
+ *	Ne sert qu'à mesurer l'apport de l'ordonnancement (voir ordonnancementTestBed() dans main.c).
+ */
+void active_ordonnancement(bool actif)
+{
+	ordonnancement_actif = actif;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	actif Vrai pour consulter les connexions virtuelles (par défaut), faux pour s'en passer
+ *
+ *	Ne sert qu'à mesurer l'apport des connexions virtuelles (voir connexionsTestBed() dans main.c).
+ */
+void active_connexions(bool actif)
+{
+	connexions_actives = actif;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	actif Vrai pour écarter les cases inférieures (par défaut), faux pour chercher toutes les cases vides
+ *
+ *	Ne sert qu'à mesurer l'apport de l'élagage (voir inferieuresTestBed() dans main.c).
+ */
+void active_inferieures(bool actif)
+{
+	inferieures_actives = actif;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	nb_fils Nombre de fils d'exécution (0 pour utiliser tous les processeurs)
+ */
+void fixe_nombre_fils(int nb_fils)
+{
+	nombre_fils = (nb_fils < 0) ? 0 : (nb_fils > NB_FILS_MAX) ? NB_FILS_MAX : nb_fils;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	mode #PARALLELE_RACINE (par défaut) ou #PARALLELE_LAZY_SMP
+ *
+ *	En mode #PARALLELE_RACINE, les coups de chaque itération sont répartis entre les fils (voir
+ *	#cherche_iteration()). En mode #PARALLELE_LAZY_SMP, le fil principal cherche seul, pendant que
+ *	des fils auxiliaires mènent la même recherche avec des horizons et un ordre des coups décalés
+ *	(voir #cherche_auxiliaire()): ils ne font que remplir la table de transposition partagée, où le
+ *	fil principal trouve ensuite des résultats tout faits. Les deux modes sont comparés par
+ *	parallelismeTestBed() (main.c).
+ */
+void fixe_mode_parallele(int mode)
+{
+	mode_parallele = (mode == PARALLELE_LAZY_SMP) ? PARALLELE_LAZY_SMP : PARALLELE_RACINE;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	graine Graine du générateur pseudo-aléatoire (0 pour désactiver le mode reproductible)
+ *
+ *	En mode reproductible, le générateur pseudo-aléatoire est réinitialisé avec la graine au début
+ *	de chaque recherche, et la table de transposition ne coupe que sur des entrées de même horizon.
+ *	Avec un horizon fixe (voir #fixe_budget_recherche()), le coup choisi ne dépend alors plus ni du
+ *	nombre de fils, ni de l'ordre dans lequel ils terminent leur travail: seul le nombre de nœuds
+ *	cherchés varie. C'est le mode à utiliser pour les tests de non-régression.
+ */
+void fixe_graine_recherche(unsigned int graine)
+{
+	graine_recherche = graine;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	ctx Contexte de recherche à préparer
+ *
+ *	Les coups tueurs de la recherche précédente (relatifs à d'autres positions) sont oubliés,
+ *	et les scores d'historique sont divisés par deux, pour favoriser les informations récentes.
+ */
+static void vieillis_ordonnancement(contexte_recherche *ctx)
+{
+	int couleur, k;
+
+	for ( k = 0 ; k < DIM_MAX*DIM_MAX ; k++ )
+	{
+		ctx->tueurs[k][0] = ctx->tueurs[k][1] = -1;
+	}
+
+	for ( couleur = 0 ; couleur < 2 ; couleur++ )
+	{
+		for ( k = 0 ; k < BITS_BITBOARD ; k++ )
+		{
+			ctx->historique[couleur][k] /= 2;
+		}
+	}
+
+	ctx->noeuds = 0;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	ctx Contexte du fil de recherche
+ *	\param	p Pointeur sur le plateau (avant que le coup ne soit joué)
+ *	\param	k Indice (dans les #bitboard) du coup ayant provoqué la coupure
+ *	\param	joueur Couleur du pion joué
+ *	\param	iterations Horizon restant au nœud où la coupure a eu lieu
+ *
+ *	Le coup devient le premier coup tueur de sa profondeur (le précédent devient le second), et son
+ *	score d'historique augmente d'autant plus que le sous-arbre coupé était grand.
+ */
+static void enregistre_coupure(contexte_recherche *ctx, const plateau *p, int k, char joueur, int iterations)
+{
+	int couleur = indice_couleur(joueur), c;
+	unsigned int *historique = ctx->historique[couleur];
+	int *tueurs = ctx->tueurs[p->nb_coups];
+
+	if(tueurs[0] != k)
+	{
+		tueurs[1] = tueurs[0];
+		tueurs[0] = k;
+	}
+
+	historique[k] += iterations * iterations;
+	if(historique[k] > HISTORIQUE_MAX) // Les scores restent bornés (seul leur ordre compte)
+	{
+		for ( c = 0 ; c < BITS_BITBOARD ; c++ )
+		{
+			historique[c] /= 2;
+		}
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	ctx Contexte du fil de recherche
+ *	\param	p Pointeur sur le plateau du nœud
+ *	\param	joueur Couleur du pion à jouer
+ *	\param	coup_table Meilleur coup connu du nœud (case y * dim + x, issu de la table de transposition), ou #AUCUN_COUP
+ *	\param	jouables Cases à jouer (les cases vides, ou la zone obligatoire donnée par #verdict_connexions())
+ *	\param	coups Tableau à remplir avec les coups jouables (indices dans les #bitboard)
+ *	\param	scores Tableau à remplir avec le score d'ordonnancement de chaque coup
+ *	\return	Nombre de coups jouables
+ *
+ *	Ordre de priorité: coup de la table de transposition, puis coups tueurs de la profondeur courante,
+ *	puis score d'historique, et enfin (à historique égal) nombre de \a bridges formés ou bloqués
+ *	par le coup. Quand l'ordonnancement est désactivé, tous les scores sont nuls (ordre des cases).
+ */
+static int genere_coups(const contexte_recherche *ctx, const plateau *p, char joueur, int coup_table, bitboard jouables, int coups[], int scores[])
+{
+	int k, n = 0, x, y, tt = -1;
+	const unsigned int *historique = ctx->historique[indice_couleur(joueur)];
+	const int *tueurs = ctx->tueurs[p->nb_coups];
+
+	if(coup_table != AUCUN_COUP)
+	{
+		tt = indice_case(p, coup_table % p->dim, coup_table / p->dim);
+	}
+
+	while((k = bb_extrait(&jouables)) >= 0)
+	{
+		coups[n] = k;
+
+		if(!ordonnancement_actif)
+		{
+			scores[n] = 0;
+		}
+		else if(k == tt)
+		{
+			scores[n] = SCORE_TABLE;
+		}
+		else if(k == tueurs[0])
+		{
+			scores[n] = SCORE_TUEUR;
+		}
+		else if(k == tueurs[1])
+		{
+			scores[n] = SCORE_TUEUR - 1;
+		}
+		else
+		{
+			x = k % p->largeur;
+			y = k / p->largeur - 2;
+			scores[n] = (historique[k] << 6) + losanges_potentiels(p, x, y, joueur) + losanges_potentiels(p, x, y, couleur_opposee(joueur));
+		}
+		n++;
+	}
+
+	return n;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	coups Coups jouables
+ *	\param	scores Scores d'ordonnancement des coups
+ *	\param	c Rang du coup à choisir (les coups de rang inférieur ont déjà été joués)
+ *	\param	n Nombre de coups jouables
+ *	\return	Indice (dans les #bitboard) du coup de meilleur score parmi les coups restants
+ *
+ *	Tri par sélection "paresseux": seuls les coups effectivement joués avant une coupure sont triés.
+ *	À score égal, l'ordre des cases est conservé.
+ */
+static int choisit_coup(int coups[], int scores[], int c, int n)
+{
+	int m, meilleur = c, tmp;
+
+	for ( m = c+1 ; m < n ; m++ )
+	{
+		if(scores[m] > scores[meilleur])
+		{
+			meilleur = m;
+		}
+	}
+
+	tmp = coups[c]; coups[c] = coups[meilleur]; coups[meilleur] = tmp;
+	tmp = scores[c]; scores[c] = scores[meilleur]; scores[meilleur] = tmp;
+
+	return coups[c];
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	level Niveau de l'IA
+ *
+ *	Remet les compteurs à zéro, et fixe les limites de la recherche qui commence.
+ */
+static void debute_recherche(int level)
+{
+	int f;
+
+	recherche = budget_impose;
+	if(recherche.duree_max == 0 && recherche.noeuds_max == 0 && recherche.horizon_max < 0)
+	{
+		recherche.duree_max = duree_reflexion(level);
+	}
+	recherche.debut = SDL_GetTicks();
+	recherche.noeuds = 0;
+	recherche.interrompue = false;
+	recherche.valeur = 0;
+
+	for ( f = 0 ; f < NB_FILS_MAX ; f++ )
+	{
+		vieillis_ordonnancement(&contextes[f]);
+	}
+
+	if(graine_recherche != 0)
+	{
+		srand(graine_recherche);
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	ctx Contexte du fil de recherche
+ *	\param	tous Vrai pour reporter tous les nœuds comptés par le fil (en fin de travail)
+ *
+ *	Les nœuds comptés par chaque fil ne sont reportés dans le compteur partagé que par paquets de
+ *	#INTERVALLE_CHRONO: c'est aussi à ce moment que l'horloge et la limite de nœuds sont consultées.
+ */
+static void reporte_noeuds(contexte_recherche *ctx, bool tous)
+{
+	unsigned long total;
+
+	if(!tous && ctx->noeuds < INTERVALLE_CHRONO)
+	{
+		return;
+	}
+
+	total = __sync_add_and_fetch(&recherche.noeuds, ctx->noeuds);
+	ctx->noeuds = 0;
+
+	if(recherche.noeuds_max > 0 && total > recherche.noeuds_max)
+	{
+		recherche.interrompue = true;
+	}
+	else if(recherche.duree_max > 0 && SDL_GetTicks() - recherche.debut >= recherche.duree_max)
+	{
+		recherche.interrompue = true;
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	ctx Contexte du fil de recherche
+ *	\return	Vrai si le budget de la recherche en cours est épuisé
+ *
+ *	Compte le nœud courant. L'horloge n'est consultée que tous les #INTERVALLE_CHRONO nœuds,
+ *	son coût restant ainsi négligeable.
+ */
+static inline bool budget_epuise(contexte_recherche *ctx)
+{
+	ctx->noeuds++;
+	reporte_noeuds(ctx, false);
+
+	return recherche.interrompue;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur le plateau à évaluer
+ *	\param	pion Couleur du pion au sommet de l'arbre
+ *	\param	eval Pointeur sur la fonction d'évaluation à utiliser
+ *	\return	Valeur de la feuille selon \a eval
+ *
+ *	#eval_losanges() ne fait que lire les sommes tenues à jour par #pose_pion(): elle coûte moins
+ *	qu'une consultation des tables de condensats, et est donc appelée directement. Les autres
+ *	fonctions d'évaluation passent par #hashEvaluation().
+ */
+static inline int evalue_feuille(plateau *p, char pion, int (*eval) (plateau *, char))
+{
+	if(eval == eval_losanges)
+	{
+		return eval_losanges(p, pion);
+	}
+
+	return hashEvaluation(p, pion, eval);
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	entree Entrée de la table de transposition correspondant au nœud
+ *	\param	iterations Horizon demandé pour le nœud
+ *	\param	alpha Meilleure valeur maximale trouvée avant l'appel
+ *	\param	beta Meilleure valeur minimale trouvée avant l'appel
+ *	\return	Vrai si la valeur de l'entrée peut être renvoyée sans chercher le nœud
+ *
+ *	Il faut que l'entrée provienne d'une recherche au moins aussi profonde (de même profondeur en mode
+ *	reproductible), et que sa valeur soit exacte, ou bien une borne qui tombe de toute façon hors de
+ *	la fenêtre [alpha, beta].
+ */
+static bool coupure_transposition(const entree_transposition *entree, int iterations, int alpha, int beta)
+{
+	if(entree->profondeur < iterations || (graine_recherche != 0 && entree->profondeur != iterations))
+	{
+		return false;
+	}
+
+	switch(entree->borne)
+	{
+		case BORNE_EXACTE:
+			return true;
+		break;
+
+		case BORNE_INFERIEURE:
+			return entree->valeur >= beta;
+		break;
+
+		case BORNE_SUPERIEURE:
+			return entree->valeur <= alpha;
+		break;
+
+		default:
+			return false;
+		break;
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	val Valeur trouvée pour le nœud
+ *	\param	alpha Valeur de alpha à l'appel
+ *	\param	beta Valeur de beta à l'appel
+ *	\return	Nature de la valeur, pour la table de transposition
+ */
+static int nature_borne(int val, int alpha, int beta)
+{
+	if(val <= alpha) // Coupure alpha (ou aucun coup meilleur que alpha): la valeur est un majorant
+	{
+		return BORNE_SUPERIEURE;
+	}
+	else if(val >= beta) // Coupure bêta: la valeur est un minorant
+	{
+		return BORNE_INFERIEURE;
+	}
+	return BORNE_EXACTE;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	ctx Contexte du fil de recherche (connexions virtuelles de la position courante)
+ *	\param	joueur Couleur du joueur qui a le trait
+ *	\param	jouables Cases vides, restreintes si besoin à la zone obligatoire du joueur
+ *	\return	1 si le joueur est assuré de gagner, -1 s'il est assuré de perdre, 0 sinon
+ *
+ *	Le joueur gagne si ses frontières sont reliées par une connexion pleine ou une semi-connexion
+ *	(il n'a qu'à jouer la clé), et perd si celles de l'adversaire le sont par une connexion pleine.
+ *	Si elles ne le sont que par une semi-connexion, tout coup hors de la zone obligatoire perd:
+ *	seuls les coups de cette zone restent à chercher (et aucun si elle est vide).
+ */
+static int verdict_connexions(const contexte_recherche *ctx, char joueur, bitboard *jouables)
+{
+	int couleur = indice_couleur(joueur);
+	bitboard zone;
+
+	if(connexion_frontieres(ctx->connexions[couleur]) || semi_connexion_frontieres(ctx->connexions[couleur], &zone))
+	{
+		return 1;
+	}
+	else if(connexion_frontieres(ctx->connexions[1-couleur]))
+	{
+		return -1;
+	}
+	else if(semi_connexion_frontieres(ctx->connexions[1-couleur], &zone))
+	{
+		*jouables = bb_et(*jouables, zone);
+		if(bb_est_nul(*jouables))
+		{
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	ctx Contexte du fil de recherche
+ *	\param	k Indice de la case jouée
+ *	\param	joueur Couleur du coup
+ *	\param	iterations Horizon restant après le coup
+ *
+ *	Met à jour les connexions virtuelles des deux couleurs après un coup (à annuler par
+ *	#dejoue_connexions_fil()). Les nouvelles connexions ne sont recherchées que si l'horizon restant
+ *	(#HORIZON_FERMETURE) laisse au sous-arbre le temps d'amortir leur coût.
+ */
+static void joue_connexions_fil(contexte_recherche *ctx, int k, char joueur, int iterations)
+{
+	joue_connexions(ctx->connexions[0], k, indice_couleur(joueur), iterations >= HORIZON_FERMETURE);
+	joue_connexions(ctx->connexions[1], k, indice_couleur(joueur), iterations >= HORIZON_FERMETURE);
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	ctx Contexte du fil de recherche
+ */
+static void dejoue_connexions_fil(contexte_recherche *ctx)
+{
+	dejoue_connexions(ctx->connexions[0]);
+	dejoue_connexions(ctx->connexions[1]);
+}
+
+
+/*!
+ *	\author	Julien Laurent
+ *	\return	Nombre de fils d'exécution à utiliser pour la recherche qui commence
+ *
+ *	Ce nombre (fixé par #fixe_nombre_fils()) vaut aussi pour la recherche Monte-Carlo.
+ */
+int compte_fils(void)
+{
+	int nb_fils = (nombre_fils > 0) ? nombre_fils : nombre_coeurs();
+
+	return (nb_fils > NB_FILS_MAX) ? NB_FILS_MAX : nb_fils;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	donnees Pointeur sur le #fil_racine décrivant le travail du fil
+ *	\return	0
+ *
+ *	Fonction exécutée par chaque fil de recherche à la racine (voir #travail_racine).
+ *	Chaque coup est cherché avec la fenêtre ]alpha-1, 1000[, où alpha est la meilleure valeur connue
+ *	au moment où le coup est pris: la valeur obtenue est exacte si elle atteint alpha (ce qui détecte
+ *	aussi les coups de même valeur que le meilleur), et n'est sinon qu'un majorant, inférieur à
+ *	alpha (le coup est alors de toute façon moins bon). Le choix final ne dépend donc pas de l'ordre
+ *	dans lequel les fils traitent les coups.
+ *	Si l'horizon est suffisant, le fil calcule d'abord les connexions virtuelles de la racine, que
+ *	l'AlphaBeta tient ensuite à jour coup par coup.
+ */
+static int cherche_racine(void *donnees)
+{
+	fil_racine *fil = donnees;
+	travail_racine *travail = fil->travail;
+	plateau p = *travail->p; // Copie de travail propre au fil
+	int c, k, i, j, val, alpha, couleur;
+	bool suivi = connexions_actives && travail->horizon >= HORIZON_CONNEXIONS;
+
+	for ( couleur = 0 ; suivi && couleur < 2 ; couleur++ )
+	{
+		if(fil->ctx->connexions[couleur] == NULL)
+		{
+			fil->ctx->connexions[couleur] = nouvelle_base_connexions();
+		}
+		calcule_connexions(fil->ctx->connexions[couleur], &p, couleur);
+	}
+
+	while(!recherche.interrompue && (c = __sync_fetch_and_add(&travail->prochain, 1)) < travail->nb_coups)
+	{
+		k = travail->coups[c];
+		i = k / p.largeur - 2;
+		j = k % p.largeur;
+		alpha = travail->alpha;
+
+		joue_coup(&p, j, i, travail->pion); // On simule le coup
+		if(suivi)
+		{
+			joue_connexions_fil(fil->ctx, k, travail->pion, travail->horizon);
+		}
+
+		// On récole sa valeur à l'aide de l'arbre (construction par AlphaBeta)
+		val = alphaBetaMin(&p, j, i, alpha-1, 1000, travail->horizon, travail->pion, travail->eval, fil->ctx);
+
+		if(suivi)
+		{
+			dejoue_connexions_fil(fil->ctx);
+		}
+		dejoue_coup(&p);// On dé-joue le coup
+
+		travail->valeurs[c] = val;
+		while(val > (alpha = travail->alpha)) // Mise à jour atomique de la meilleure valeur
+		{
+			__sync_val_compare_and_swap(&travail->alpha, alpha, val);
+		}
+	}
+
+	reporte_noeuds(fil->ctx, true);
+	return 0;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	travail Travail de l'itération, prêt à être cherché
+ *
+ *	Répartit les coups de l'itération entre les fils de recherche, et attend qu'ils aient terminé.
+ *	Avec un seul fil (ou en mode #PARALLELE_LAZY_SMP, où les autres fils cherchent de leur côté),
+ *	la recherche se fait directement dans le fil appelant.
+ */
+static void cherche_iteration(travail_racine *travail)
+{
+	SDL_Thread *fils[NB_FILS_MAX];
+	fil_racine parametres[NB_FILS_MAX];
+	int f, nb_fils = (mode_parallele == PARALLELE_RACINE) ? compte_fils() : 1; // ("Lazy SMP": le fil principal cherche seul)
+
+	if(nb_fils > travail->nb_coups) // Inutile d'avoir plus de fils que de coups
+	{
+		nb_fils = travail->nb_coups;
+	}
 
+	travail->prochain = 0;
+	travail->alpha = -1000;
+
+	for ( f = 0 ; f < nb_fils ; f++ )
+	{
+		parametres[f].travail = travail;
+		parametres[f].ctx = &contextes[f];
+	}
+
+	if(nb_fils <= 1)
+	{
+		cherche_racine(&parametres[0]);
+		return;
+	}
+
+	for ( f = 0 ; f < nb_fils ; f++ )
+	{
+		fils[f] = SDL_CreateThread(cherche_racine, &parametres[f]);
+		if(fils[f] == NULL) // Si le fil n'a pas pu être créé, les autres se partagent son travail
+		{				// (et le fil appelant s'en charge si aucun n'a pu être créé)
+			if(f == 0)
+			{
+				cherche_racine(&parametres[0]);
+				return;
+			}
+			break;
+		}
+	}
+
+	while(f-- > 0)
+	{
+		SDL_WaitThread(fils[f], NULL);
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	donnees Pointeur sur le #fil_auxiliaire décrivant le travail du fil
+ *	\return	0
+ *
+ *	Fonction exécutée par chaque fil auxiliaire de la recherche "Lazy SMP". Pour que les fils ne
+ *	cherchent pas tous les mêmes nœuds au même moment, un fil sur deux commence à l'horizon 1, et
+ *	chaque fil décale l'ordre des coups de la racine de son numéro. D'une itération à l'autre, le
+ *	meilleur coup trouvé passe en tête. Seule la table de transposition profite de ce travail: les
+ *	valeurs trouvées par le fil ne sont pas utilisées directement.
+ */
+static int cherche_auxiliaire(void *donnees)
+{
+	fil_auxiliaire *aux = donnees;
+	travail_racine *travail = &aux->travail;
+	int c, meilleur, tmp;
+
+	for ( travail->horizon = aux->numero % 2 ; travail->horizon <= aux->horizon_limite ; travail->horizon++ )
+	{
+		travail->prochain = 0;
+		travail->alpha = -1000;
+		cherche_racine(&aux->fil);
+
+		if(recherche.interrompue)
+		{
+			break;
+		}
+
+		// Le premier coup de meilleure valeur (le fil n'a pas à tirer au hasard) passe en tête
+		for ( c = 0, meilleur = 0 ; c < travail->nb_coups ; c++ )
+		{
+			if(travail->valeurs[c] > travail->valeurs[meilleur])
+			{
+				meilleur = c;
+			}
+		}
+		tmp = travail->coups[meilleur];
+		travail->coups[meilleur] = travail->coups[0];
+		travail->coups[0] = tmp;
+	}
+
+	return 0;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Plateau à la racine de la recherche
+ *	\param	pion Couleur du pion joué par l'IA
+ *	\param	eval Fonction d'évaluation des feuilles
+ *	\param	horizon_limite Horizon maximal de la recherche
+ *	\param	auxiliaires Paramètres des fils auxiliaires (autant que de fils, le premier restant inutilisé)
+ *	\param	fils Fils auxiliaires créés (même taille)
+ *	\return	Nombre de cases remplies dans \a fils (le fil principal compris, qui n'est pas créé)
+ *
+ *	Lance les fils auxiliaires de la recherche "Lazy SMP" (voir #fixe_mode_parallele()). Chacun
+ *	commence avec les coups de la racine dans l'ordre des cases, décalé de son numéro.
+ */
+static int lance_auxiliaires(const plateau *p, char pion, int (*eval) (plateau *, char), int horizon_limite, fil_auxiliaire auxiliaires[], SDL_Thread *fils[])
+{
+	int f, c, nb_coups = 0, nb_fils = compte_fils();
+	int coups[DIM_MAX*DIM_MAX];
+	bitboard vides = cases_vides(p);
+
+	while((coups[nb_coups] = bb_extrait(&vides)) >= 0)
+	{
+		nb_coups++;
+	}
+
+	for ( f = 1 ; f < nb_fils ; f++ )
+	{
+		auxiliaires[f].numero = f;
+		auxiliaires[f].horizon_limite = horizon_limite;
+		auxiliaires[f].travail.p = p;
+		auxiliaires[f].travail.pion = pion;
+		auxiliaires[f].travail.eval = eval;
+		auxiliaires[f].travail.nb_coups = nb_coups;
+		for ( c = 0 ; c < nb_coups ; c++ )
+		{
+			auxiliaires[f].travail.coups[c] = coups[(c + f) % nb_coups];
+		}
+		auxiliaires[f].fil.travail = &auxiliaires[f].travail;
+		auxiliaires[f].fil.ctx = &contextes[f];
+
+		if((fils[f] = SDL_CreateThread(cherche_auxiliaire, &auxiliaires[f])) == NULL)
+		{
+			break; // (La recherche se contente des fils déjà créés)
+		}
+	}
+
+	return f;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	fils Fils auxiliaires lancés par #lance_auxiliaires()
+ *	\param	nb_fils Valeur renvoyée par #lance_auxiliaires()
+ *
+ *	Interrompt les fils auxiliaires (le fil principal ayant terminé), et attend leur fin.
+ */
+static void arrete_auxiliaires(SDL_Thread *fils[], int nb_fils)
+{
+	recherche.interrompue = true;
+	while(--nb_fils > 0)
+	{
+		SDL_WaitThread(fils[nb_fils], NULL);
+	}
+}
 
 /*!
  *	\author	Julien Laurent
@@ -32,7 +834,7 @@ coord ia_hasard(plateau p, char pion, int level)
 	{	// On récole des couples de coordonnées au hasard
 		a_renvoyer.x = hasard(0, p.dim-1);
 		a_renvoyer.y = hasard(0, p.dim-1);
-	}while(p.tab[a_renvoyer.y][a_renvoyer.x] != 'V');
+	}while(case_plateau(&p, a_renvoyer.x, a_renvoyer.y) != 'V');
 	// Jusqu'à obtenir un couple valide
 
 	//Puis on renvoie le tout
@@ -44,59 +846,160 @@ coord ia_hasard(plateau p, char pion, int level)
  *	\author	Julien Laurent
  *	\param	p Copie du plateau sur lequel l'IA doit jouer
  *	\param	pion Couleur du pion joué par l'IA
- *	\param	level Horizon à utiliser pour l'évaluation d'un coup
- *	\return Coordonnées à jouer (choisies grâce à l'évaluation basée sur les losanges
+ *	\param	level Niveau de l'IA, qui détermine son temps de réflexion (voir #duree_reflexion())
+ *	\param	eval Fonction d'évaluation des feuilles de l'arbre
+ *	\return Coordonnées à jouer (choisies grâce à la fonction d'évaluation)
  *
- *	Cette Intelligence Artificielle utilise l'algorithme de construction d'arbre
- *	de jeu AlphaBeta, couplé à la fonction d'évaluation eval_losanges() du fichier
- *	eval_functions.c pour renvoyer des coordonnées (valides) à jouer.
+ *	Recherche commune aux Intelligences Artificielles Losanges et Electrique: l'algorithme de
+ *	construction d'arbre de jeu AlphaBeta, couplé à la fonction d'évaluation passée en paramètre
+ *	(déclarée dans eval_functions.h), renvoie des coordonnées (valides) à jouer.
+ *	La recherche procède par approfondissement itératif: tous les coups sont évalués avec
+ *	l'horizon 0, puis 1, puis 2... jusqu'à épuisement du temps de réflexion. Le coup renvoyé
+ *	est le meilleur de la dernière itération complète (celle qui est interrompue est ignorée,
+ *	et le coup tiré au hasard au départ n'est renvoyé que si aucune itération n'a abouti).
+ *	Les itérations successives sont peu coûteuses grâce à la table de transposition, qui
+ *	fournit à chaque itération les meilleurs coups de la précédente. La table est conservée d'un
+ *	coup à l'autre (ses entrées vieillissent, voir #vieillisTransposition()): la position à jouer a
+ *	souvent été cherchée par la recherche précédente, dont le meilleur coup passe alors en tête.
+ *	Les coups de chaque itération sont répartis entre plusieurs fils d'exécution (voir
+ *	#cherche_iteration()), ou bien cherchés par le seul fil appelant, épaulé par des fils
+ *	auxiliaires (voir #fixe_mode_parallele()). Parmi les coups de meilleure valeur, le coup joué
+ *	est tiré au hasard.
+ *	Une position gagnée des tables de positions résolues (voir resolues.h), ou une position du livre
+ *	d'ouvertures (voir ouvertures.h), est jouée sans recherche.
  */
-coord ia_losanges(plateau p, char pion, int level)
+static coord cherche_coup(plateau p, char pion, int level, int (*eval) (plateau *, char))
 {
 	coord a_renvoyer = ia_hasard(p,pion,level);
-	int i,j, val=-100, ancienne_val=-100;
+	int c, k, horizon, nb_ex_aequo, meilleure_val, tmp;
+	int horizon_limite = bb_compte(cases_vides(&p)) - 1;
+	int ex_aequo[DIM_MAX*DIM_MAX];
+	bitboard vides;
+	entree_transposition entree;
+	travail_racine *travail = malloc(sizeof(travail_racine));
+	fil_auxiliaire *auxiliaires = malloc(NB_FILS_MAX * sizeof(fil_auxiliaire));
+	SDL_Thread *fils[NB_FILS_MAX];
+	int nb_auxiliaires = 0;
 
+	p.tab = NULL; // La recherche ne doit pas toucher à la matrice du plateau affiché
 
-	// On parcourt l'intégralité des coups actuellement jouables
-	for ( i = 0 ; i < p.dim ; i++ )
+	if(coup_table_resolue(&p, pion, &a_renvoyer)) // Position résolue: le coup gagnant est connu sans recherche
 	{
-		for ( j = 0 ; j < p.dim ; j++ )
-		{
-			if(p.tab[i][j] == 'V')
-			{
-				p.tab[i][j] = pion; // On simule le coup
+		printf("##################\nCoup de la table: [%d,%d]\n##################\n", a_renvoyer.x+1, a_renvoyer.y+1);
+		free(auxiliaires);
+		free(travail);
+		return a_renvoyer;
+	}
+	if(coup_livre_ouvertures(&p, pion, &a_renvoyer)) // Position du livre d'ouvertures: le coup a été cherché d'avance
+	{
+		printf("##################\nCoup du livre: [%d,%d]\n##################\n", a_renvoyer.x+1, a_renvoyer.y+1);
+		free(auxiliaires);
+		free(travail);
+		return a_renvoyer;
+	}
 
-				// On récole sa valeur à l'aide de l'arbre (construction par AlphaBeta)
-				val = alphaBetaMin(&p, j, i, -1000, 1000, level, pion, eval_losanges);
+	vieillisTransposition(); // Nouvelle recherche: les entrées précédentes deviennent remplaçables
+	debute_recherche(level);
+	if(graine_recherche != 0) // (En mode reproductible, le coup de secours est tiré après la graine)
+	{
+		a_renvoyer = ia_hasard(p,pion,level);
+	}
+	if(sondeTransposition(cleTransposition(&p, pion, true), &entree) && entree.meilleur_coup < p.dim * p.dim
+		&& case_plateau(&p, entree.meilleur_coup % p.dim, entree.meilleur_coup / p.dim) == 'V')
+	{	// Position déjà cherchée (deux coups plus bas) par la recherche précédente: son meilleur coup est cherché en
+		a_renvoyer.x = entree.meilleur_coup % p.dim; // premier, s'il est jouable (une entrée périmée ou en collision
+		a_renvoyer.y = entree.meilleur_coup / p.dim; // peut désigner une case occupée, qui serait alors renvoyée)
+	}
 
-				p.tab[i][j] = 'V';// On dé-joue le coup
+	if(recherche.horizon_max >= 0 && recherche.horizon_max < horizon_limite)
+	{
+		horizon_limite = recherche.horizon_max;
+	}
 
-				// (Debug) On affiche la valeur relevée
-				printf("Valeur du coup [%d, %d] : %d\n", j+1, i+1, val);
+	travail->p = &p;
+	travail->pion = pion;
+	travail->eval = eval;
 
-				if(val > ancienne_val) // Si la valeur est meilleure que les valeurs
-				{					// précédemment trouvées, on la promeut.
-					ancienne_val = val;
-					a_renvoyer.y = i;
-					a_renvoyer.x = j;
-					printf("Promotion de [%d,%d] via MinMax\n", j+1, i+1);
-				}
-				else if(val == ancienne_val)
+	if(mode_parallele == PARALLELE_LAZY_SMP && horizon_limite >= 0)
+	{
+		nb_auxiliaires = lance_auxiliaires(&p, pion, eval, horizon_limite, auxiliaires, fils);
+	}
+
+	for ( horizon = 0 ; horizon <= horizon_limite ; horizon++ )
+	{
+		// On commence par le meilleur coup de l'itération précédente, puis on parcourt
+		// l'intégralité des coups actuellement jouables
+		vides = cases_vides(&p);
+		k = indice_case(&p, a_renvoyer.x, a_renvoyer.y);
+		bb_retire(&vides, k);
+		travail->nb_coups = 0;
+		while(k >= 0)
+		{
+			travail->coups[travail->nb_coups++] = k;
+			k = bb_extrait(&vides);
+		}
+		travail->horizon = horizon;
+
+		cherche_iteration(travail);
+
+		if(recherche.interrompue) // Budget épuisé: l'itération en cours est abandonnée
+		{
+			break;
+		}
+
+		// Relevé des coups de meilleure valeur, dans l'ordre des cases
+		meilleure_val = travail->alpha;
+		nb_ex_aequo = 0;
+		for ( c = 0 ; c < travail->nb_coups ; c++ )
+		{
+			if(travail->valeurs[c] == meilleure_val)
+			{
+				for ( k = nb_ex_aequo++ ; k > 0 && ex_aequo[k-1] > travail->coups[c] ; k-- )
 				{
-					if(!hasard(0,2))
-					{
-						a_renvoyer.y = i;
-						a_renvoyer.x = j;
-					}
+					ex_aequo[k] = ex_aequo[k-1];
 				}
+				ex_aequo[k] = travail->coups[c];
 			}
 		}
+
+		tmp = ex_aequo[hasard(0, nb_ex_aequo-1)]; // Itération complète: un de ses meilleurs coups est retenu
+		recherche.valeur = meilleure_val;
+		a_renvoyer.x = tmp % p.largeur;
+		a_renvoyer.y = tmp / p.largeur - 2;
+
+		// (Debug) On affiche le résultat de l'itération
+		printf("Horizon %d: [%d,%d] (valeur %d, %d ex aequo, %lu noeuds, %u ms)\n", horizon, a_renvoyer.x+1, a_renvoyer.y+1,
+				meilleure_val, nb_ex_aequo, recherche.noeuds, SDL_GetTicks() - recherche.debut);
+
+		if(meilleure_val >= 100) // Victoire assurée: inutile de chercher plus loin
+		{
+			break;
+		}
 	}
 
+	arrete_auxiliaires(fils, nb_auxiliaires);
+	free(auxiliaires);
+	free(travail);
+
 	printf("##################\nCoup choisi: [%d,%d]\n##################\n", a_renvoyer.x+1, a_renvoyer.y+1);
 	return a_renvoyer;
 }
 
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Copie du plateau sur lequel l'IA doit jouer
+ *	\param	pion Couleur du pion joué par l'IA
+ *	\param	level Niveau de l'IA, qui détermine son temps de réflexion (voir #duree_reflexion())
+ *	\return Coordonnées à jouer (choisies grâce à l'évaluation basée sur les losanges)
+ *
+ *	Cette Intelligence Artificielle utilise la recherche AlphaBeta de #cherche_coup(), couplée à la
+ *	fonction d'évaluation eval_losanges() du fichier eval_functions.c.
+ */
+coord ia_losanges(plateau p, char pion, int level)
+{
+	return cherche_coup(p, pion, level, eval_losanges);
+}
+
 /*!
  *	\author	Julien Laurent
  *	\param	p Pointeur sur le plateau à utiliser
@@ -113,7 +1016,8 @@ coord ia_losanges(plateau p, char pion, int level)
  */
 int minimisation(plateau *p, int x, int y, int iterations, char pion, int (*eval) (plateau *, char))
 {
-	int i,j;
+	int i,j,k;
+	bitboard vides;
 	int val = 100; // On veut minimiser, la valeur de départ doit donc
 				// être "maximale".
 
@@ -127,17 +1031,15 @@ int minimisation(plateau *p, int x, int y, int iterations, char pion, int (*eval
 	}
 	else // Sinon, on procède à des appels récursifs sur tous les "sous-plateaux"
 	{	// possibles, et on relève la plus petite valeur possible parmi les nœuds fils
-		for( i = 0 ; i < p->dim ; i++ ) // obtenus:
+		vides = cases_vides(p); // obtenus:
+		while((k = bb_extrait(&vides)) >= 0)
 		{
-			for( j = 0 ; j < p->dim ; j++ )
-			{
-				if(p->tab[i][j] == 'V')
-				{
-					p->tab[i][j] = couleur_opposee(pion); // On joue virtuellement le coup
-					val = low(val, maximisation(p, j, i, iterations-1, pion, eval)); // On construit le sous-arbre puis on met à jour la valeur "minimale"
-					p->tab[i][j] = 'V'; // On dé-joue le coup précédemment joué
-				}
-			}
+			i = k / p->largeur - 2;
+			j = k % p->largeur;
+
+			joue_coup(p, j, i, couleur_opposee(pion)); // On joue virtuellement le coup
+			val = low(val, maximisation(p, j, i, iterations-1, pion, eval)); // On construit le sous-arbre puis on met à jour la valeur "minimale"
+			dejoue_coup(p); // On dé-joue le coup précédemment joué
 		} // Une fois l'intégralité des sous-arbres construits, on renvoie la valeur retenue,
 		return val; // qui est la plus faible parmi les valeurs des sous-nœuds.
 	}
@@ -159,7 +1061,8 @@ int minimisation(plateau *p, int x, int y, int iterations, char pion, int (*eval
  */
 int maximisation(plateau *p, int x, int y, int iterations, char pion, int (*eval) (plateau *, char))
 {
-	int i,j;
+	int i,j,k;
+	bitboard vides;
 	int val=-100; // On veut maximiser, la valeur de départ doit donc
 				// être "minimale".
 
@@ -174,17 +1077,15 @@ int maximisation(plateau *p, int x, int y, int iterations, char pion, int (*eval
 	}
 	else // Sinon, on procède à des appels récursifs sur tous les "sous-plateaux"
 	{	// possibles, et on relève la plus petite valeur possible parmi les nœuds fils
-		for( i = 0 ; i < p->dim ; i++ ) // obtenus:
+		vides = cases_vides(p); // obtenus:
+		while((k = bb_extrait(&vides)) >= 0)
 		{
-			for( j = 0 ; j < p->dim ; j++ )
-			{
-				if(p->tab[i][j] == 'V')
-				{
-					p->tab[i][j] = pion; // On joue virtuellement le coup
-					val = high(val, minimisation(p, j, i, iterations-1, pion, eval)); // On construit le sous-arbre puis on met à jour la valeur "maximale"
-					p->tab[i][j] = 'V'; // On dé-joue le coup précédemment joué
-				}
-			}
+			i = k / p->largeur - 2;
+			j = k % p->largeur;
+
+			joue_coup(p, j, i, pion); // On joue virtuellement le coup
+			val = high(val, minimisation(p, j, i, iterations-1, pion, eval)); // On construit le sous-arbre puis on met à jour la valeur "maximale"
+			dejoue_coup(p); // On dé-joue le coup précédemment joué
 		} // Une fois l'intégralité des sous-arbres construits, on renvoie la valeur retenue,
 		return val; // qui est la plus faible parmi les valeurs des sous-nœuds.
 	}
@@ -200,49 +1101,127 @@ int maximisation(plateau *p, int x, int y, int iterations, char pion, int (*eval
  *	\param iterations Nombre d'itérations restantes (horizon)
  *	\param pion Couleur du pion au sommet de l'arbre
  *	\param eval Pointeur sur la fonction d'évaluation à utiliser
+ *	\param ctx Contexte du fil de recherche (coups tueurs, historique, compteur de nœuds)
  *
  *	Cette fonction implémente la minimisation de l'algorithme AlphaBeta, et utilise la fonction
  *	d'évaluation passée en paramètre pour donner une valeur aux feuilles de l'arbre à construire.
  *	A la différence de son homologue minimisation(), cette fonction ne parcourt pas naïvement l'intégralité
  *	de l'arbre de jeu, mais procède dès que possible à une coupure bêta, réduisant ainsi
  *	drastiquement le nombre de nœuds à évaluer.
+ *	Le résultat de chaque nœud intérieur est enregistré dans la table de transposition: un nœud
+ *	déjà rencontré (par un autre ordre de coups) est ainsi coupé directement si possible, et son
+ *	meilleur coup connu est sinon essayé en premier. Les autres coups sont ordonnés par
+ *	#genere_coups() (coups tueurs, historique, \a bridges), ce qui multiplie les coupures.
+ *	Loin de l'horizon, les connexions virtuelles concluent directement les positions gagnées ou
+ *	perdues, et limitent sinon les coups à la zone obligatoire (voir #verdict_connexions()). Les
+ *	cases inférieures (mortes, capturées ou dominées) ne sont pas cherchées (voir #cases_inferieures()).
  */
-int alphaBetaMin(plateau *p, int x, int y, int alpha, int beta, int iterations, char pion, int (*eval) (plateau *, char))
+int alphaBetaMin(plateau *p, int x, int y, int alpha, int beta, int iterations, char pion, int (*eval) (plateau *, char), contexte_recherche *ctx)
 {
-	int i,j;
+	int i,j,k,c,n, v, gagnant, alpha_initial = alpha, beta_initial = beta, meilleur_coup = AUCUN_COUP, coup_table = AUCUN_COUP;
+	int coups[DIM_MAX*DIM_MAX], scores[DIM_MAX*DIM_MAX];
+	entree_transposition entree;
+	uint64_t cle;
+	bitboard jouables;
+	bool suivi;
 	int val = 100; // On veut minimiser, la valeur de départ doit donc
 				// être "maximale".
 
-	if(check_gain(p->dim*2, x, y, p))	// Si la situation reçue en paramètre correspond
+	if(budget_epuise(ctx)) // Si le temps de réflexion est écoulé, on remonte au plus vite
+	{					// (la valeur renvoyée sera ignorée)
+		return 0;
+	}
+	else if(check_gain(p->dim*2, x, y, p))	// Si la situation reçue en paramètre correspond
 	{									// à une fin de partie, on renvoie une valeur très grande
 		return 100;						// (car c'est le joueur au sommet de l'arbre qui vient de jouer)
 	}
 	else if(iterations <= 0)	// Si le compteur d'itérations a atteint sa limite, on procède à
 	{							// l'évaluation de la situation, et on renvoie la valeur obtenue
-		return hashLosanges(p, pion);	// à la fonction appelante.
+		return evalue_feuille(p, pion, eval);	// à la fonction appelante.
 	}
 	else // Sinon, on procède à des appels récursifs sur tous les "sous-plateaux"
 	{	// possibles, et on relève la plus petite valeur possible parmi les nœuds fils
-		for( i = 0 ; i < p->dim ; i++ ) // obtenus:
+		cle = cleTransposition(p, pion, false); // obtenus. Mais d'abord, on consulte la table de transposition:
+		if(sondeTransposition(cle, &entree))
 		{
-			for( j = 0 ; j < p->dim ; j++ )
+			if(coupure_transposition(&entree, iterations, alpha, beta)) // Nœud déjà cherché assez profondément
 			{
-				if(p->tab[i][j] == 'V')
-				{
-					p->tab[i][j] = couleur_opposee(pion); // On joue virtuellement le coup
-					val = low(val, alphaBetaMax(p, j, i, alpha, beta, iterations-1, pion, eval)); // On construit le sous-arbre puis on met à jour la valeur "minimale"
-					p->tab[i][j] = 'V'; // On dé-joue le coup précédemment joué
+				return entree.valeur;
+			}
+			coup_table = entree.meilleur_coup; // Sinon, son meilleur coup connu sera essayé en premier
+		}
 
-					if(val <= alpha) // Si la valeur qu'on vient d'obtenir durant la minimisation
-					{				// est inférieure à la meilleure valeur maximale d'un ancêtre,
-						return val; // on peut procéder à une coupure alpha.
-					}
+		jouables = cases_vides(p);
+		if(connexions_actives && iterations >= HORIZON_CONNEXIONS) // Les connexions virtuelles peuvent
+		{												// conclure avant la fin de la partie
+			switch(verdict_connexions(ctx, couleur_opposee(pion), &jouables))
+			{
+				case 1:
+					return -100;
+				break;
 
-					beta = low(beta, val); // On met à jour la valeur de beta
-				}
+				case -1:
+					return 100;
+				break;
+
+				default:
+				break;
 			}
-		} // Une fois l'intégralité des sous-arbres construits, on renvoie la valeur retenue,
-		return val; // qui est la plus faible parmi les valeurs des sous-nœuds.
+		}
+		if(inferieures_actives && iterations >= HORIZON_INFERIEURES) // Les cases inférieures n'ont pas
+		{													// besoin d'être cherchées
+			jouables = bb_sauf(jouables, cases_inferieures(p, couleur_opposee(pion), &gagnant));
+			if(gagnant >= 0) // (Le remplissage a conclu la partie)
+			{
+				return (gagnant == indice_couleur(pion)) ? 100 : -100;
+			}
+			else if(bb_est_nul(jouables)) // Toute la zone obligatoire est dominée par des coups perdants
+			{
+				return 100;
+			}
+		}
+		suivi = connexions_actives && iterations-1 >= HORIZON_CONNEXIONS; // (Le fils les consultera-t-il ?)
+
+		n = genere_coups(ctx, p, couleur_opposee(pion), coup_table, jouables, coups, scores);
+		for ( c = 0 ; c < n ; c++ )
+		{
+			k = choisit_coup(coups, scores, c, n);
+			i = k / p->largeur - 2;
+			j = k % p->largeur;
+
+			joue_coup(p, j, i, couleur_opposee(pion)); // On joue virtuellement le coup
+			if(suivi)
+			{
+				joue_connexions_fil(ctx, k, couleur_opposee(pion), iterations-1);
+			}
+			v = alphaBetaMax(p, j, i, alpha, beta, iterations-1, pion, eval, ctx); // On construit le sous-arbre
+			if(suivi)
+			{
+				dejoue_connexions_fil(ctx);
+			}
+			dejoue_coup(p); // On dé-joue le coup précédemment joué
+
+			if(recherche.interrompue) // Sous-arbre interrompu: sa valeur n'a pas de sens
+			{						// (et ne doit pas être enregistrée)
+				return 0;
+			}
+
+			if(v < val) // puis on met à jour la valeur "minimale" (et le meilleur coup)
+			{
+				val = v;
+				meilleur_coup = i * p->dim + j;
+			}
+
+			if(val <= alpha) // Si la valeur qu'on vient d'obtenir durant la minimisation
+			{				// est inférieure à la meilleure valeur maximale d'un ancêtre,
+				enregistre_coupure(ctx, p, k, couleur_opposee(pion), iterations);
+				break;		// on peut procéder à une coupure alpha.
+			}
+
+			beta = low(beta, val); // On met à jour la valeur de beta
+		} // Une fois l'intégralité des sous-arbres construits (ou la coupure faite), on enregistre
+		stockeTransposition(cle, iterations, nature_borne(val, alpha_initial, beta_initial), val, meilleur_coup);
+		return val; // puis on renvoie la valeur retenue.
 	}
 }
 
@@ -256,63 +1235,160 @@ int alphaBetaMin(plateau *p, int x, int y, int alpha, int beta, int iterations,
  *	\param iterations Nombre d'itérations restantes (horizon)
  *	\param pion Couleur du pion au sommet de l'arbre
  *	\param eval Pointeur sur la fonction d'évaluation à utiliser
+ *	\param ctx Contexte du fil de recherche (coups tueurs, historique, compteur de nœuds)
  *
  *	Cette fonction implémente la maximisation de l'algorithme AlphaBeta, et utilise la fonction
  *	d'évaluation passée en paramètre pour donner une valeur aux feuilles de l'arbre à construire.
  *	A la différence de son homologue maximisation(), cette fonction ne parcourt pas naïvement l'intégralité
  *	de l'arbre de jeu, mais procède dès que possible à une coupure alpha, réduisant ainsi
  *	drastiquement le nombre de nœuds à évaluer.
+ *	Le résultat de chaque nœud intérieur est enregistré dans la table de transposition: un nœud
+ *	déjà rencontré (par un autre ordre de coups) est ainsi coupé directement si possible, et son
+ *	meilleur coup connu est sinon essayé en premier. Les autres coups sont ordonnés par
+ *	#genere_coups() (coups tueurs, historique, \a bridges), ce qui multiplie les coupures.
+ *	Loin de l'horizon, les connexions virtuelles concluent directement les positions gagnées ou
+ *	perdues, et limitent sinon les coups à la zone obligatoire (voir #verdict_connexions()). Les
+ *	cases inférieures (mortes, capturées ou dominées) ne sont pas cherchées (voir #cases_inferieures()).
  */
-int alphaBetaMax(plateau *p, int x, int y, int alpha, int beta, int iterations, char pion, int (*eval) (plateau *, char))
+int alphaBetaMax(plateau *p, int x, int y, int alpha, int beta, int iterations, char pion, int (*eval) (plateau *, char), contexte_recherche *ctx)
 {
-	int i,j;
+	int i,j,k,c,n, v, gagnant, alpha_initial = alpha, beta_initial = beta, meilleur_coup = AUCUN_COUP, coup_table = AUCUN_COUP;
+	int coups[DIM_MAX*DIM_MAX], scores[DIM_MAX*DIM_MAX];
+	entree_transposition entree;
+	uint64_t cle;
+	bitboard jouables;
+	bool suivi;
 	int val=-100; // On veut maximiser, la valeur de départ doit donc
 				// être "minimale".
 
-	if(check_gain(p->dim*2, x, y, p))	// Si la situation reçue en paramètre correspond
+	if(budget_epuise(ctx)) // Si le temps de réflexion est écoulé, on remonte au plus vite
+	{					// (la valeur renvoyée sera ignorée)
+		return 0;
+	}
+	else if(check_gain(p->dim*2, x, y, p))	// Si la situation reçue en paramètre correspond
 	{									// à une fin de partie, on renvoie une valeur très basse
 		return -100;					// (car c'est le joueur "adverse" qui vient de jouer)
 	}
 	else if(iterations <= 0)	// Si le compteur d'itérations a atteint sa limite, on procède à
 	{							// l'évaluation de la situation, et on renvoie la valeur obtenue
-		return hashLosanges(p, pion);	// à la fonction appelante.
+		return evalue_feuille(p, pion, eval);	// à la fonction appelante.
 	}
 	else // Sinon, on procède à des appels récursifs sur tous les "sous-plateaux"
 	{	// possibles, et on relève la plus petite valeur possible parmi les nœuds fils
-		for( i = 0 ; i < p->dim ; i++ ) // obtenus:
+		cle = cleTransposition(p, pion, true); // obtenus. Mais d'abord, on consulte la table de transposition:
+		if(sondeTransposition(cle, &entree))
 		{
-			for( j = 0 ; j < p->dim ; j++ )
+			if(coupure_transposition(&entree, iterations, alpha, beta)) // Nœud déjà cherché assez profondément
 			{
-				if(p->tab[i][j] == 'V')
-				{
-					p->tab[i][j] = pion; // On joue virtuellement le coup
-					val = high(val, alphaBetaMin(p, j, i, alpha, beta, iterations-1, pion, eval)); // On construit le sous-arbre puis on met à jour la valeur "maximale"
-					p->tab[i][j] = 'V'; // On dé-joue le coup précédemment joué
+				return entree.valeur;
+			}
+			coup_table = entree.meilleur_coup; // Sinon, son meilleur coup connu sera essayé en premier
+		}
 
-					if(val >= beta) // Si la valeur qu'on vient d'obtenir durant la maximisation
-					{				// est supérieure à la meilleure valeur minimale d'un ancêtre,
-						return val; // on peut procéder à une coupure bêta.
-					}
+		jouables = cases_vides(p);
+		if(connexions_actives && iterations >= HORIZON_CONNEXIONS) // Les connexions virtuelles peuvent
+		{												// conclure avant la fin de la partie
+			switch(verdict_connexions(ctx, pion, &jouables))
+			{
+				case 1:
+					return 100;
+				break;
 
-					alpha = high(alpha, val);
-				}
+				case -1:
+					return -100;
+				break;
+
+				default:
+				break;
 			}
-		} // Une fois l'intégralité des sous-arbres construits, on renvoie la valeur retenue,
-		return val; // qui est la plus faible parmi les valeurs des sous-nœuds.
+		}
+		if(inferieures_actives && iterations >= HORIZON_INFERIEURES) // Les cases inférieures n'ont pas
+		{													// besoin d'être cherchées
+			jouables = bb_sauf(jouables, cases_inferieures(p, pion, &gagnant));
+			if(gagnant >= 0) // (Le remplissage a conclu la partie)
+			{
+				return (gagnant == indice_couleur(pion)) ? 100 : -100;
+			}
+			else if(bb_est_nul(jouables)) // Toute la zone obligatoire est dominée par des coups perdants
+			{
+				return -100;
+			}
+		}
+		suivi = connexions_actives && iterations-1 >= HORIZON_CONNEXIONS; // (Le fils les consultera-t-il ?)
+
+		n = genere_coups(ctx, p, pion, coup_table, jouables, coups, scores);
+		for ( c = 0 ; c < n ; c++ )
+		{
+			k = choisit_coup(coups, scores, c, n);
+			i = k / p->largeur - 2;
+			j = k % p->largeur;
+
+			joue_coup(p, j, i, pion); // On joue virtuellement le coup
+			if(suivi)
+			{
+				joue_connexions_fil(ctx, k, pion, iterations-1);
+			}
+			v = alphaBetaMin(p, j, i, alpha, beta, iterations-1, pion, eval, ctx); // On construit le sous-arbre
+			if(suivi)
+			{
+				dejoue_connexions_fil(ctx);
+			}
+			dejoue_coup(p); // On dé-joue le coup précédemment joué
+
+			if(recherche.interrompue) // Sous-arbre interrompu: sa valeur n'a pas de sens
+			{						// (et ne doit pas être enregistrée)
+				return 0;
+			}
+
+			if(v > val) // puis on met à jour la valeur "maximale" (et le meilleur coup)
+			{
+				val = v;
+				meilleur_coup = i * p->dim + j;
+			}
+
+			if(val >= beta) // Si la valeur qu'on vient d'obtenir durant la maximisation
+			{				// est supérieure à la meilleure valeur minimale d'un ancêtre,
+				enregistre_coupure(ctx, p, k, pion, iterations);
+				break;		// on peut procéder à une coupure bêta.
+			}
+
+			alpha = high(alpha, val);
+		} // Une fois l'intégralité des sous-arbres construits (ou la coupure faite), on enregistre
+		stockeTransposition(cle, iterations, nature_borne(val, alpha_initial, beta_initial), val, meilleur_coup);
+		return val; // puis on renvoie la valeur retenue.
 	}
 }
 
 
 /*!
- *	\author N/A
+ *	\author Julien Laurent
  *	\param	p Copie du plateau sur lequel l'IA doit jouer
  *	\param	pion Couleur du pion joué par l'IA
- *	\param	level Horizon à utiliser pour l'évaluation d'un coup
+ *	\param	level Niveau de l'IA, qui détermine son temps de réflexion (voir #duree_reflexion())
  *	\return Coordonnées à jouer (choisies grâce à l'évaluation basée sur la résistance électrique du plateau)
  *
- *	(En travaux)
+ *	Cette Intelligence Artificielle utilise la recherche AlphaBeta de #cherche_coup(), couplée à la
+ *	fonction d'évaluation eval_resistance() du fichier eval_functions.c. Chaque évaluation étant
+ *	bien plus coûteuse (mais bien plus juste) qu'avec les losanges, la recherche est moins profonde.
  */
 coord ia_electrique(plateau p, char pion, int level)
 {
-	return ia_hasard(p,pion,level);
+	return cherche_coup(p, pion, level, eval_resistance);
+}
+
+/*!
+ *	\author Julien Laurent
+ *	\param	p Copie du plateau sur lequel l'IA doit jouer
+ *	\param	pion Couleur du pion joué par l'IA
+ *	\param	level Niveau de l'IA, qui détermine son temps de réflexion (voir #duree_reflexion())
+ *	\return Coordonnées à jouer (choisies grâce à l'évaluation par double distance du plateau)
+ *
+ *	Cette Intelligence Artificielle utilise la recherche AlphaBeta de #cherche_coup(), couplée à la
+ *	fonction d'évaluation eval_deux_distances() du fichier eval_functions.c. Les cartes de distances
+ *	étant mises à jour d'une feuille à l'autre, elle reste rapide sur les grands plateaux, où elle
+ *	remplace l'IA Losanges (voir #DIMENSION_MAX_LOSANGES).
+ */
+coord ia_deux_distances(plateau p, char pion, int level)
+{
+	return cherche_coup(p, pion, level, eval_deux_distances);
 }
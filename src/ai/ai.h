@@ -12,13 +12,87 @@
 #define AI_H_INCLUDED
 
 #include "hash_table.h"
+#include "connexions.h"
+#include "inferieures.h"
+#include "../engine/move_stack.h"
+
+#define DUREE_REFLEXION_BASE 250 ///< Temps de réflexion (en ms) d'une IA de niveau 4, doublé à chaque niveau supplémentaire
+#define INTERVALLE_CHRONO 1024 ///< Nombre de nœuds cherchés entre deux consultations de l'horloge
+
+#define SCORE_TABLE 0x7FFFFFFF ///< Score d'ordonnancement du meilleur coup connu (table de transposition)
+#define SCORE_TUEUR 0x7FFFFFF0 ///< Score d'ordonnancement du premier coup tueur (le second a ce score moins un)
+#define HISTORIQUE_MAX (1 << 24) ///< Score d'historique maximal d'une case (au-delà, tous les scores sont divisés par deux)
+#define HORIZON_CONNEXIONS 2 ///< Horizon restant à partir duquel l'AlphaBeta consulte les connexions virtuelles (en deçà, leur mise à jour coûterait plus qu'elle ne rapporte)
+#define HORIZON_FERMETURE 4 ///< Horizon restant à partir duquel la mise à jour des connexions virtuelles recherche les nouvelles connexions (voir #joue_connexions())
+#define HORIZON_INFERIEURES 1 ///< Horizon restant à partir duquel l'AlphaBeta écarte les cases inférieures (voir #cases_inferieures())
+
+#define DIMENSION_MAX_LOSANGES 7 ///< Dimension maximale des plateaux sur lesquels l'IA Losanges est proposée (au-delà, le bouton Losanges donne l'IA #ia_deux_distances())
+
+#define NB_FILS_MAX 64 ///< Nombre maximal de fils d'exécution d'une recherche parallèle
+
+#define PARALLELE_RACINE 0 ///< Recherche parallèle par répartition des coups de la racine entre les fils (par défaut)
+#define PARALLELE_LAZY_SMP 1 ///< Recherche parallèle "Lazy SMP": chaque fil cherche toute la racine, et ils ne communiquent que par la table de transposition
+
+/*!
+ *	\brief	Budget et état d'une recherche AlphaBeta
+ *	\author	Julien Laurent
+ *
+ *	Les recherches par approfondissement itératif (#ia_losanges()) s'arrêtent dès que l'une des
+ *	limites est atteinte: la recherche en cours est alors interrompue, et son résultat ignoré.
+ */
+struct etat_recherche
+{
+	unsigned int debut; ///< Instant de début de la recherche (en ms, voir SDL_GetTicks())
+	unsigned int duree_max; ///< Temps de réflexion accordé (en ms, 0 si illimité)
+	volatile unsigned long noeuds; ///< Nombre de nœuds cherchés depuis le début de la recherche (par l'ensemble des fils)
+	unsigned long noeuds_max; ///< Nombre maximal de nœuds à chercher (0 si illimité)
+	int horizon_max; ///< Horizon maximal des itérations (négatif si illimité)
+	volatile bool interrompue; ///< Vrai dès que le budget est épuisé
+	int valeur; ///< Valeur (pour l'IA) de la racine à la dernière itération complète
+};
+typedef struct etat_recherche etat_recherche; ///< Raccourci d'utilisation du type #etat_recherche
+
+/*!
+ *	\brief	Contexte propre à un fil d'exécution de la recherche AlphaBeta
+ *	\author	Julien Laurent
+ *
+ *	Regroupe tout ce que les fonctions de l'AlphaBeta modifient en dehors du plateau et des tables
+ *	partagées: chaque fil de recherche ayant son propre contexte (et sa propre copie du plateau),
+ *	plusieurs recherches peuvent se dérouler simultanément.
+ */
+struct contexte_recherche
+{
+	int tueurs[DIM_MAX*DIM_MAX][2]; ///< Deux derniers coups ayant provoqué une coupure, pour chaque nombre de coups joués
+	unsigned int historique[2][BITS_BITBOARD]; ///< Score d'historique de chaque case, pour chaque couleur
+	unsigned long noeuds; ///< Nœuds cherchés par ce fil et pas encore reportés dans l'#etat_recherche
+	base_connexions *connexions[2]; ///< Connexions virtuelles de chaque couleur dans la position courante du fil (allouées à la première utilisation)
+};
+typedef struct contexte_recherche contexte_recherche; ///< Raccourci d'utilisation du type #contexte_recherche
+
+
+/* * * * * * * * * * * * * * * */
+/* Budget des recherches:      */
+/* * * * * * * * * * * * * * * */
+unsigned int duree_reflexion(int level); ///< Renvoie le temps de réflexion (en ms) accordé à une IA du niveau passé en paramètre
+void fixe_budget_recherche(unsigned int duree_max, unsigned long noeuds_max, int horizon_max); ///< Impose un budget à toutes les recherches suivantes (tests et bancs d'essai), ou rétablit le budget par niveau avec (0, 0, -1)
+unsigned long noeuds_recherche(void); ///< Renvoie le nombre de nœuds cherchés lors de la dernière recherche
+int valeur_recherche(void); ///< Renvoie la valeur de la racine (pour l'IA) à la dernière itération complète de la dernière recherche
+void active_ordonnancement(bool actif); ///< Active (par défaut) ou désactive l'ordonnancement des coups de l'AlphaBeta
+void active_connexions(bool actif); ///< Active (par défaut) ou désactive l'utilisation des connexions virtuelles par l'AlphaBeta
+void active_inferieures(bool actif); ///< Active (par défaut) ou désactive l'élagage des cases inférieures par l'AlphaBeta
+void fixe_nombre_fils(int nb_fils); ///< Fixe le nombre de fils d'exécution des recherches (0: autant que de processeurs)
+int compte_fils(void); ///< Renvoie le nombre de fils d'exécution à utiliser pour une recherche (voir #fixe_nombre_fils())
+void fixe_mode_parallele(int mode); ///< Choisit le mode de recherche parallèle (#PARALLELE_RACINE ou #PARALLELE_LAZY_SMP)
+void fixe_graine_recherche(unsigned int graine); ///< Rend les recherches reproductibles (graine non nulle), ou rétablit le fonctionnement normal (graine nulle)
+
 
 /* * * * * * * * * */
 /* Capsules d'IA:  */
 /* * * * * * * * * */
 coord ia_hasard(plateau p, char pion, int level); ///< Renvoie des coordonnées aléatoires (mais jouables) à jouer. Cette IA est particulièrement idiote, idéale pour les joueurs dépressifs.
-coord ia_losanges(plateau p, char pion, int level); ///< Analyse le plateau passé en paramètre avec l'horizon \a level et la fonction #eval_losanges(), et renvoie des coordonnées (valides) à jouer
-coord ia_electrique(plateau p, char pion, int level); ///< Analyse le plateau passé en paramètre avec l'horizon \a level et la fonction #eval_resistance(), et renvoie des coordonnées (valides) à jouer
+coord ia_losanges(plateau p, char pion, int level); ///< Analyse le plateau passé en paramètre par approfondissement itératif pendant le temps accordé au niveau \a level, avec la fonction #eval_losanges(), et renvoie des coordonnées (valides) à jouer
+coord ia_electrique(plateau p, char pion, int level); ///< Analyse le plateau passé en paramètre par approfondissement itératif pendant le temps accordé au niveau \a level, avec la fonction #eval_resistance(), et renvoie des coordonnées (valides) à jouer
+coord ia_deux_distances(plateau p, char pion, int level); ///< Analyse le plateau passé en paramètre par approfondissement itératif pendant le temps accordé au niveau \a level, avec la fonction #eval_deux_distances(), et renvoie des coordonnées (valides) à jouer
 
 
 /* * * * * * * * * * * */
@@ -31,8 +105,8 @@ int maximisation(plateau *p, int x, int y, int iterations, char pion, int (*eval
 /* * * * * * * * * * * * */
 /* Algorithme AlphaBeta: */
 /* * * * * * * * * * * * */
-int alphaBetaMax(plateau *p, int x, int y, int alpha, int beta, int iterations, char pion, int (*eval) (plateau *, char)); ///< Fonction de maximisation de l'algorithme AlphaBeta
-int alphaBetaMin(plateau *p, int x, int y, int alpha, int beta, int iterations, char pion, int (*eval) (plateau *, char)); ///< Fonction de minimisation de l'algorithme AlphaBeta
+int alphaBetaMax(plateau *p, int x, int y, int alpha, int beta, int iterations, char pion, int (*eval) (plateau *, char), contexte_recherche *ctx); ///< Fonction de maximisation de l'algorithme AlphaBeta
+int alphaBetaMin(plateau *p, int x, int y, int alpha, int beta, int iterations, char pion, int (*eval) (plateau *, char), contexte_recherche *ctx); ///< Fonction de minimisation de l'algorithme AlphaBeta
 
 
 #endif // AI_H_INCLUDED
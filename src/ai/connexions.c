@@ -0,0 +1,672 @@
+/*!
+ *	\file	connexions.c
+ *	\brief	Moteur de connexions virtuelles ("H-search")
+ *	\author	Julien Laurent
+ *
+ *	Ce fichier contient le calcul des connexions virtuelles d'une couleur (voir connexions.h), et
+ *	leur mise à jour incrémentale coup par coup.
+ */
+
+#include "connexions.h"
+
+/*!
+ *	\author	Julien Laurent
+ *	\return	Pointeur sur une base de connexions vide
+ */
+base_connexions* nouvelle_base_connexions(void)
+{
+	base_connexions *base = malloc(sizeof(base_connexions));
+
+	if(base == NULL)
+	{
+		fprintf(stderr, "Memoire insuffisante pour les connexions virtuelles\n");
+		exit(EXIT_FAILURE);
+	}
+
+	base->valide = false;
+	base->nb_etapes = 0;
+	return base;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	base Base de connexions
+ *	\param	i Indice de la connexion à insérer en tête de la liste de sa paire
+ */
+static void lie_connexion(base_connexions *base, int i)
+{
+	connexion *c = &base->connexions[i];
+
+	c->suivante = base->paires[c->extremites[0]][c->extremites[1]];
+	base->paires[c->extremites[0]][c->extremites[1]] = i;
+
+	if(c->cle == AUCUNE_CLE)
+	{
+		bb_place(&base->relies[c->extremites[0]], c->extremites[1]);
+		bb_place(&base->relies[c->extremites[1]], c->extremites[0]);
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	base Base de connexions
+ *	\param	i Indice de la connexion à retirer de la liste de sa paire
+ */
+static void delie_connexion(base_connexions *base, int i)
+{
+	connexion *c = &base->connexions[i];
+	short *lien = &base->paires[c->extremites[0]][c->extremites[1]];
+
+	while(*lien != i)
+	{
+		lien = &base->connexions[*lien].suivante;
+	}
+	*lien = c->suivante;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	base Base de connexions
+ *	\param	i Indice de la connexion à modifier
+ *	\param	nouvelle Nouvel état de la connexion (actif ou retiré, extrémités éventuellement changées)
+ *	\return	Faux si le journal est plein (la base est alors invalidée)
+ *
+ *	L'état précédent de la connexion est conservé dans le journal, si un coup est en cours.
+ */
+static bool modifie_connexion(base_connexions *base, int i, const connexion *nouvelle)
+{
+	operation_connexions *op;
+
+	if(base->nb_etapes > 0)
+	{
+		if(base->taille_journal >= JOURNAL_MAX_CONNEXIONS)
+		{
+			base->valide = false;
+			return false;
+		}
+		op = &base->journal[base->taille_journal++];
+		op->ancienne = base->connexions[i];
+		op->indice = i;
+		op->ajout = false;
+	}
+
+	if(base->connexions[i].etat == CONNEXION_ACTIVE)
+	{
+		delie_connexion(base, i);
+	}
+	base->connexions[i] = *nouvelle;
+	if(nouvelle->etat == CONNEXION_ACTIVE)
+	{
+		lie_connexion(base, i);
+	}
+
+	return true;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	base Base de connexions
+ *	\param	a Premier nœud
+ *	\param	b Second nœud
+ *	\param	porteuse Cases vides nécessaires à la connexion
+ *	\param	cle Case à jouer pour une semi-connexion (#AUCUNE_CLE pour une connexion pleine)
+ *
+ *	La connexion n'est pas ajoutée si elle est dominée par une connexion existante de la même
+ *	paire (connexion pleine, ou semi-connexion pour une semi-connexion, de porteuse incluse dans la
+ *	sienne), ou si la paire a déjà son compte de connexions de cette nature. Une connexion ajoutée
+ *	est combinée aux autres lorsque #ferme_connexions() la rencontre.
+ */
+static void ajoute_connexion(base_connexions *base, int a, int b, bitboard porteuse, int cle)
+{
+	int i, nombre = 0;
+	connexion *c;
+	operation_connexions *op;
+
+	if(a == b || base->nb_connexions >= CONNEXIONS_MAX || (base->nb_etapes > 0 && base->taille_journal >= JOURNAL_MAX_CONNEXIONS))
+	{
+		return;
+	}
+	if(a > b)
+	{
+		i = a; a = b; b = i;
+	}
+
+	for ( i = base->paires[a][b] ; i >= 0 ; i = c->suivante )
+	{
+		c = &base->connexions[i];
+		if((c->cle == AUCUNE_CLE || cle != AUCUNE_CLE) && bb_est_nul(bb_sauf(c->porteuse, porteuse)))
+		{
+			return; // Connexion dominée
+		}
+		if((c->cle == AUCUNE_CLE) == (cle == AUCUNE_CLE))
+		{
+			nombre++;
+		}
+	}
+	if(nombre >= ((cle == AUCUNE_CLE) ? PLEINES_MAX_PAIRE : SEMI_MAX_PAIRE))
+	{
+		return;
+	}
+
+	i = base->nb_connexions++;
+	c = &base->connexions[i];
+	c->porteuse = porteuse;
+	c->extremites[0] = a;
+	c->extremites[1] = b;
+	c->cle = cle;
+	c->etat = CONNEXION_ACTIVE;
+	c->modifiee = false;
+	lie_connexion(base, i);
+
+	if(base->nb_etapes > 0)
+	{
+		op = &base->journal[base->taille_journal++];
+		op->indice = i;
+		op->ajout = true;
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	base Base de connexions
+ *	\param	a Premier nœud
+ *	\param	b Second nœud
+ *	\param	intersection Intersection des porteuses des semi-connexions déjà combinées
+ *	\param	reunion Réunion de ces porteuses
+ *	\param	depuis Indice de la première semi-connexion de la paire pouvant encore être combinée
+ *	\param	exclue Semi-connexion de départ de la combinaison (déjà comprise)
+ *	\param	restreinte Vrai pour n'ajouter que des semi-connexions modifiées par le coup en cours
+ *	\param	profondeur Nombre de semi-connexions pouvant encore être ajoutées à la combinaison
+ *
+ *	Règle "OU": des semi-connexions entre les deux mêmes nœuds, dont les porteuses n'ont aucune case
+ *	commune, forment une connexion pleine (quel que soit le coup adverse, l'une d'elles au moins
+ *	reste intacte, et peut être établie en réponse).
+ */
+static void combine_semi_connexions(base_connexions *base, int a, int b, bitboard intersection, bitboard reunion, int depuis, int exclue, bool restreinte, int profondeur)
+{
+	int i;
+	const connexion *c;
+	bitboard reste;
+
+	for ( i = depuis ; i >= 0 ; i = c->suivante )
+	{
+		c = &base->connexions[i];
+		if(c->cle == AUCUNE_CLE || i == exclue || (restreinte && !c->modifiee))
+		{
+			continue;
+		}
+
+		reste = bb_et(intersection, c->porteuse);
+		if(bb_est_nul(reste))
+		{
+			ajoute_connexion(base, a, b, bb_ou(reunion, c->porteuse), AUCUNE_CLE);
+		}
+		else if(profondeur > 1 && !bb_egal(reste, intersection))
+		{
+			combine_semi_connexions(base, a, b, reste, bb_ou(reunion, c->porteuse), c->suivante, exclue, restreinte, profondeur-1);
+		}
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	base Base de connexions
+ *	\param	i Indice de la connexion à combiner avec les connexions existantes
+ *	\param	restreinte Vrai pour ne la combiner qu'aux connexions modifiées par le coup en cours
+ *	\param	libre Nœud par lequel la combinaison reste libre malgré \a restreinte (-1 si aucun)
+ *
+ *	Règle "ET": deux connexions pleines u-z et z-w, de porteuses disjointes (et ne contenant ni u ni
+ *	w), forment une connexion pleine u-w si z est un groupe de pions, et une semi-connexion de clé
+ *	z si z est une case vide. Les frontières ne servent jamais d'intermédiaire.
+ *	Une semi-connexion est combinée par la règle "OU" aux autres semi-connexions de sa paire
+ *	(à toutes si \a libre est un nœud, sa paire ayant alors changé).
+ */
+static void combine_connexion(base_connexions *base, int i, bool restreinte, int libre)
+{
+	const connexion e = base->connexions[i]; // (Copie: la réserve grandit pendant les combinaisons)
+	const connexion *c;
+	int m, z, u, w, j;
+	bitboard voisins;
+	bool vide, modifiees;
+
+	if(e.etat != CONNEXION_ACTIVE)
+	{
+		return;
+	}
+
+	if(e.cle != AUCUNE_CLE)
+	{
+		combine_semi_connexions(base, e.extremites[0], e.extremites[1], e.porteuse, e.porteuse,
+								base->paires[e.extremites[0]][e.extremites[1]], i, restreinte && libre < 0, PROFONDEUR_OU);
+		return;
+	}
+
+	for ( m = 0 ; m < 2 ; m++ )
+	{
+		z = e.extremites[m];
+		u = e.extremites[1-m];
+		if(z == FRONTIERE_DEPART || z == FRONTIERE_ARRIVEE)
+		{
+			continue;
+		}
+
+		vide = bb_teste(&base->vides, z);
+		modifiees = restreinte && z != libre;
+		voisins = base->relies[z];
+		while((w = bb_extrait(&voisins)) >= 0)
+		{
+			if(w == u || bb_teste(&e.porteuse, w))
+			{
+				continue;
+			}
+
+			for ( j = base->paires[(z < w) ? z : w][(z < w) ? w : z] ; j >= 0 ; j = c->suivante )
+			{
+				c = &base->connexions[j];
+				if(c->cle == AUCUNE_CLE && j != i && (c->modifiee || !modifiees) && !bb_teste(&c->porteuse, u) && bb_est_nul(bb_et(c->porteuse, e.porteuse)))
+				{
+					if(vide)
+					{
+						bitboard porteuse = bb_ou(e.porteuse, c->porteuse);
+						bb_place(&porteuse, z);
+						ajoute_connexion(base, u, w, porteuse, z);
+					}
+					else
+					{
+						ajoute_connexion(base, u, w, bb_ou(e.porteuse, c->porteuse), AUCUNE_CLE);
+					}
+				}
+			}
+		}
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	base Base de connexions
+ *	\param	premiere Indice de la première connexion nouvelle de la réserve
+ *
+ *	Applique les règles "ET" et "OU" jusqu'à ce qu'aucune connexion ne puisse plus être ajoutée.
+ *	Chaque connexion nouvelle est combinée une fois à toutes celles qui existent alors: les
+ *	connexions ajoutées ensuite la retrouveront quand viendra leur tour.
+ */
+static void ferme_connexions(base_connexions *base, int premiere)
+{
+	int i;
+
+	for ( i = premiere ; i < base->nb_connexions ; i++ )
+	{
+		combine_connexion(base, i, false, -1);
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	base Base à remplir
+ *	\param	p Plateau à analyser
+ *	\param	couleur Indice de la couleur (0: noir, 1: blanc)
+ *
+ *	Les groupes de pions de la couleur sont numérotés, puis chaque case vide est reliée par une
+ *	connexion pleine (de porteuse vide) à ses voisins: cases vides, groupes et frontières.
+ *	Ces connexions sont ensuite combinées par #ferme_connexions().
+ */
+void calcule_connexions(base_connexions *base, const plateau *p, int couleur)
+{
+	int k, n, d, f, r;
+	bitboard reste, groupe;
+
+	memset(base->paires, 0xFF, sizeof(base->paires));
+	memset(base->relies, 0, sizeof(base->relies));
+	base->nb_connexions = 0;
+	base->taille_journal = 0;
+	base->nb_etapes = 0;
+	base->couleur = couleur;
+	base->topo = p->topo;
+	base->bords[0] = p->bords[2*couleur];
+	base->bords[1] = p->bords[2*couleur+1];
+	base->vides = cases_vides(p);
+	base->pions = p->pions[couleur];
+	base->noeuds = base->vides;
+	base->valide = true;
+	base->gagnee = false;
+	bb_place(&base->noeuds, FRONTIERE_DEPART);
+	bb_place(&base->noeuds, FRONTIERE_ARRIVEE);
+
+	reste = base->pions; // Représentant de chaque groupe: sa frontière, ou sa première case
+	while((k = bb_extrait(&reste)) >= 0)
+	{
+		groupe = composante(p, k, couleur);
+		reste = bb_sauf(reste, groupe);
+		r = k;
+		for ( f = 1 ; f >= 0 ; f-- )
+		{
+			if(!bb_est_nul(bb_et(groupe, base->bords[f])))
+			{
+				base->gagnee |= (r == 1-f);
+				r = f;
+			}
+		}
+		bb_place(&base->noeuds, r);
+		while((n = bb_extrait(&groupe)) >= 0)
+		{
+			base->representant[n] = r;
+		}
+	}
+
+	reste = base->vides; // Connexions élémentaires
+	while((k = bb_extrait(&reste)) >= 0)
+	{
+		for ( d = 0 ; d < 6 ; d++ )
+		{
+			n = p->topo->voisins[k][d];
+			if(bb_teste(&base->vides, n) && n > k)
+			{
+				ajoute_connexion(base, k, n, bb_nul(), AUCUNE_CLE);
+			}
+			else if(bb_teste(&base->pions, n))
+			{
+				ajoute_connexion(base, k, base->representant[n], bb_nul(), AUCUNE_CLE);
+			}
+		}
+		for ( f = 0 ; f < 2 ; f++ )
+		{
+			if(bb_teste(&base->bords[f], k))
+			{
+				ajoute_connexion(base, k, f, bb_nul(), AUCUNE_CLE);
+			}
+		}
+	}
+
+	ferme_connexions(base, 0);
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	base Base de connexions
+ *	\param	m Case jouée par l'adversaire
+ *
+ *	La case cesse d'être un nœud, et toutes les connexions qui passent par elle sont retirées: les
+ *	autres restent valables telles quelles.
+ */
+static void coup_adverse(base_connexions *base, int m)
+{
+	int i;
+	connexion c;
+
+	bb_retire(&base->vides, m);
+	bb_retire(&base->noeuds, m);
+
+	for ( i = 0 ; i < base->nb_connexions ; i++ )
+	{
+		c = base->connexions[i];
+		if(c.etat == CONNEXION_ACTIVE && (c.extremites[0] == m || c.extremites[1] == m || bb_teste(&c.porteuse, m)))
+		{
+			c.etat = CONNEXION_RETIREE;
+			if(!modifie_connexion(base, i, &c))
+			{
+				return;
+			}
+		}
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	base Base de connexions
+ *	\param	m Case jouée par la couleur de la base
+ *	\param	fermeture Vrai pour combiner les connexions modifiées (faux pour une mise à jour rapide)
+ *
+ *	La case rejoint les groupes voisins (et les frontières touchées) en un seul nœud, vers lequel
+ *	les connexions de ces groupes sont redirigées. La case est retirée des porteuses, et chaque
+ *	semi-connexion de clé \a m devient une connexion pleine. Toutes les connexions ainsi modifiées
+ *	sont de nouveau combinées, avec les nouvelles qu'elles engendrent, mais seules les connexions
+ *	devenues pleines le sont à toutes les autres: une connexion dont la porteuse a perdu \a m n'a
+ *	de nouveau partenaire possible que parmi les connexions qui contenaient aussi \a m (la seule
+ *	case qui pouvait les empêcher de se combiner), et une connexion redirigée vers le nouveau
+ *	groupe n'en trouve d'autres qu'à travers lui. Ces restrictions évitent l'essentiel du travail.
+ */
+static void coup_ami(base_connexions *base, int m, bool fermeture)
+{
+	const short *voisins = base->topo->voisins[m];
+	static __thread short modifiees[CONNEXIONS_MAX], libres[CONNEXIONS_MAX]; // (Trop grands pour la pile de certains fils)
+	int i, d, n, a, b, r, premiere = base->nb_connexions, nb_modifiees = 0;
+	bitboard fusionnes = bb_nul(), reste; // Nœuds absorbés par le nouveau groupe
+	connexion c;
+
+	for ( d = 0 ; d < 6 ; d++ )
+	{
+		if(bb_teste(&base->pions, voisins[d]))
+		{
+			bb_place(&fusionnes, base->representant[voisins[d]]);
+		}
+	}
+	for ( d = 0 ; d < 2 ; d++ )
+	{
+		if(bb_teste(&base->bords[d], m))
+		{
+			bb_place(&fusionnes, d);
+		}
+	}
+	if(bb_teste(&fusionnes, FRONTIERE_DEPART) && bb_teste(&fusionnes, FRONTIERE_ARRIVEE))
+	{
+		base->gagnee = true;
+		return;
+	}
+	bb_place(&fusionnes, m);
+	reste = fusionnes;
+	r = bb_extrait(&reste); // (Une frontière en priorité, ses indices étant les plus petits)
+	bb_retire(&fusionnes, r);
+
+	bb_retire(&base->vides, m);
+	bb_place(&base->pions, m);
+	base->noeuds = bb_sauf(base->noeuds, fusionnes);
+	bb_place(&base->noeuds, r);
+	base->representant[m] = r;
+	for ( n = 0 ; n < BITS_BITBOARD ; n++ )
+	{
+		if(bb_teste(&base->pions, n) && bb_teste(&fusionnes, base->representant[n]))
+		{
+			base->representant[n] = r;
+		}
+	}
+
+	for ( i = 0 ; i < premiere ; i++ )
+	{
+		c = base->connexions[i];
+		if(c.etat != CONNEXION_ACTIVE)
+		{
+			continue;
+		}
+
+		a = bb_teste(&fusionnes, c.extremites[0]) ? r : c.extremites[0];
+		b = bb_teste(&fusionnes, c.extremites[1]) ? r : c.extremites[1];
+		if(a == c.extremites[0] && b == c.extremites[1] && c.cle != m && !bb_teste(&c.porteuse, m))
+		{
+			continue; // Connexion inchangée
+		}
+
+		if(a == b) // Connexion intérieure au nouveau groupe
+		{
+			c.etat = CONNEXION_RETIREE;
+		}
+		else
+		{
+			if(c.cle == m)
+			{
+				libres[nb_modifiees] = -2; // (Connexion devenue pleine: combinaison sans restriction)
+			}
+			else
+			{
+				libres[nb_modifiees] = (a == c.extremites[0] && b == c.extremites[1]) ? -1 : r;
+			}
+			modifiees[nb_modifiees++] = i;
+			c.extremites[0] = (a < b) ? a : b;
+			c.extremites[1] = (a < b) ? b : a;
+			c.modifiee = bb_teste(&c.porteuse, m);
+			bb_retire(&c.porteuse, m);
+			if(c.cle == m)
+			{
+				c.cle = AUCUNE_CLE;
+			}
+		}
+
+		if(!modifie_connexion(base, i, &c))
+		{
+			return;
+		}
+	}
+
+	for ( i = 0 ; fermeture && i < nb_modifiees ; i++ )
+	{
+		combine_connexion(base, modifiees[i], libres[i] != -2, libres[i]);
+	}
+	if(fermeture)
+	{
+		ferme_connexions(base, premiere);
+	}
+
+	for ( i = 0 ; i < nb_modifiees ; i++ ) // (Pas besoin de journal: les états précédents y sont déjà)
+	{
+		base->connexions[modifiees[i]].modifiee = false;
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	base Base de connexions, calculée par #calcule_connexions()
+ *	\param	k Indice de la case jouée
+ *	\param	couleur_coup Indice de la couleur du coup (0: noir, 1: blanc)
+ *	\param	fermeture Vrai pour combiner les connexions modifiées par un coup de la couleur de la base
+ *
+ *	Le coup adverse ne fait que retirer des connexions. Le coup de la couleur de la base en modifie
+ *	certaines, et peut en créer: la base obtenue n'est pas toujours celle que donnerait un calcul
+ *	complet (les limites par paire de nœuds ne retiennent pas forcément les mêmes connexions), mais
+ *	toutes ses connexions sont valables. Sans \a fermeture, la mise à jour se contente de rediriger
+ *	les connexions et de retirer la case des porteuses: elle coûte bien moins cher (la combinaison
+ *	des connexions nouvelles en représente l'essentiel), mais ne découvre aucune connexion.
+ */
+void joue_connexions(base_connexions *base, int k, int couleur_coup, bool fermeture)
+{
+	etape_connexions *etape = &base->etapes[base->nb_etapes++];
+
+	etape->vides = base->vides;
+	etape->pions = base->pions;
+	etape->noeuds = base->noeuds;
+	memcpy(etape->representant, base->representant, sizeof(base->representant));
+	etape->taille_journal = base->taille_journal;
+	etape->valide = base->valide;
+	etape->gagnee = base->gagnee;
+
+	if(!base->valide || base->gagnee)
+	{
+		return;
+	}
+
+	if(couleur_coup == base->couleur)
+	{
+		coup_ami(base, k, fermeture);
+	}
+	else
+	{
+		coup_adverse(base, k);
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	base Base de connexions
+ *
+ *	Les opérations du journal sont annulées dans l'ordre inverse.
+ */
+void dejoue_connexions(base_connexions *base)
+{
+	etape_connexions *etape = &base->etapes[--base->nb_etapes];
+	operation_connexions *op;
+
+	while(base->taille_journal > etape->taille_journal)
+	{
+		op = &base->journal[--base->taille_journal];
+		if(base->connexions[op->indice].etat == CONNEXION_ACTIVE)
+		{
+			delie_connexion(base, op->indice);
+		}
+
+		if(op->ajout)
+		{
+			base->nb_connexions--;
+		}
+		else
+		{
+			base->connexions[op->indice] = op->ancienne;
+			if(op->ancienne.etat == CONNEXION_ACTIVE)
+			{
+				lie_connexion(base, op->indice);
+			}
+		}
+	}
+
+	base->vides = etape->vides;
+	base->pions = etape->pions;
+	base->noeuds = etape->noeuds;
+	memcpy(base->representant, etape->representant, sizeof(base->representant));
+	base->valide = etape->valide;
+	base->gagnee = etape->gagnee;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	base Base de connexions
+ *	\return	Vrai si la couleur est assurée de relier ses frontières, même sans avoir le trait
+ */
+bool connexion_frontieres(const base_connexions *base)
+{
+	int i;
+
+	if(!base->valide)
+	{
+		return false;
+	}
+	if(base->gagnee)
+	{
+		return true;
+	}
+
+	for ( i = base->paires[FRONTIERE_DEPART][FRONTIERE_ARRIVEE] ; i >= 0 ; i = base->connexions[i].suivante )
+	{
+		if(base->connexions[i].cle == AUCUNE_CLE)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	base Base de connexions
+ *	\param	zone Intersection des porteuses des semi-connexions trouvées (à remplir)
+ *	\return	Vrai si la couleur relie ses frontières en ayant le trait
+ *
+ *	L'adversaire, s'il a le trait, doit alors jouer dans \a zone: tout autre coup laisse intacte
+ *	l'une des semi-connexions, que la couleur n'a plus qu'à établir. Si \a zone est vide, il a perdu.
+ */
+bool semi_connexion_frontieres(const base_connexions *base, bitboard *zone)
+{
+	int i;
+	bool trouvee = false;
+
+	*zone = base->vides;
+	if(!base->valide)
+	{
+		return false;
+	}
+
+	for ( i = base->paires[FRONTIERE_DEPART][FRONTIERE_ARRIVEE] ; i >= 0 ; i = base->connexions[i].suivante )
+	{
+		*zone = bb_et(*zone, base->connexions[i].porteuse);
+		trouvee = true;
+	}
+
+	return trouvee;
+}
@@ -0,0 +1,138 @@
+/*!
+ *	\file	connexions.h
+ *	\brief	Prototypes du moteur de connexions virtuelles ("H-search")
+ *	\author	Julien Laurent
+ *
+ *	Ce fichier contient les déclarations du calcul des connexions virtuelles d'une couleur: deux
+ *	nœuds (cases vides, groupes de pions ou frontières) sont reliés par une connexion pleine si la
+ *	couleur peut les relier même en jouant en second, et par une semi-connexion si elle le peut en
+ *	jouant en premier (sur la case "clé"). Chaque connexion a une porteuse: l'ensemble des cases
+ *	vides dont elle a besoin. Les \a bridges, et les gabarits de bord (ziggourat, etc.), sont
+ *	retrouvés par combinaison des connexions élémentaires, selon les règles "ET" et "OU" de
+ *	l'algorithme H-search (Anshelevich).
+ *	Une connexion pleine entre les deux frontières d'une couleur lui assure la victoire; une
+ *	semi-connexion la lui assure si elle a le trait, et oblige sinon l'adversaire à jouer dans
+ *	l'intersection des porteuses (la "zone obligatoire"). La recherche AlphaBeta s'en sert pour
+ *	conclure des branches bien avant la fin de la partie.
+ *	Les connexions sont tenues à jour coup par coup (#joue_connexions()), et chaque mise à jour
+ *	est annulable (#dejoue_connexions()), comme #joue_coup() et #dejoue_coup().
+ */
+
+#ifndef CONNEXIONS_H_INCLUDED
+#define CONNEXIONS_H_INCLUDED
+
+#include "../model/data_models.h"
+
+#define CONNEXIONS_MAX 32768 ///< Nombre maximal de connexions d'une base (au-delà, les nouvelles connexions sont ignorées)
+#define JOURNAL_MAX_CONNEXIONS 32768 ///< Nombre maximal d'opérations annulables d'une base (au-delà, la base est invalidée jusqu'à l'annulation du coup)
+#define PLEINES_MAX_PAIRE 4 ///< Nombre maximal de connexions pleines conservées entre deux mêmes nœuds
+#define SEMI_MAX_PAIRE 8 ///< Nombre maximal de semi-connexions conservées entre deux mêmes nœuds
+#define PROFONDEUR_OU 4 ///< Nombre maximal de semi-connexions combinées par la règle "OU"
+
+#define FRONTIERE_DEPART 0 ///< Nœud de la première frontière de la couleur (bit de garde, jamais une case)
+#define FRONTIERE_ARRIVEE 1 ///< Nœud de la seconde frontière de la couleur (bit de garde, jamais une case)
+#define AUCUNE_CLE 0 ///< Clé d'une connexion pleine
+
+#define CONNEXION_ACTIVE 0 ///< Connexion valable dans la position courante
+#define CONNEXION_RETIREE 1 ///< Connexion détruite par un coup (conservée pour pouvoir être rétablie)
+
+/*!
+ *	\brief	Connexion virtuelle entre deux nœuds
+ *	\author	Julien Laurent
+ *
+ *	Les connexions d'une même paire de nœuds forment une liste chaînée (par leurs indices dans la
+ *	réserve de la base), dont la tête est rangée dans la table des paires.
+ */
+struct connexion
+{
+	bitboard porteuse; ///< Cases vides nécessaires à la connexion (clé comprise pour une semi-connexion)
+	short suivante; ///< Indice de la connexion suivante de la même paire (-1: fin de liste)
+	unsigned char extremites[2]; ///< Nœuds reliés (le plus petit en premier): frontière, représentant d'un groupe ou case vide
+	unsigned char cle; ///< Case à jouer pour établir une semi-connexion (#AUCUNE_CLE pour une connexion pleine)
+	unsigned char etat; ///< #CONNEXION_ACTIVE ou #CONNEXION_RETIREE
+	bool modifiee; ///< Vrai pendant la mise à jour qui a réduit la porteuse (voir #joue_connexions())
+};
+typedef struct connexion connexion; ///< Raccourci d'utilisation du type #connexion
+
+/*!
+ *	\brief	Opération annulable sur une base de connexions
+ *	\author	Julien Laurent
+ *
+ *	Une connexion ajoutée est simplement dépilée à l'annulation; une connexion modifiée (ou
+ *	retirée) retrouve son état précédent, conservé dans l'opération.
+ */
+struct operation_connexions
+{
+	connexion ancienne; ///< Connexion avant la modification (inutilisée pour un ajout)
+	short indice; ///< Indice de la connexion concernée
+	bool ajout; ///< Vrai si la connexion a été ajoutée
+};
+typedef struct operation_connexions operation_connexions; ///< Raccourci d'utilisation du type #operation_connexions
+
+/*!
+ *	\brief	État d'une base de connexions avant un coup
+ *	\author	Julien Laurent
+ */
+struct etape_connexions
+{
+	bitboard vides; ///< Cases vides
+	bitboard pions; ///< Pions de la couleur
+	bitboard noeuds; ///< Nœuds de la base
+	unsigned char representant[BITS_BITBOARD]; ///< Représentant du groupe de chaque pion de la couleur
+	int taille_journal; ///< Nombre d'opérations du journal
+	bool valide; ///< Validité de la base
+	bool gagnee; ///< Frontières reliées par des pions
+};
+typedef struct etape_connexions etape_connexions; ///< Raccourci d'utilisation du type #etape_connexions
+
+/*!
+ *	\brief	Connexions virtuelles d'une couleur
+ *	\author	Julien Laurent
+ *
+ *	Les nœuds sont désignés par des indices de #bitboard: une case vide par le sien, un groupe de
+ *	pions par celui de son représentant, et les frontières par #FRONTIERE_DEPART et
+ *	#FRONTIERE_ARRIVEE (un groupe touchant une frontière se confond avec elle).
+ *	Une base occupe quelques Mo: elle est allouée par #nouvelle_base_connexions().
+ */
+struct base_connexions
+{
+	short paires[BITS_BITBOARD][BITS_BITBOARD]; ///< Tête de la liste des connexions de chaque paire de nœuds (le plus petit en premier; -1 si aucune)
+	bitboard relies[BITS_BITBOARD]; ///< Nœuds avec lesquels chaque nœud a (ou a eu) une connexion pleine
+	connexion connexions[CONNEXIONS_MAX]; ///< Réserve des connexions (les ajouts sont empilés)
+	int nb_connexions; ///< Nombre de connexions de la réserve (actives ou retirées)
+	operation_connexions journal[JOURNAL_MAX_CONNEXIONS]; ///< Opérations annulables, dans l'ordre
+	int taille_journal; ///< Nombre d'opérations du journal
+	etape_connexions etapes[DIM_MAX*DIM_MAX]; ///< État de la base avant chaque coup joué par #joue_connexions()
+	int nb_etapes; ///< Nombre de coups joués depuis le dernier calcul complet
+	int couleur; ///< Indice de la couleur (0: noir, 1: blanc)
+	const topologie *topo; ///< Topologie du plateau
+	bitboard bords[2]; ///< Frontières de la couleur
+	bitboard vides; ///< Cases vides
+	bitboard pions; ///< Pions de la couleur
+	bitboard noeuds; ///< Nœuds de la base (cases vides, représentants et frontières)
+	unsigned char representant[BITS_BITBOARD]; ///< Représentant du groupe de chaque pion de la couleur
+	bool valide; ///< Faux si une mise à jour n'a pas pu être menée à bien (les connexions sont alors ignorées)
+	bool gagnee; ///< Vrai si les frontières sont reliées par des pions
+};
+typedef struct base_connexions base_connexions; ///< Raccourci d'utilisation du type #base_connexions
+
+
+/// Alloue une base de connexions (vide), à remplir par #calcule_connexions()
+base_connexions* nouvelle_base_connexions(void);
+
+/// Calcule entièrement les connexions virtuelles de la couleur donnée (0: noir, 1: blanc) sur le plateau
+void calcule_connexions(base_connexions *base, const plateau *p, int couleur);
+
+/// Met à jour les connexions après que la couleur \a couleur_coup a joué la case d'indice \a k (en combinant les connexions modifiées si \a fermeture est vrai)
+void joue_connexions(base_connexions *base, int k, int couleur_coup, bool fermeture);
+
+/// Annule la dernière mise à jour faite par #joue_connexions()
+void dejoue_connexions(base_connexions *base);
+
+/// Renvoie vrai si les frontières de la couleur sont reliées par une connexion pleine (ou par des pions)
+bool connexion_frontieres(const base_connexions *base);
+
+/// Renvoie vrai si les frontières de la couleur sont reliées par une semi-connexion, et donne l'intersection de leurs porteuses
+bool semi_connexion_frontieres(const base_connexions *base, bitboard *zone);
+
+#endif // CONNEXIONS_H_INCLUDED
@@ -0,0 +1,430 @@
+/*!
+ *	\file	dfpn.c
+ *	\brief	Solveur par nombres de preuve ("DFPN")
+ *	\author	Julien Laurent
+ *
+ *	Ce fichier contient la recherche des preuves (voir dfpn.h), sa table de transposition, et l'IA
+ *	qui s'en sert. Les nombres sont exprimés du point de vue du joueur qui a le trait ("negamax"):
+ *	le nombre de preuve d'une position est le plus petit nombre de réfutation de ses fils, et son
+ *	nombre de réfutation la somme de leurs nombres de preuve.
+ */
+
+#include <SDL_timer.h>
+
+#include "dfpn.h"
+#include "resolues.h"
+#include "ouvertures.h"
+
+/*!
+ *	\brief	État d'une résolution
+ *	\author	Julien Laurent
+ */
+struct solveur_dfpn
+{
+	plateau p; ///< Copie de travail du plateau
+	base_connexions *connexions[2]; ///< Connexions virtuelles de chaque couleur dans la position courante
+	unsigned int debut; ///< Instant de début de la résolution (en ms, voir SDL_GetTicks())
+	unsigned int duree_max; ///< Temps accordé (en ms, 0 si illimité)
+	unsigned long noeuds; ///< Nombre de nœuds cherchés
+	unsigned long noeuds_max; ///< Nombre maximal de nœuds à chercher (0 si illimité)
+	bool interrompu; ///< Vrai dès que le budget est épuisé
+};
+typedef struct solveur_dfpn solveur_dfpn; ///< Raccourci d'utilisation du type #solveur_dfpn
+
+static entree_dfpn *table = NULL; ///< Table de transposition du solveur (allouée à la première résolution)
+static unsigned long capacite = 0; ///< Nombre d'entrées de la table (puissance de 2)
+static int dimension_table = 0; ///< Dimension des plateaux des positions de la table (0 si elle est vide)
+static base_connexions *bases[2] = {NULL, NULL}; ///< Bases de connexions du solveur (allouées à la première résolution)
+static unsigned int duree_imposee = 0; ///< Temps de réflexion imposé par #fixe_budget_dfpn() (0 si aucun)
+static unsigned long noeuds_imposes = 0; ///< Nombre de nœuds imposé par #fixe_budget_dfpn() (0 si aucun)
+static unsigned long nb_noeuds = 0; ///< Nombre de nœuds cherchés lors de la dernière résolution
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	duree_max Temps accordé à chaque résolution de l'IA (en ms, 0 pour revenir au temps du niveau)
+ *	\param	noeuds_max Nombre maximal de nœuds de chaque résolution de l'IA (0 si illimité)
+ *
+ *	Permet aux bancs d'essai d'imposer un budget identique à toutes les résolutions de #ia_solveur(),
+ *	quel que soit le niveau demandé.
+ */
+void fixe_budget_dfpn(unsigned int duree_max, unsigned long noeuds_max)
+{
+	duree_imposee = duree_max;
+	noeuds_imposes = noeuds_max;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\return	Nombre de nœuds cherchés lors de la dernière résolution
+ */
+unsigned long noeuds_dfpn(void)
+{
+	return nb_noeuds;
+}
+
+/*!
+ *	\author	Julien Laurent
+ */
+void vide_table_dfpn(void)
+{
+	if(table != NULL)
+	{
+		memset(table, 0, capacite * sizeof(entree_dfpn));
+	}
+	dimension_table = 0;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	dim Dimension du plateau à résoudre
+ *	\return	Vrai si la table et les bases de connexions sont prêtes, faux si elles n'ont pas pu être allouées
+ *
+ *	La table est allouée (vide) lors de la première résolution, puis conservée tant que la dimension
+ *	ne change pas: les clés de Zobrist ne dépendent que des indices des pions dans les #bitboard,
+ *	si bien que deux positions de dimensions différentes (à commencer par les plateaux vides, de clé
+ *	nulle) peuvent partager la même clé. La table est donc vidée à chaque changement de dimension.
+ */
+static bool prepare_solveur(int dim)
+{
+	int couleur;
+
+	if(table == NULL)
+	{
+		for ( capacite = 1 ; 2 * capacite * sizeof(entree_dfpn) <= ((unsigned long)TAILLE_TABLE_DFPN << 20) ; capacite *= 2 );
+		if((table = calloc(capacite, sizeof(entree_dfpn))) == NULL)
+		{
+			capacite = 0;
+			return false;
+		}
+	}
+	if(dimension_table != dim)
+	{
+		vide_table_dfpn();
+		dimension_table = dim;
+	}
+
+	for ( couleur = 0 ; couleur < 2 ; couleur++ )
+	{
+		if(bases[couleur] == NULL)
+		{
+			bases[couleur] = nouvelle_base_connexions();
+		}
+	}
+	return true;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	cle Clé de la position
+ *	\return	Pointeur sur l'entrée de la position dans la table, ou NULL si elle n'y est pas
+ *
+ *	Une position peut occuper l'une des deux entrées voisines désignées par sa clé.
+ */
+static entree_dfpn* cherche_entree(uint64_t cle)
+{
+	unsigned long i = cle & (capacite - 1);
+
+	if(table[i].travail != 0 && table[i].cle == cle)
+	{
+		return &table[i];
+	}
+	else if(table[i ^ 1].travail != 0 && table[i ^ 1].cle == cle)
+	{
+		return &table[i ^ 1];
+	}
+	return NULL;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	cle Clé de la position
+ *	\param	pn Nombre de preuve
+ *	\param	dn Nombre de réfutation
+ *	\param	travail Nombre de nœuds cherchés sous la position
+ *	\param	coup Coup gagnant, ou #AUCUN_COUP
+ *
+ *	Une position déjà présente est mise à jour; sinon, elle remplace celle des deux entrées qui a
+ *	demandé le moins de travail (les preuves les plus coûteuses sont ainsi conservées).
+ */
+static void stocke_entree(uint64_t cle, unsigned int pn, unsigned int dn, unsigned long travail, int coup)
+{
+	unsigned long i = cle & (capacite - 1);
+	entree_dfpn *entree = cherche_entree(cle);
+
+	if(entree == NULL)
+	{
+		entree = (table[i].travail <= table[i ^ 1].travail) ? &table[i] : &table[i ^ 1];
+	}
+
+	entree->cle = cle;
+	entree->pn = pn;
+	entree->dn = dn;
+	entree->travail = (travail >= 0xFFFFFFFF) ? 0xFFFFFFFF : (travail > 0) ? travail : 1;
+	entree->coup = coup;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	s État de la résolution
+ *	\return	Vrai si le budget de la résolution est épuisé
+ */
+static bool budget_dfpn_epuise(solveur_dfpn *s)
+{
+	if(!s->interrompu && s->noeuds % INTERVALLE_DFPN == 0)
+	{
+		if((s->noeuds_max > 0 && s->noeuds >= s->noeuds_max) || (s->duree_max > 0 && SDL_GetTicks() - s->debut >= s->duree_max))
+		{
+			s->interrompu = true;
+		}
+	}
+	return s->interrompu;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	s État de la résolution (plateau et connexions de la position)
+ *	\param	joueur Couleur du joueur qui a le trait
+ *	\param	seuil_pn Seuil du nombre de preuve
+ *	\param	seuil_dn Seuil du nombre de réfutation
+ *	\param	pn Pointeur sur le nombre de preuve de la position, à renseigner
+ *	\param	dn Pointeur sur le nombre de réfutation de la position, à renseigner
+ *	\param	racine Vrai pour la position à résoudre (qui doit donner un coup gagnant)
+ *
+ *	Cherche la position jusqu'à ce que l'un de ses nombres atteigne son seuil. Chaque itération
+ *	développe le fils de plus petit nombre de réfutation (le coup le plus facile à prouver), avec
+ *	pour seuils ceux qui, une fois atteints, feraient de lui un fils moins intéressant que le
+ *	second. Le seuil de réfutation du fils est relevé d'un quart ("1+epsilon", Pawlewicz et Lew),
+ *	ce qui évite de basculer sans cesse entre deux fils de nombres voisins.
+ *	Les connexions virtuelles et le remplissage des cases inférieures concluent directement la
+ *	position si possible (sauf la victoire de la racine, dont il faut trouver le coup), et limitent
+ *	sinon les coups à chercher.
+ */
+static void explore(solveur_dfpn *s, char joueur, unsigned int seuil_pn, unsigned int seuil_dn, unsigned int *pn, unsigned int *dn, bool racine)
+{
+	int couleur = indice_couleur(joueur), n = 0, i, k, meilleur = 0, gagnant_remplissage;
+	int coups[DIM_MAX*DIM_MAX];
+	unsigned int pn_fils[DIM_MAX*DIM_MAX], dn_fils[DIM_MAX*DIM_MAX];
+	unsigned int seuil_pn_fils, seuil_dn_fils, dn_second;
+	unsigned long debut = s->noeuds;
+	uint64_t cle = s->p.cle ^ (couleur ? CLE_TRAIT_DFPN : 0), cle_fils;
+	entree_dfpn *entree;
+	bitboard jouables, zone;
+
+	s->noeuds++;
+	if(gagnant(&s->p) != 'V') // L'adversaire vient de gagner
+	{
+		*pn = DFPN_INFINI;
+		*dn = 0;
+		return;
+	}
+
+	entree = cherche_entree(cle);
+	if(racine && entree != NULL && entree->pn == 0 && entree->coup == AUCUN_COUP) // (Victoire conclue sans
+	{																		// coup: il faut le chercher)
+		entree = NULL;
+	}
+	if(entree != NULL && (entree->pn >= seuil_pn || entree->dn >= seuil_dn || budget_dfpn_epuise(s)))
+	{
+		*pn = entree->pn;
+		*dn = entree->dn;
+		return;
+	}
+	else if(budget_dfpn_epuise(s))
+	{
+		*pn = *dn = 1;
+		return;
+	}
+
+	// Conclusions immédiates, et coups à chercher
+	jouables = cases_vides(&s->p);
+	*pn = *dn = DFPN_INFINI;
+	if(!racine && (connexion_frontieres(s->connexions[couleur]) || semi_connexion_frontieres(s->connexions[couleur], &zone)))
+	{
+		*pn = 0;
+	}
+	else if(connexion_frontieres(s->connexions[1-couleur]))
+	{
+		*dn = 0;
+	}
+	else
+	{
+		if(semi_connexion_frontieres(s->connexions[1-couleur], &zone))
+		{
+			jouables = bb_et(jouables, zone);
+		}
+		jouables = bb_sauf(jouables, cases_inferieures(&s->p, joueur, &gagnant_remplissage));
+		if(gagnant_remplissage == couleur && !racine)
+		{
+			*pn = 0;
+		}
+		else if(gagnant_remplissage == 1-couleur || bb_est_nul(jouables))
+		{
+			*dn = 0;
+		}
+	}
+	if(*pn == 0 || *dn == 0)
+	{
+		stocke_entree(cle, *pn, *dn, 1, AUCUN_COUP);
+		return;
+	}
+
+	while((k = bb_extrait(&jouables)) >= 0) // Fils, avec les nombres déjà connus (1 sinon)
+	{
+		cle_fils = cle ^ cles_zobrist[couleur][k] ^ CLE_TRAIT_DFPN;
+		entree = cherche_entree(cle_fils);
+		coups[n] = k;
+		pn_fils[n] = (entree != NULL) ? entree->pn : 1;
+		dn_fils[n] = (entree != NULL) ? entree->dn : 1;
+		n++;
+	}
+
+	while(true)
+	{
+		*pn = dn_second = DFPN_INFINI;
+		*dn = 0;
+		for ( i = 0 ; i < n ; i++ )
+		{
+			if(dn_fils[i] < *pn)
+			{
+				dn_second = *pn;
+				*pn = dn_fils[i];
+				meilleur = i;
+			}
+			else if(dn_fils[i] < dn_second)
+			{
+				dn_second = dn_fils[i];
+			}
+
+			if(pn_fils[i] >= DFPN_INFINI) // (Somme saturée: seul un fils perdu rend la position gagnée)
+			{
+				*dn = DFPN_INFINI;
+			}
+			else if(*dn < DFPN_INFINI)
+			{
+				*dn = (*dn + pn_fils[i] < DFPN_INFINI - 1) ? *dn + pn_fils[i] : DFPN_INFINI - 1;
+			}
+		}
+
+		if(*pn >= seuil_pn || *dn >= seuil_dn || s->interrompu)
+		{
+			break;
+		}
+
+		seuil_pn_fils = seuil_dn - *dn + pn_fils[meilleur];
+		seuil_dn_fils = dn_second + dn_second / 4 + 1;
+		if(seuil_dn_fils > seuil_pn)
+		{
+			seuil_dn_fils = seuil_pn;
+		}
+
+		k = coups[meilleur];
+		joue_coup(&s->p, k % s->p.largeur, k / s->p.largeur - 2, joueur);
+		joue_connexions(s->connexions[0], k, couleur, true);
+		joue_connexions(s->connexions[1], k, couleur, true);
+		explore(s, couleur_opposee(joueur), seuil_pn_fils, seuil_dn_fils, &pn_fils[meilleur], &dn_fils[meilleur], false);
+		dejoue_connexions(s->connexions[0]);
+		dejoue_connexions(s->connexions[1]);
+		dejoue_coup(&s->p);
+	}
+
+	stocke_entree(cle, *pn, *dn, s->noeuds - debut, (*pn == 0) ? coups[meilleur] : AUCUN_COUP);
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur le plateau à résoudre
+ *	\param	joueur Couleur du joueur qui a le trait
+ *	\param	duree_max Temps accordé (en ms, 0 si illimité)
+ *	\param	noeuds_max Nombre maximal de nœuds à chercher (0 si illimité)
+ *	\param	coup Pointeur sur les coordonnées du coup gagnant, à renseigner ({-1,-1} s'il n'y en a pas)
+ *	\return	#DFPN_GAGNE si le joueur est assuré de gagner, #DFPN_PERDU s'il est assuré de perdre, et #DFPN_INCONNU si le budget n'a pas suffi
+ *
+ *	La table de transposition n'est vidée que si la dimension change: les positions déjà prouvées
+ *	(lors d'une résolution précédente, par exemple au coup d'avant) sont conclues immédiatement, de
+ *	même que les positions gagnées des tables de positions résolues (voir resolues.h).
+ */
+int resous_position(const plateau *p, char joueur, unsigned int duree_max, unsigned long noeuds_max, coord *coup)
+{
+	solveur_dfpn s;
+	unsigned int pn, dn;
+	int couleur;
+	entree_dfpn *entree;
+	bitboard vides = cases_vides(p);
+
+	coup->x = coup->y = -1;
+	if(gagnant(p) != 'V' || bb_est_nul(vides) || !prepare_solveur(p->dim))
+	{
+		return DFPN_INCONNU;
+	}
+	if(coup_table_resolue(p, joueur, coup)) // Position résolue d'avance
+	{
+		nb_noeuds = 0;
+		return DFPN_GAGNE;
+	}
+
+	s.p = *p;
+	s.p.tab = NULL; // La résolution ne doit pas toucher à la matrice du plateau affiché
+	s.debut = SDL_GetTicks();
+	s.duree_max = duree_max;
+	s.noeuds = 0;
+	s.noeuds_max = noeuds_max;
+	s.interrompu = false;
+	for ( couleur = 0 ; couleur < 2 ; couleur++ )
+	{
+		s.connexions[couleur] = bases[couleur];
+		calcule_connexions(s.connexions[couleur], &s.p, couleur);
+	}
+
+	explore(&s, joueur, DFPN_INFINI, DFPN_INFINI, &pn, &dn, true);
+	nb_noeuds = s.noeuds;
+
+	if(pn == 0)
+	{
+		entree = cherche_entree(p->cle ^ (indice_couleur(joueur) ? CLE_TRAIT_DFPN : 0)); // (La dernière entrée écrite)
+		if(entree == NULL || entree->coup == AUCUN_COUP || !bb_teste(&vides, entree->coup))
+		{
+			return DFPN_INCONNU; // (Entrée écrasée entre-temps: le coup gagnant n'est plus connu)
+		}
+		coup->x = entree->coup % p->largeur;
+		coup->y = entree->coup / p->largeur - 2;
+		return DFPN_GAGNE;
+	}
+	return (dn == 0) ? DFPN_PERDU : DFPN_INCONNU;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Copie du plateau sur lequel l'IA doit jouer
+ *	\param	pion Couleur du pion joué par l'IA
+ *	\param	level Niveau de l'IA, qui détermine son temps de réflexion (voir #duree_reflexion())
+ *	\return	Coordonnées à jouer
+ *
+ *	Cette Intelligence Artificielle consacre la moitié de son temps de réflexion à chercher une
+ *	preuve de victoire. Si elle la trouve, elle joue le coup gagnant (et joue ensuite parfaitement,
+ *	chaque preuve servant aux coups suivants). Sinon, ou si la position est perdue, elle joue le coup
+ *	de l'IA Electrique, qui dispose de l'autre moitié du temps.
+ *	Une position du livre d'ouvertures (voir ouvertures.h) est jouée sans recherche.
+ */
+coord ia_solveur(plateau p, char pion, int level)
+{
+	coord a_renvoyer;
+	unsigned int debut = SDL_GetTicks(), duree = (duree_imposee > 0) ? duree_imposee : duree_reflexion(level) / 2;
+	int resultat;
+
+	if(coup_livre_ouvertures(&p, pion, &a_renvoyer)) // Position du livre d'ouvertures: le coup a été cherché d'avance
+	{
+		return a_renvoyer;
+	}
+	resultat = resous_position(&p, pion, duree, noeuds_imposes, &a_renvoyer);
+
+	// (Debug) On affiche le résultat de la résolution
+	printf("Solveur: position %s (%lu noeuds, %u ms)\n", (resultat == DFPN_GAGNE) ? "gagnee" : (resultat == DFPN_PERDU) ? "perdue" : "non resolue",
+			nb_noeuds, SDL_GetTicks() - debut);
+
+	if(resultat != DFPN_GAGNE)
+	{
+		a_renvoyer = ia_electrique(p, pion, (level > 4) ? level-1 : level);
+	}
+
+	return a_renvoyer;
+}
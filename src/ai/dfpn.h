@@ -0,0 +1,65 @@
+/*!
+ *	\file	dfpn.h
+ *	\brief	Prototypes du solveur par nombres de preuve ("DFPN")
+ *	\author	Julien Laurent
+ *
+ *	Ce fichier contient les déclarations du solveur exact: au lieu d'évaluer les positions jusqu'à
+ *	un horizon fixe, il cherche à prouver que le joueur qui a le trait gagne (ou perd) à coup sûr.
+ *	Chaque nœud porte un nombre de preuve (nombre minimal de feuilles à prouver pour établir la
+ *	victoire) et un nombre de réfutation (idem pour la défaite), et la recherche en profondeur
+ *	d'abord ("Depth-First Proof-Number search", Nagai) développe toujours le nœud le plus facile à
+ *	conclure, sous des seuils qui lui évitent de remonter sans cesse à la racine.
+ *	Les positions sont conclues dès que possible par les connexions virtuelles (voir connexions.h),
+ *	et les cases inférieures ne sont jamais cherchées (voir inferieures.h). Les nombres de chaque
+ *	position rencontrée sont conservés dans une table de transposition propre au solveur, qui
+ *	survit d'une résolution à l'autre: les preuves établies pour un coup servent aux suivants.
+ */
+
+#ifndef DFPN_H_INCLUDED
+#define DFPN_H_INCLUDED
+
+#include "ai.h"
+
+#define DFPN_INFINI 0x3FFFFFFF ///< Nombre de preuve d'une position perdue (ou de réfutation d'une position gagnée)
+#define TAILLE_TABLE_DFPN 64 ///< Budget mémoire de la table de transposition du solveur (en Mo)
+#define INTERVALLE_DFPN 1024 ///< Nombre de nœuds cherchés entre deux consultations de l'horloge
+#define CLE_TRAIT_DFPN 0x9E3779B97F4A7C15ULL ///< Clé "ou-exclusivée" avec celle du plateau quand les Blancs ont le trait
+#define DIMENSION_MAX_SOLVEUR 7 ///< Dimension maximale des plateaux sur lesquels le bouton Electrique donne l'IA #ia_solveur() (au-delà, le temps accordé ne suffit à aucune preuve)
+
+#define DFPN_GAGNE 1 ///< Résultat d'une position prouvée gagnante pour le joueur qui a le trait
+#define DFPN_PERDU -1 ///< Résultat d'une position prouvée perdante pour le joueur qui a le trait
+#define DFPN_INCONNU 0 ///< Résultat d'une position que le budget n'a pas permis de conclure
+
+/*!
+ *	\brief	Entrée de la table de transposition du solveur
+ *	\author	Julien Laurent
+ *
+ *	Une entrée dont le nombre de preuve est nul est gagnée par le joueur qui a le trait, et donne
+ *	le coup gagnant; une entrée dont le nombre de réfutation est nul est perdue.
+ */
+struct entree_dfpn
+{
+	uint64_t cle; ///< Clé de la position (clé de Zobrist du plateau, combinée au trait)
+	unsigned int pn; ///< Nombre de preuve
+	unsigned int dn; ///< Nombre de réfutation
+	unsigned int travail; ///< Nombre de nœuds cherchés sous la position (0 si l'entrée est vide)
+	unsigned char coup; ///< Coup gagnant (indice dans les #bitboard) d'une position gagnée, ou #AUCUN_COUP
+};
+typedef struct entree_dfpn entree_dfpn; ///< Raccourci d'utilisation du type #entree_dfpn
+
+/// Impose un budget (temps en ms, nombre de nœuds) à toutes les résolutions suivantes, ou rétablit le budget par niveau avec (0, 0)
+void fixe_budget_dfpn(unsigned int duree_max, unsigned long noeuds_max);
+
+/// Renvoie le nombre de nœuds cherchés lors de la dernière résolution
+unsigned long noeuds_dfpn(void);
+
+/// Vide la table de transposition du solveur (pour que la résolution suivante parte de zéro)
+void vide_table_dfpn(void);
+
+/// Cherche à prouver l'issue de la position pour le joueur qui a le trait (#DFPN_GAGNE, #DFPN_PERDU ou #DFPN_INCONNU), dans la limite du temps (en ms) et du nombre de nœuds donnés (0 si illimités), et donne le coup gagnant s'il y en a un
+int resous_position(const plateau *p, char joueur, unsigned int duree_max, unsigned long noeuds_max, coord *coup);
+
+/// Renvoie les coordonnées (valides) à jouer: le coup gagnant si la position a pu être prouvée pendant le temps accordé au niveau \a level, et sinon le coup de l'IA Electrique
+coord ia_solveur(plateau p, char pion, int level);
+
+#endif // DFPN_H_INCLUDED
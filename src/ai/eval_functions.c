@@ -7,6 +7,8 @@
  *	fonctions de l'intelligence artificielle pour construire les arbres de jeu.
  */
 
+#include <math.h>
+
 #include "eval_functions.h"
 
 /*!
@@ -46,30 +48,46 @@ int high(int a, int b)
  *	pour le joueur dont la couleur est passée en paramètre (via \a pion). *
  *	Le modèle d'analyse utilisé est basé sur le décompte des "losanges" (ou \a bridges) possédés par le joueur
  *	considéré sur le plateau dans son état actuel.
+ *	Les sommes des scores de #compte_losanges() et #compte_connexions() des pions de chaque couleur sont
+ *	tenues à jour dans le plateau par #pose_pion() à chaque coup joué ou annulé: l'évaluation se réduit
+ *	donc à leur lecture (#eval_losanges_complete() donne la même valeur en recomptant tout le plateau).
  */
 int eval_losanges(plateau *p, char pion)
 {
-	int force_losanges = 0;
-	int i,j;
+	int couleur = indice_couleur(pion);
 
-	for ( i = 0 ; i < p->dim ; i++ )
+	if(couleur < 0)
 	{
-		for ( j = 0 ; j < p->dim ; j++ )
-		{
-			if(p->tab[i][j] == pion)
-			{
-				force_losanges += 2*compte_losanges(p, j, i);
-				force_losanges += compte_connexions(p, j, i);
-			}
-			else if(p->tab[i][j] == couleur_opposee(pion))
-			{
-				force_losanges -= 4*compte_losanges(p, j, i);
-				force_losanges -= 2*compte_connexions(p, j, i);
-			}
-		}
+		return 0;
+	}
+
+	return 2*p->scores_losanges[couleur] + p->scores_connexions[couleur]
+		- 4*p->scores_losanges[1-couleur] - 2*p->scores_connexions[1-couleur];
+}
+
+/*!
+ *	\author	Julien Laurent, Lucas Dessaignes, Alexis Brisset
+ *	\param	p Pointeur sur le plateau à analyser
+ *	\param	pion Couleur du pion à considérer
+ *	\return	Valeur du plateau selon #eval_losanges()
+ *
+ *	Calcul complet de #eval_losanges(), sans les sommes tenues à jour par #pose_pion() (qu'il sert à
+ *	vérifier, voir losangesTestBed()): au lieu de parcourir les pions un à un, chaque orientation de
+ *	connexion et de \a bridge est comptée sur tout le plateau à la fois, par un décalage des bitboards
+ *	suivi d'un comptage de bits (#total_losanges(), #total_connexions()). Les pondérations sont celles
+ *	de #compte_losanges() et #compte_connexions(), et la valeur est donc identique.
+ */
+int eval_losanges_complete(plateau *p, char pion)
+{
+	int couleur = indice_couleur(pion);
+
+	if(couleur < 0)
+	{
+		return 0;
 	}
 
-	return force_losanges;
+	return 2*total_losanges(p, couleur) + total_connexions(p, couleur)
+		- 4*total_losanges(p, 1-couleur) - 2*total_connexions(p, 1-couleur);
 }
 
 /*!
@@ -82,7 +100,7 @@ int eval_losanges(plateau *p, char pion)
  *	\return	Score (intelligent) de la case, basé sur le nombre et le type de losanges
  *
  *	Cette fonction renvoie un "score intelligent" associé à une case du plateau, en comptant les
- *	losanges qui l'entourent, et en prenant en compte la couleur du pion présent sur la case considérée
+ *	losanges qui l'entourent, et en prenant en compte la couleur du pion présent sur la case considérée.
  */
 int compte_losanges(plateau *p, int x, int y)
 {
@@ -90,118 +108,44 @@ int compte_losanges(plateau *p, int x, int y)
 	{
 		return -2;
 	}
-	char pion=p->tab[y][x];
-	int nb_losanges=0;
 
-	switch(pion)
+	switch(case_plateau(p, x, y))
 	{
 		case 'N':
-			if(coordExiste(x-1, y-1, p))
-			{
-				if(p->tab[y-1][x-1]==pion)
-				{
-					nb_losanges += 2;
-				}
-			}
-
-			if(coordExiste(x+1, y-2, p))
-			{
-				if(p->tab[y-2][x+1]==pion)
-				{
-					nb_losanges += 3;
-				}
-			}
-
-			if(coordExiste(x+2, y-1, p))
-			{
-				if(p->tab[y-1][x+2]==pion)
-				{
-					nb_losanges += 1;
-				}
-			}
-
-			if(coordExiste(x+1, y+1, p))
-			{
-				if(p->tab[y+1][x+1]==pion)
-				{
-					nb_losanges += 2;
-				}
-			}
-
-			if(coordExiste(x-1, y+2, p))
-			{
-				if(p->tab[y+2][x-1]==pion)
-				{
-					nb_losanges += 3;
-				}
-			}
-
-			if(coordExiste(x-2, y+1, p))
-			{
-				if(p->tab[y+1][x-2]==pion)
-				{
-					nb_losanges += 1;
-				}
-			}
-		break;
-
 		case 'B':
-			if(coordExiste(x-1, y-1, p))
-			{
-				if(p->tab[y-1][x-1]==pion)
-				{
-					nb_losanges += 2;
-				}
-			}
-
-			if(coordExiste(x+1, y-2, p))
-			{
-				if(p->tab[y-2][x+1]==pion)
-				{
-					nb_losanges += 1;
-				}
-			}
-
-			if(coordExiste(x+2, y-1, p))
-			{
-				if(p->tab[y-1][x+2]==pion)
-				{
-					nb_losanges += 3;
-				}
-			}
-
-			if(coordExiste(x+1, y+1, p))
-			{
-				if(p->tab[y+1][x+1]==pion)
-				{
-					nb_losanges += 2;
-				}
-			}
-
-			if(coordExiste(x-1, y+2, p))
-			{
-				if(p->tab[y+2][x-1]==pion)
-				{
-					nb_losanges += 1;
-				}
-			}
-
-			if(coordExiste(x-2, y+1, p))
-			{
-				if(p->tab[y+1][x-2]==pion)
-				{
-					nb_losanges += 3;
-				}
-			}
-
+			return losanges_potentiels(p, x, y, case_plateau(p, x, y));
 		break;
 
 		default:
-			nb_losanges = -1;
+			return -1;
 		break;
 	}
+}
 
-	return nb_losanges;
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur le plateau à analyser
+ *	\param	x Abscisse de la case considérée (qui doit exister)
+ *	\param	y Ordonnée de la case considérée (qui doit exister)
+ *	\param	pion Couleur du pion supposé posé sur la case ('N' ou 'B')
+ *	\return	Score de la case, comme #compte_losanges() le calculerait si \a pion y était posé
+ *
+ *	La case elle-même n'est pas consultée: le score d'une case vide donne donc le nombre (pondéré)
+ *	de \a bridges qu'y formerait un pion de la couleur \a pion, ce qui sert aussi à l'ordonnancement
+ *	des coups de l'AlphaBeta.
+ *	Les cases de \a bridge hors du plateau tombent dans les colonnes et lignes de garde des #bitboard
+ *	(toujours vides): aucun test de bornes n'est donc nécessaire.
+ */
+int losanges_potentiels(const plateau *p, int x, int y, char pion)
+{
+	int couleur = indice_couleur(pion);
+
+	if(couleur < 0)
+	{
+		return -1;
+	}
+
+	return score_losanges(p, indice_case(p, x, y), couleur); // (Pondérations données par outils/genere_motifs.c)
 }
 
 /*!
@@ -223,145 +167,518 @@ int compte_connexions(plateau *p, int x, int y)
 	{
 		return -2;
 	}
-	char pion = p->tab[y][x];
-	int connecs=0;
+	int couleur = indice_couleur(case_plateau(p, x, y));
 
-	switch(pion)
+	if(couleur < 0)
 	{
-		case 'N':
-			if(coordExiste(x,y-1, p))
-			{
-				if(p->tab[y-1][x] == 'N')
-				{
-					connecs += 3;
-				}
-			}
+		return -1;
+	}
 
-			if(coordExiste(x+1, y-1, p))
-			{
-				if(p->tab[y-1][x+1] == 'N')
-				{
-					connecs += 2;
-				}
-			}
+	return score_connexions(p, indice_case(p, x, y), couleur); // (Pondérations données par outils/genere_motifs.c)
+}
 
-			if(coordExiste(x+1, y, p))
-			{
-				if(p->tab[y][x+1] == 'N')
-				{
-					connecs += 1;
-				}
-			}
+int eval_hasard(plateau *p, char pion)
+{
+	(void)p;
+	(void)pion;
+	return hasard(-40,40);
+}
 
-			if(coordExiste(x, y+1, p))
-			{
-				if(p->tab[y+1][x] == 'N')
-				{
-					connecs += 3;
-				}
-			}
+/*
+ * Potentiels de la dernière résolution de chaque circuit, qui servent de point de départ à la
+ * suivante ("démarrage à chaud"). Les évaluations successives d'une recherche ne diffèrent que de
+ * quelques pions, et leurs potentiels sont donc très proches. Chaque fil d'exécution de la recherche
+ * a les siens (variables locales au fil, "__thread").
+ */
+static __thread double potentiels[2][BITS_BITBOARD]; ///< Potentiels du circuit de chaque couleur, par indice de case
+static __thread int dimension_potentiels[2] = {0, 0}; ///< Dimension du plateau de la dernière résolution (0 si aucune)
+static __thread unsigned long iterations_cumulees = 0; ///< Nombre d'itérations du gradient conjugué effectuées par le fil
 
-			if(coordExiste(x-1, y+1, p))
-			{
-				if(p->tab[y+1][x-1] == 'N')
-				{
-					connecs += 2;
-				}
-			}
+/*!
+ *	\author	Julien Laurent
+ *	\return	Nombre total d'itérations du gradient conjugué effectuées par le fil appelant
+ */
+unsigned long iterations_resistance(void)
+{
+	return iterations_cumulees;
+}
 
-			if(coordExiste(x-1, y, p))
-			{
-				if(p->tab[y][x-1] == 'N')
-				{
-					connecs += 1;
-				}
-			}
-		break;
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur le plateau à analyser
+ *	\param	couleur Indice de la couleur du circuit (0: noir, 1: blanc)
+ *	\return	Résistance du circuit entre les deux frontières de la couleur (#RESISTANCE_INFINIE si elles sont séparées)
+ *
+ *	Chaque case vide est une résistance de #RESISTANCE_CASE_VIDE, chaque pion de la couleur une
+ *	résistance de #RESISTANCE_CASE_AMIE, et les pions adverses sont isolants. Deux cases voisines
+ *	sont reliées par la somme de leurs résistances, et chaque frontière forme une borne du circuit
+ *	(potentiel 1 pour la première, 0 pour la seconde). Seules les cases reliées à la première borne
+ *	sont prises en compte: le système des lois des nœuds (de Kirchhoff) est alors symétrique défini
+ *	positif, et résolu par la méthode du gradient conjugué, préconditionnée par la diagonale.
+ *	Le courant sortant de la première borne donne la résistance du circuit.
+ */
+static double resistance_circuit(const plateau *p, int couleur)
+{
+	const topologie *topo = p->topo;
+	int cases[DIM_MAX*DIM_MAX], numero[BITS_BITBOARD];
+	int voisins[DIM_MAX*DIM_MAX][6], nb_voisins[DIM_MAX*DIM_MAX];
+	double conductances[DIM_MAX*DIM_MAX][6], diagonale[DIM_MAX*DIM_MAX], entree[DIM_MAX*DIM_MAX];
+	double x[DIM_MAX*DIM_MAX], r[DIM_MAX*DIM_MAX], z[DIM_MAX*DIM_MAX], d[DIM_MAX*DIM_MAX], Ad[DIM_MAX*DIM_MAX];
+	double ri, rk, alpha, rz, rz_suivant, rr, dAd, seuil = 0.0, courant = 0.0;
+	double *v = potentiels[couleur];
+	int i, j, k, n = 0, iterations;
+	const bitboard *amis = &p->pions[couleur], *source = &p->bords[2*couleur], *puits = &p->bords[2*couleur+1];
+	bitboard conductrices = bb_sauf(p->cases, p->pions[1-couleur]);
+	bitboard atteintes = bb_nul(), suivantes = bb_et(conductrices, *source), parcours;
+
+	while(!bb_egal(atteintes, suivantes)) // Cases reliées à la première borne
+	{
+		atteintes = suivantes;
+		suivantes = bb_et(bb_ou(atteintes, voisinage(p, atteintes)), conductrices);
+	}
+	if(bb_est_nul(bb_et(atteintes, *puits))) // Frontières séparées par les pions adverses
+	{
+		return RESISTANCE_INFINIE;
+	}
 
-		case 'B':
-			if(coordExiste(x,y-1, p))
-			{
-				if(p->tab[y-1][x] == 'B')
-				{
-					connecs += 1;
-				}
-			}
+	if(dimension_potentiels[couleur] != p->dim) // Pas de résolution précédente: potentiels décroissant
+	{											// régulièrement d'une frontière à l'autre
+		parcours = p->cases;
+		while((k = bb_extrait(&parcours)) >= 0)
+		{
+			v[k] = 1.0 - (double)topo->distances[k][2*couleur] / (p->dim - 1);
+		}
+		dimension_potentiels[couleur] = p->dim;
+	}
 
-			if(coordExiste(x+1, y-1, p))
-			{
-				if(p->tab[y-1][x+1] == 'B')
-				{
-					connecs += 2;
-				}
-			}
+	parcours = atteintes;
+	while((k = bb_extrait(&parcours)) >= 0)
+	{
+		numero[k] = n;
+		cases[n++] = k;
+	}
 
-			if(coordExiste(x+1, y, p))
+	// Construction du système (matrice creuse: au plus 6 voisins par case)
+	for ( i = 0 ; i < n ; i++ )
+	{
+		k = cases[i];
+		ri = bb_teste(amis, k) ? RESISTANCE_CASE_AMIE : RESISTANCE_CASE_VIDE;
+		nb_voisins[i] = 0;
+		diagonale[i] = 0.0;
+		for ( j = 0 ; j < 6 ; j++ )
+		{
+			if(bb_teste(&atteintes, topo->voisins[k][j]))
 			{
-				if(p->tab[y][x+1] == 'B')
-				{
-					connecs += 3;
-				}
+				rk = bb_teste(amis, topo->voisins[k][j]) ? RESISTANCE_CASE_AMIE : RESISTANCE_CASE_VIDE;
+				voisins[i][nb_voisins[i]] = numero[topo->voisins[k][j]];
+				conductances[i][nb_voisins[i]] = 1.0 / (ri + rk);
+				diagonale[i] += conductances[i][nb_voisins[i]++];
 			}
+		}
+		entree[i] = bb_teste(source, k) ? 1.0 / ri : 0.0; // Conductance vers la borne de potentiel 1
+		diagonale[i] += entree[i] + (bb_teste(puits, k) ? 1.0 / ri : 0.0);
+		seuil += entree[i] * entree[i];
+		x[i] = v[k];
+	}
+	seuil *= PRECISION_RESISTANCE * PRECISION_RESISTANCE;
 
-			if(coordExiste(x, y+1, p))
+	// Gradient conjugué préconditionné, à partir des potentiels précédents
+	rz = rr = 0.0;
+	for ( i = 0 ; i < n ; i++ )
+	{
+		r[i] = entree[i] - diagonale[i] * x[i];
+		for ( j = 0 ; j < nb_voisins[i] ; j++ )
+		{
+			r[i] += conductances[i][j] * x[voisins[i][j]];
+		}
+		d[i] = z[i] = r[i] / diagonale[i];
+		rz += r[i] * z[i];
+		rr += r[i] * r[i];
+	}
+
+	for ( iterations = 0 ; iterations < ITERATIONS_MAX_RESISTANCE && rr > seuil ; iterations++ )
+	{
+		dAd = 0.0;
+		for ( i = 0 ; i < n ; i++ )
+		{
+			Ad[i] = diagonale[i] * d[i];
+			for ( j = 0 ; j < nb_voisins[i] ; j++ )
 			{
-				if(p->tab[y+1][x] == 'B')
-				{
-					connecs += 1;
-				}
+				Ad[i] -= conductances[i][j] * d[voisins[i][j]];
 			}
+			dAd += d[i] * Ad[i];
+		}
 
-			if(coordExiste(x-1, y+1, p))
+		alpha = rz / dAd;
+		rz_suivant = rr = 0.0;
+		for ( i = 0 ; i < n ; i++ )
+		{
+			x[i] += alpha * d[i];
+			r[i] -= alpha * Ad[i];
+			z[i] = r[i] / diagonale[i];
+			rz_suivant += r[i] * z[i];
+			rr += r[i] * r[i];
+		}
+
+		for ( i = 0 ; i < n ; i++ )
+		{
+			d[i] = z[i] + (rz_suivant / rz) * d[i];
+		}
+		rz = rz_suivant;
+	}
+	iterations_cumulees += iterations;
+
+	for ( i = 0 ; i < n ; i++ )
+	{
+		v[cases[i]] = x[i];
+		courant += entree[i] * (1.0 - x[i]);
+	}
+
+	return (courant > 1.0 / RESISTANCE_INFINIE) ? 1.0 / courant : RESISTANCE_INFINIE;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur le plateau à analyser
+ *	\param	pion Couleur du pion à considérer
+ *	\return	Valeur indicative sur l'avantage du joueur de la couleur \a pion dans l'état actuel du plateau
+ *
+ *	Cette fonction analyse le plateau dont l'adresse est passée en paramètre, et renvoie un "indice d'avantage"
+ *	pour le joueur dont la couleur est passée en paramètre (via \a pion).
+ *	Le modèle d'analyse utilisé est basé sur l'analogie avec les systèmes électriques: les différents états
+ *	possibles pour une case correspondent alors à des "conductions" différentes, et la conduction totale du
+ *	plateau donne une idée de l'avantage du joueur (voir #resistance_circuit()).
+ *	La valeur renvoyée est l'écart relatif entre la résistance du circuit adverse et celle du circuit
+ *	du joueur, porté à l'échelle de #EVALUATION_MAX_RESISTANCE: elle reste donc en deçà de la valeur
+ *	d'une victoire dans l'AlphaBeta.
+ */
+int eval_resistance(plateau *p, char pion)
+{
+	int couleur = indice_couleur(pion);
+	double amie, adverse, valeur;
+
+	if(couleur < 0)
+	{
+		return 0;
+	}
+
+	amie = resistance_circuit(p, couleur);
+	adverse = resistance_circuit(p, 1-couleur);
+
+	if(amie >= RESISTANCE_INFINIE)
+	{
+		return -EVALUATION_MAX_RESISTANCE;
+	}
+	else if(adverse >= RESISTANCE_INFINIE)
+	{
+		return EVALUATION_MAX_RESISTANCE;
+	}
+
+	valeur = EVALUATION_MAX_RESISTANCE * (adverse - amie) / (adverse + amie);
+
+	return (int)floor(valeur + 0.5);
+}
+
+/*!
+ *	\brief	Carte de double distance à une frontière, et étapes de son calcul
+ *	\author	Julien Laurent
+ *
+ *	Le calcul des distances procède par distances croissantes (voir #calcule_distances()). L'état du
+ *	calcul à la fin de chaque distance est conservé: quand le plateau change, les premières distances
+ *	restent souvent valables, et le calcul reprend à partir de la première distance modifiée.
+ */
+struct carte_distances
+{
+	unsigned char distance[BITS_BITBOARD]; ///< Double distance de chaque case vide à la frontière (#DISTANCE_INFINIE si elle ne peut plus l'atteindre)
+	bitboard atteintes[NIVEAUX_MAX_DISTANCES]; ///< Cases à distance inférieure ou égale à chaque distance
+	bitboard une_voisine[NIVEAUX_MAX_DISTANCES]; ///< Cases voisines d'au moins une de ces cases
+	bitboard deux_voisines[NIVEAUX_MAX_DISTANCES]; ///< Cases voisines d'au moins deux de ces cases
+	int niveaux; ///< Nombre de distances dont l'état est conservé (à partir de 1)
+};
+typedef struct carte_distances carte_distances; ///< Raccourci d'utilisation du type #carte_distances
+
+/*
+ * Cartes de double distance de la dernière évaluation, propres à chaque fil d'exécution. Les positions
+ * évaluées successivement par une recherche ne diffèrent que de quelques pions: les cartes sont mises
+ * à jour à partir des cases modifiées, plutôt que recalculées entièrement (voir #eval_deux_distances()).
+ */
+static __thread carte_distances cartes[2][2]; ///< Cartes de chaque couleur, pour chacune de ses deux frontières
+static __thread bitboard voisins_distances[2][BITS_BITBOARD]; ///< Voisins étendus de chaque case vide, pour chaque couleur (voir #voisinages_etendus())
+static __thread bitboard bordants_distances[2][2]; ///< Cases vides voisines de chaque frontière de chaque couleur
+static __thread bitboard pions_distances[2]; ///< Pions du plateau auquel correspondent les cartes
+static __thread int dimension_distances = 0; ///< Dimension du plateau auquel correspondent les cartes (0 si aucun)
+static __thread unsigned long distances_cumulees = 0; ///< Nombre de distances (re)calculées par le fil
+static bool increment_distances = true; ///< Faux pour recalculer entièrement les cartes à chaque évaluation
+
+/*!
+ *	\author	Julien Laurent
+ *	\return	Nombre total de distances (re)calculées par #eval_deux_distances() dans le fil appelant
+ */
+unsigned long distances_calculees(void)
+{
+	return distances_cumulees;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	actif Vrai pour mettre les cartes de distances à jour d'une évaluation à l'autre (par défaut), faux pour les recalculer entièrement
+ *
+ *	Ne sert qu'à vérifier et mesurer la mise à jour incrémentale (voir deuxDistancesTestBed() dans main.c).
+ */
+void active_increment_distances(bool actif)
+{
+	increment_distances = actif;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur le plateau à analyser
+ *	\param	couleur Indice de la couleur du joueur (0: noir, 1: blanc)
+ *	\param	cases Cases dont les voisinages sont à (re)calculer (seules les cases vides sont prises en compte)
+ *
+ *	Pour la double distance, les pions du joueur sont "transparents": deux cases vides voisines d'un
+ *	même groupe de pions du joueur sont voisines entre elles, et une case voisine d'un groupe qui touche
+ *	une frontière est voisine de cette frontière. Les pions adverses, eux, bloquent le passage.
+ *	Les voisinages des autres cases sont ceux du calcul précédent.
+ */
+static void voisinages_etendus(const plateau *p, int couleur, bitboard cases)
+{
+	const short (*voisines)[6] = p->topo->voisins;
+	bitboard *voisins = voisins_distances[couleur], *bordants = bordants_distances[couleur];
+	bitboard vides = cases_vides(p), amis, groupe, acces, parcours;
+	int i, j, k;
+
+	cases = bb_et(cases, vides);
+	parcours = cases;
+	while((k = bb_extrait(&parcours)) >= 0)
+	{
+		voisins[k] = bb_nul();
+		for ( j = 0 ; j < 6 ; j++ )
+		{
+			if(bb_teste(&vides, voisines[k][j]))
 			{
-				if(p->tab[y+1][x-1] == 'B')
-				{
-					connecs += 2;
-				}
+				bb_place(&voisins[k], voisines[k][j]);
 			}
+		}
+	}
+	for ( j = 0 ; j < 2 ; j++ )
+	{
+		bordants[j] = bb_ou(bb_et(bb_sauf(bordants[j], cases), vides), bb_et(cases, p->bords[2*couleur+j]));
+	}
 
-			if(coordExiste(x-1, y, p))
+	amis = bb_et(voisinage(p, cases), p->pions[couleur]); // Pions des groupes qui touchent les cases
+	while((i = bb_extrait(&amis)) >= 0) // Un groupe à la fois
+	{
+		groupe = composante(p, i, couleur);
+		amis = bb_sauf(amis, groupe);
+		acces = bb_et(voisinage(p, groupe), vides);
+
+		parcours = bb_et(acces, cases);
+		while((k = bb_extrait(&parcours)) >= 0)
+		{
+			voisins[k] = bb_ou(voisins[k], acces);
+			bb_retire(&voisins[k], k);
+		}
+		for ( j = 0 ; j < 2 ; j++ )
+		{
+			if(!bb_est_nul(bb_et(groupe, p->bords[2*couleur+j])))
 			{
-				if(p->tab[y][x-1] == 'B')
-				{
-					connecs += 3;
-				}
+				bordants[j] = bb_ou(bordants[j], bb_et(acces, cases));
 			}
-		break;
+		}
+	}
+}
 
-		default:
-			connecs = -1;
-		break;
+/*!
+ *	\author	Julien Laurent
+ *	\param	carte Carte de distances à (re)calculer
+ *	\param	voisins Voisins étendus de chaque case vide (voir #voisinages_etendus())
+ *	\param	bordants Cases vides voisines de la frontière
+ *	\param	vides Cases vides du plateau
+ *	\param	depart Première distance à recalculer (1: carte entière), les plus petites étant conservées
+ *
+ *	Une case voisine de la frontière est à distance 1. Une autre case est à distance n+1 quand la
+ *	deuxième plus proche de ses voisines est à distance n: l'adversaire pouvant toujours couper le
+ *	meilleur chemin, seul le deuxième compte. Les cases sont fixées par distances croissantes, et
+ *	chaque case fixée ajoute ses voisines aux cases qui ont au moins une, puis au moins deux voisines
+ *	fixées (comme un demi-additionneur, sur tout le #bitboard à la fois): la distance suivante est
+ *	formée des cases qui en ont deux.
+ */
+static void calcule_distances(carte_distances *carte, const bitboard voisins[], bitboard bordants, bitboard vides, int depart)
+{
+	bitboard atteintes, une, deux, niveau, parcours;
+	int k, v;
+
+	depart = low(depart, carte->niveaux + 1);
+	if(depart <= 1)
+	{
+		depart = 1;
+		atteintes = une = deux = bb_nul();
+		niveau = bordants;
+	}
+	else // Reprise de l'état du calcul à la fin de la distance précédente
+	{
+		atteintes = bb_et(carte->atteintes[depart-2], vides);
+		une = carte->une_voisine[depart-2];
+		deux = carte->deux_voisines[depart-2];
+		niveau = bb_sauf(bb_et(deux, vides), atteintes);
+	}
+
+	parcours = bb_sauf(vides, atteintes);
+	while((k = bb_extrait(&parcours)) >= 0)
+	{
+		carte->distance[k] = DISTANCE_INFINIE;
 	}
 
-	return connecs;
+	for ( v = depart ; !bb_est_nul(niveau) ; v++ )
+	{
+		atteintes = bb_ou(atteintes, niveau);
+		parcours = niveau;
+		while((k = bb_extrait(&parcours)) >= 0)
+		{
+			carte->distance[k] = v;
+			deux = bb_ou(deux, bb_et(une, voisins[k]));
+			une = bb_ou(une, voisins[k]);
+		}
+		distances_cumulees += bb_compte(niveau);
+
+		if(v <= NIVEAUX_MAX_DISTANCES)
+		{
+			carte->atteintes[v-1] = atteintes;
+			carte->une_voisine[v-1] = une;
+			carte->deux_voisines[v-1] = deux;
+		}
+		niveau = bb_sauf(bb_et(deux, vides), atteintes);
+	}
+	carte->niveaux = low(v - 1, NIVEAUX_MAX_DISTANCES);
 }
 
-int eval_hasard(plateau *p, char pion)
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur le plateau à analyser
+ *	\param	couleur Indice de la couleur du joueur (0: noir, 1: blanc)
+ *	\param	changees Cases dont le contenu a changé depuis le calcul des cartes
+ *	\param	departs Première distance à recalculer dans chacune des deux cartes du joueur
+ *	\return	Cases dont les voisinages étendus ont pu changer
+ *
+ *	Une case posée ou retirée ne modifie les voisinages étendus que parmi ses voisines et celles des
+ *	groupes du joueur qui la touchent, avant comme après le changement. Une distance ne dépendant
+ *	que de distances plus petites, toutes celles qui sont inférieures à la plus petite ancienne
+ *	distance de cette zone sont inchangées. Le contact avec une frontière ne change, lui, que si la
+ *	case ou l'un de ces groupes la touche: la carte est alors entièrement recalculée.
+ */
+static bitboard zone_modifiee(const plateau *p, int couleur, bitboard changees, int departs[2])
 {
-	(void)p;
-	(void)pion;
-	return hasard(-40,40);
+	bitboard amis = bb_ou(p->pions[couleur], pions_distances[couleur]), noyau = bb_nul(), zone, parcours;
+	bitboard anciennes_vides = bb_sauf(p->cases, bb_ou(pions_distances[0], pions_distances[1]));
+	int j, k;
+
+	while(!bb_egal(noyau, changees)) // Cases changées et groupes du joueur qui les touchent
+	{
+		noyau = changees;
+		changees = bb_ou(noyau, bb_et(voisinage(p, noyau), amis));
+	}
+	zone = bb_et(bb_ou(noyau, voisinage(p, noyau)), p->cases);
+
+	for ( j = 0 ; j < 2 ; j++ )
+	{
+		departs[j] = DISTANCE_INFINIE;
+		if(!bb_est_nul(bb_et(noyau, p->bords[2*couleur+j])))
+		{
+			departs[j] = 1;
+			continue;
+		}
+		parcours = bb_et(zone, anciennes_vides);
+		while((k = bb_extrait(&parcours)) >= 0)
+		{
+			departs[j] = low(departs[j], cartes[couleur][j].distance[k]);
+		}
+	}
+
+	return zone;
 }
 
 /*!
- *	\author	N/A
+ *	\author	Julien Laurent
  *	\param	p Pointeur sur le plateau à analyser
  *	\param	pion Couleur du pion à considérer
  *	\return	Valeur indicative sur l'avantage du joueur de la couleur \a pion dans l'état actuel du plateau
  *
- *	Cette fonction analyse le plateau dont l'adresse est passée en paramètre, et renvoie un "indice d'avantage"
- *	pour le joueur dont la couleur est passée en paramètre (via \a pion).
- *	Le modèle d'analyse utilisé est basé sur l'analogie avec les systèmes électriques: les différents états
- *	possibles pour une case correspondent alors à des "conductions" différentes, et la conduction totale du
- *	plateau donne une idée de l'avantage du joueur.
+ *	Évaluation par "double distance" (celle du programme Queenbee): le potentiel d'une case vide est la
+ *	somme de ses doubles distances aux deux frontières d'un joueur (voir #calcule_distances()), et le
+ *	potentiel du joueur est le plus petit de ceux de ses cases: c'est, à peu près, le nombre de coups
+ *	qu'il lui reste à jouer pour relier ses frontières malgré l'adversaire. La valeur renvoyée est
+ *	l'écart entre les potentiels des deux joueurs (#POIDS_POTENTIEL par coup), départagé par le nombre
+ *	de cases qui atteignent le potentiel de chacun (moins de #POIDS_POTENTIEL au total), et reste
+ *	comprise entre -#EVALUATION_MAX_DISTANCES et #EVALUATION_MAX_DISTANCES.
+ *	Les cartes de distances du fil sont mises à jour à partir des cases modifiées depuis la dernière
+ *	évaluation (voir #zone_modifiee()), et entièrement recalculées au-delà de #CHANGEMENTS_MAX_DISTANCES.
  */
-int eval_resistance(plateau *p, char pion)
+int eval_deux_distances(plateau *p, char pion)
 {
-	(void)p;
-	(void)pion;
-	int conductance = 0;
+	int couleur = indice_couleur(pion), c, j, k, potentiel[2], nombre[2], departs[2], valeur;
+	bitboard vides = cases_vides(p), zone, parcours;
+	bitboard changees = bb_ou(bb_ou(bb_sauf(p->pions[0], pions_distances[0]), bb_sauf(pions_distances[0], p->pions[0])),
+		bb_ou(bb_sauf(p->pions[1], pions_distances[1]), bb_sauf(pions_distances[1], p->pions[1])));
+	bool complet = !increment_distances || dimension_distances != p->dim || bb_compte(changees) > CHANGEMENTS_MAX_DISTANCES;
 
+	if(couleur < 0)
+	{
+		return 0;
+	}
+
+	for ( c = 0 ; c < 2 ; c++ )
+	{
+		if(complet)
+		{
+			voisinages_etendus(p, c, vides);
+			for ( j = 0 ; j < 2 ; j++ )
+			{
+				calcule_distances(&cartes[c][j], voisins_distances[c], bordants_distances[c][j], vides, 1);
+			}
+		}
+		else if(!bb_est_nul(changees))
+		{
+			zone = zone_modifiee(p, c, changees, departs);
+			voisinages_etendus(p, c, zone);
+			for ( j = 0 ; j < 2 ; j++ )
+			{
+				calcule_distances(&cartes[c][j], voisins_distances[c], bordants_distances[c][j], vides, departs[j]);
+			}
+		}
+
+		potentiel[c] = 2*DISTANCE_INFINIE;
+		nombre[c] = 0;
+		parcours = vides;
+		while((k = bb_extrait(&parcours)) >= 0)
+		{
+			valeur = cartes[c][0].distance[k] + cartes[c][1].distance[k];
+			if(valeur < potentiel[c])
+			{
+				potentiel[c] = valeur;
+				nombre[c] = 1;
+			}
+			else if(valeur == potentiel[c])
+			{
+				nombre[c]++;
+			}
+		}
+	}
+	pions_distances[0] = p->pions[0];
+	pions_distances[1] = p->pions[1];
+	dimension_distances = p->dim;
+
+	if(potentiel[couleur] >= DISTANCE_INFINIE) // Frontières du joueur séparées
+	{
+		return (potentiel[1-couleur] >= DISTANCE_INFINIE) ? 0 : -EVALUATION_MAX_DISTANCES;
+	}
+	else if(potentiel[1-couleur] >= DISTANCE_INFINIE)
+	{
+		return EVALUATION_MAX_DISTANCES;
+	}
 
+	valeur = POIDS_POTENTIEL * (potentiel[1-couleur] - potentiel[couleur])
+		+ (POIDS_POTENTIEL/2 * (nombre[couleur] - nombre[1-couleur])) / (nombre[couleur] + nombre[1-couleur]);
 
-	return conductance;
+	return high(-EVALUATION_MAX_DISTANCES, low(EVALUATION_MAX_DISTANCES, valeur));
 }
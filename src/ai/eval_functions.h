@@ -12,14 +12,33 @@
 
 #include "../model/data_models.h"
 
+#define RESISTANCE_CASE_VIDE 1.0 ///< Résistance d'une case vide dans le circuit d'un joueur (voir #eval_resistance())
+#define RESISTANCE_CASE_AMIE 0.01 ///< Résistance d'une case occupée par un pion du joueur (les pions adverses sont isolants)
+#define RESISTANCE_INFINIE 1e9 ///< Résistance d'un circuit dont les deux frontières sont séparées
+#define PRECISION_RESISTANCE 1e-6 ///< Résidu (relatif) en dessous duquel la résolution du circuit s'arrête
+#define ITERATIONS_MAX_RESISTANCE 500 ///< Nombre maximal d'itérations de la résolution d'un circuit
+#define EVALUATION_MAX_RESISTANCE 99 ///< Valeur absolue maximale renvoyée par #eval_resistance() (une victoire vaut 100)
+
+#define DISTANCE_INFINIE 255 ///< Double distance d'une case qui ne peut plus atteindre la frontière (voir #eval_deux_distances())
+#define POIDS_POTENTIEL 20 ///< Valeur d'un coup d'écart entre les potentiels des deux joueurs
+#define EVALUATION_MAX_DISTANCES 99 ///< Valeur absolue maximale renvoyée par #eval_deux_distances()
+#define NIVEAUX_MAX_DISTANCES 64 ///< Nombre de distances dont l'état de calcul est conservé pour les mises à jour des cartes
+#define CHANGEMENTS_MAX_DISTANCES 8 ///< Nombre de cases modifiées depuis la dernière évaluation au-delà duquel les cartes de distances sont entièrement recalculées
+
 int low(int,int); ///< Renvoie le plus petit des deux entiers passés en paramètre
 int high(int,int); ///< Renvoie le plus grand des deux entiers passés en paramètre
 
 int compte_losanges(plateau *p, int x, int y); ///< Renvoie une valeur indicative sur les bridges formés autour de la case aux coordonnées passées en paramètre
+int losanges_potentiels(const plateau *p, int x, int y, char pion); ///< Renvoie la valeur que #compte_losanges() donnerait à la case aux coordonnées passées en paramètre si le pion \a pion y était posé
 int compte_connexions(plateau *p, int x, int y); ///< Renvoie une valeur indicative sur les connexions directes formées autour de la case aux coordonnées passées en paramètre
 
 int eval_resistance(plateau *p, char pion); ///< Renvoie une valeur indicative d'avantage basée sur la résistance électrique du plateau pour le joueur passé en paramètre
+unsigned long iterations_resistance(void); ///< Renvoie le nombre total d'itérations de résolution de circuit effectuées par #eval_resistance() dans le fil d'exécution appelant
+int eval_deux_distances(plateau *p, char pion); ///< Renvoie une valeur indicative d'avantage basée sur les doubles distances aux frontières des deux joueurs
+unsigned long distances_calculees(void); ///< Renvoie le nombre total de distances (re)calculées par #eval_deux_distances() dans le fil d'exécution appelant
+void active_increment_distances(bool actif); ///< Active ou désactive la mise à jour incrémentale des cartes de #eval_deux_distances() (mesures)
 int eval_losanges(plateau *p, char pion); ///< Renvoie une valeur indicative d'avantage basée sur le nombre total de \a bridges possédés par le joueur passé en paramètre
+int eval_losanges_complete(plateau *p, char pion); ///< Calcule #eval_losanges() sur tout le plateau à la fois (par décalages des bitboards), sans les sommes tenues à jour par #pose_pion()
 int eval_hasard(plateau *p, char pion); ///< Renvoie une valeur aléatoire dans une fourchette fixe (fonction de test, inutilisée en production)
 
 #endif // EVAL_FUNCTIONS_H_INCLUDED
@@ -7,11 +7,54 @@
  *	Artificielle en procédant à une "mise en cache" des plateaux évalués, de manière
  *	à éviter des évaluations répétées d'une même situation (l'ordre dans lequel les coups
  *	sont joués n'ayant pas d'influence sur la "valeur" d'un plateau donné pour un joueur)
+ *	Il contient aussi la table de transposition, qui conserve les résultats des nœuds
+ *	intérieurs de l'AlphaBeta (valeur, nature de la borne, horizon et meilleur coup).
  */
 
 
 #include "hash_table.h"
 
+static void *memoireTransposition = NULL; ///< Bloc alloué pour la table de transposition (non aligné)
+static seau_transposition *tableTransposition = NULL; ///< Table de transposition (alignée sur 64 octets)
+static uint64_t masqueTransposition = 0; ///< Nombre de seaux de la table de transposition, moins un
+static unsigned char ageTransposition = 0; ///< Numéro de la recherche en cours
+static int tailleTransposition = TAILLE_TRANSPOSITION; ///< Budget mémoire de la table de transposition (en Mo)
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	entree Entrée à condenser (la clé est ignorée)
+ *	\return	Mot de données de l'entrée stockée correspondante
+ */
+static inline uint64_t condense_entree(const entree_transposition *entree)
+{
+	return (uint64_t)(unsigned short)entree->valeur
+		| ((uint64_t)entree->profondeur << 16)
+		| ((uint64_t)entree->meilleur_coup << 24)
+		| ((uint64_t)entree->borne << 32)
+		| ((uint64_t)entree->age << 40);
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	donnees Mot de données d'une entrée stockée
+ *	\param	entree Entrée à remplir (hors clé)
+ */
+static inline void developpe_entree(uint64_t donnees, entree_transposition *entree)
+{
+	entree->valeur = (short)(donnees & 0xFFFF);
+	entree->profondeur = (donnees >> 16) & 0xFF;
+	entree->meilleur_coup = (donnees >> 24) & 0xFF;
+	entree->borne = (donnees >> 32) & 0xFF;
+	entree->age = (donnees >> 40) & 0xFF;
+}
+
+/// Clés de "point de vue" des nœuds, indexées par couleur au sommet de l'arbre et nature du nœud (minimisation, maximisation)
+static const uint64_t clesPerspective[2][2] =
+{
+	{0x0000000000000000ULL, 0x6A09E667F3BCC908ULL},
+	{0xBB67AE8584CAA73BULL, 0x3C6EF372FE94F82BULL}
+};
+
 /*!
  *	\author	Julien Laurent
  *	\param	couleur Couleur à convertir
@@ -46,109 +89,91 @@ unsigned short int numeroCouleur(char couleur)
 /*!
  *	\author	Julien Laurent
  *	\param	p Pointeur sur le plateau à hasher
- *	\return	Condensat obtenu lors du hashage du plateau
+ *	\return	Clé de Zobrist du plateau, calculée à partir de zéro
  *
- *	Cette fonction calcule un condensat (hypothétiquement unique,
- *	avec d'infimes chances de collisions) à partir des valeurs
- *	contenues dans le plateau pointé par le paramètre passé, et
- *	le renvoie.
+ *	Le condensat d'un plateau est sa clé de Zobrist (voir zobrist.h), que #pose_pion() tient
+ *	à jour à chaque pose ou retrait de pion: l'IA lit donc directement p->cle, sans parcours
+ *	du plateau. Cette fonction refait le calcul complet, et ne sert qu'à vérifier la clé
+ *	incrémentale (voir collisionTestBed() dans main.c).
  */
-unsigned short int calculeHash(const plateau *p)
+uint64_t calculeHash(const plateau *p)
 {
-	unsigned short int resultat = 0;
-
-	int i,j;
-
-
-/*
- *	Cette fonction de hachage a une répartition relativement mauvaise (beaucoup de collisions...),
- *	mais est, en contrepartie, assez rapide. Le gain est plutôt ressenti dans les parties en mode
- *	"difficile"
- */
-	for (i=0; i < p->dim ; i++)
-	{
-		for(j=0; j < p->dim ; j++)
-		{
-			resultat += 4 + numeroCouleur(p->tab[i][j]) * (unsigned short int)(i + j * p->dim);
-		}
-	}
-
-/*
- *	Cette fonction de hachage a une très bonne répartition, mais consomme beaucoup de ressources.
- */
-
-/*
-	for ( i = 0 ; i < p->dim ; i++ )
-	{
-		for ( j = 0 ; j < p->dim ; j++ )
-		{
-			resultat = 4*resultat + numeroCouleur(p->tab[i][j]);
-		}
-	}
-*/
-
-
-	return resultat;
+	return cle_zobrist(p->pions);
 }
 
 /*!
  *	\author	Julien Laurent
  *	\param	p Pointeur sur le plateau à "évaluer"
  *	\param	pion Couleur du joueur que l'on considère dans l'évaluation
+ *	\param	eval Fonction d'évaluation à utiliser
  *	\return	Valeur correspondant au plateau reçu
  *
  *	Cette fonction vérifie consulte en premier lieu la table de condensats adaptée
  *	à la couleur passée en paramètre, pour voir si la configuration de plateau passée
- *	en paramètre n'a pas déjà été évaluée. Le cas échéant, la valeur stockée dans
+ *	en paramètre n'a pas déjà été évaluée (l'entrée est choisie par les bits de poids faible
+ *	de la clé, et doit contenir la clé complète). Le cas échéant, la valeur stockée dans
  *	l'entrée correspondante de la table est renvoyée.
  *	Dans le cas contraire (absence de valeur dans la table des condensats), la fonction
  *	procède à une évaluation de cette configuration, puis stocke la valeur obtenue dans
  *	une nouvelle entrée de la table des condensats.
+ *	Les tables étant partagées sans verrou entre les fils de recherche, une entrée n'est reconnue
+ *	que si sa clé, "ou-exclusivée" avec sa valeur, redonne la clé du plateau: une entrée en cours
+ *	d'écriture par un autre fil est donc ignorée (et simplement recalculée).
+ *	Les tables servent à toutes les fonctions d'évaluation: la clé du plateau est d'abord mélangée
+ *	avec l'adresse de la fonction, pour qu'une évaluation ne soit jamais prise pour celle d'une autre.
  */
-int hashLosanges(plateau *p, char pion)
+int hashEvaluation(plateau *p, char pion, int (*eval) (plateau *, char))
 {
-	int valeur = 0;
-
-	int condensat = (int)calculeHash(p);
+	volatile entree_condensat *entree;
+	uint64_t cle, cle_plateau = p->cle ^ ((uint64_t)(uintptr_t)eval * 0x9E3779B97F4A7C15ULL);
+	int valeur;
 
 	switch(pion)
 	{
 		case 'N':
-			if(tableNoire[condensat] != -20000)
-			{
-				//printf("Trouve %d indice %d\n", tableNoire[condensat], condensat);
-				return tableNoire[condensat];
-			}
-			else
-			{
-				tableNoire[condensat] = eval_losanges(p,'N');
-				//printf("Sauvegarde valeur %d indice %d\n", tableNoire[condensat], condensat);
-				return (tableNoire[condensat]);
-			}
+			entree = &tableNoire[cle_plateau & (DIM_TABLES-1)];
 		break;
 
 		case 'B':
-			if(tableBlanche[condensat] != -20000)
-			{
-				//printf("Trouve %d indice %d\n", tableBlanche[condensat], condensat);
-				return tableBlanche[condensat];
-			}
-			else
-			{
-				tableBlanche[condensat] = eval_losanges(p,'B');
-				//printf("Sauvegarde valeur %d indice %d\n", tableBlanche[condensat], condensat);
-				return (tableBlanche[condensat]);
-			}
+			entree = &tableBlanche[cle_plateau & (DIM_TABLES-1)];
 		break;
 
 		default:
-
+			return 0;
 		break;
 	}
 
+	cle = entree->cle; // (Lecture unique de chaque champ: un autre fil peut écrire en même temps)
+	valeur = entree->valeur;
+	if(valeur != -20000 && (cle ^ (uint32_t)valeur) == cle_plateau)
+	{
+		//printf("Trouve %d cle %llx\n", valeur, (unsigned long long)p->cle);
+		return valeur;
+	}
+
+	// Entrée vide, ou occupée par un autre plateau (qui est alors remplacé):
+	valeur = eval(p, pion);
+	entree->cle = cle_plateau ^ (uint32_t)valeur;
+	entree->valeur = valeur;
+	//printf("Sauvegarde valeur %d cle %llx\n", valeur, (unsigned long long)p->cle);
 	return valeur;
 }
 
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur le plateau à "évaluer"
+ *	\param	pion Couleur du joueur que l'on considère dans l'évaluation
+ *	\return	Valeur du plateau selon #eval_losanges()
+ *
+ *	Mise en cache des évaluations par les losanges (voir #hashEvaluation()).
+ *	L'AlphaBeta n'en a plus besoin (#eval_losanges() est incrémentale), mais le banc d'essai des
+ *	collisions s'en sert toujours pour éprouver les tables.
+ */
+int hashLosanges(plateau *p, char pion)
+{
+	return hashEvaluation(p, pion, eval_losanges);
+}
+
 /*!
  *	\author	Julien Laurent
  *
@@ -156,18 +181,23 @@ int hashLosanges(plateau *p, char pion)
  *	et place une valeur extrême dans chaque case, de manière à
  *	distinguer les cases "intactes" des cases effectivement remplies
  *	par la fonction hashLosanges().
+ *	La table de transposition est (ré)allouée en même temps.
  */
 void initTables()
 {
 	int i;
 
-	tableNoire = malloc(DIM_TABLES * sizeof(int));
-	tableBlanche = malloc(DIM_TABLES * sizeof(int));
+	initTransposition(tailleTransposition);
+
+	tableNoire = malloc(DIM_TABLES * sizeof(entree_condensat));
+	tableBlanche = malloc(DIM_TABLES * sizeof(entree_condensat));
 
 	for ( i = 0 ; i < DIM_TABLES ; i++ )
 	{
-		tableNoire[i] = -20000;
-		tableBlanche[i] = -20000;
+		tableNoire[i].cle = 0;
+		tableNoire[i].valeur = -20000;
+		tableBlanche[i].cle = 0;
+		tableBlanche[i].valeur = -20000;
 	}
 }
 
@@ -176,9 +206,12 @@ void initTables()
  *
  *	Si les tables de condensats existent en mémoire, cette fonction
  *	les détruit, et met leurs pointeurs respectifs à NULL.
+ *	La table de transposition est détruite en même temps.
  */
 void detruisTables()
 {
+	detruisTransposition();
+
 	if(tableNoire != NULL)
 	{
 		free(tableNoire);
@@ -190,3 +223,189 @@ void detruisTables()
 		tableBlanche = NULL;
 	}
 }
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	megaoctets Budget mémoire de la table de transposition (en Mo)
+ */
+void fixeTailleTransposition(int megaoctets)
+{
+	tailleTransposition = (megaoctets > 0) ? megaoctets : 1;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	megaoctets Budget mémoire de la table de transposition (en Mo)
+ *
+ *	Le nombre de seaux est la plus grande puissance de 2 qui tient dans le budget, pour que le
+ *	seau d'une clé s'obtienne par un simple masque. Le bloc est sur-alloué de 64 octets pour
+ *	pouvoir aligner les seaux sur les lignes de cache.
+ */
+void initTransposition(int megaoctets)
+{
+	uint64_t nb_seaux = 1;
+	uint64_t budget = (uint64_t)((megaoctets > 0) ? megaoctets : 1) * 1024 * 1024;
+
+	detruisTransposition();
+
+	while(nb_seaux * 2 * sizeof(seau_transposition) <= budget)
+	{
+		nb_seaux *= 2;
+	}
+
+	memoireTransposition = calloc(nb_seaux * sizeof(seau_transposition) + 64, 1);
+	if(memoireTransposition == NULL)
+	{
+		return;
+	}
+
+	tableTransposition = (seau_transposition *)(((uintptr_t)memoireTransposition + 63) & ~(uintptr_t)63);
+	masqueTransposition = nb_seaux - 1;
+	ageTransposition = 0;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *
+ *	Si la table de transposition existe en mémoire, cette fonction la détruit.
+ */
+void detruisTransposition()
+{
+	if(memoireTransposition != NULL)
+	{
+		free(memoireTransposition);
+		memoireTransposition = NULL;
+	}
+	tableTransposition = NULL;
+	masqueTransposition = 0;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *
+ *	À appeler au début de chaque recherche: les entrées conservées restent utilisables,
+ *	mais la politique de remplacement leur préfère désormais les entrées plus récentes.
+ */
+void vieillisTransposition()
+{
+	ageTransposition++;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur le plateau du nœud
+ *	\param	pion Couleur du pion au sommet de l'arbre
+ *	\param	maximisation Vrai pour un nœud de maximisation, faux pour un nœud de minimisation
+ *	\return	Clé de transposition du nœud
+ *
+ *	Les valeurs de l'AlphaBeta dépendent du point de vue du joueur au sommet de l'arbre: un même
+ *	plateau reçoit donc une clé différente selon la couleur du joueur qui cherche, et selon qu'il
+ *	s'agit d'un nœud de maximisation ou de minimisation.
+ */
+uint64_t cleTransposition(const plateau *p, char pion, bool maximisation)
+{
+	return p->cle ^ clesPerspective[indice_couleur(pion)][maximisation ? 1 : 0];
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	cle Clé de transposition du nœud
+ *	\param	resultat Pointeur sur l'entrée où recopier le résultat
+ *	\return	Vrai si le nœud est présent dans la table
+ */
+bool sondeTransposition(uint64_t cle, entree_transposition *resultat)
+{
+	int k;
+	volatile entree_stockee *entree;
+	uint64_t verification, donnees;
+
+	if(tableTransposition == NULL)
+	{
+		return false;
+	}
+
+	entree = tableTransposition[cle & masqueTransposition].entrees;
+	for ( k = 0 ; k < ENTREES_PAR_SEAU ; k++ )
+	{
+		donnees = entree[k].donnees;
+		verification = entree[k].verification;
+		if(donnees != 0 && (verification ^ donnees) == cle) // (Une entrée déchirée ne passe pas ce test)
+		{
+			developpe_entree(donnees, resultat);
+			resultat->cle = cle;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	cle Clé de transposition du nœud
+ *	\param	profondeur Horizon de la recherche effectuée (strictement positif)
+ *	\param	borne Nature de la valeur (#BORNE_EXACTE, #BORNE_INFERIEURE ou #BORNE_SUPERIEURE)
+ *	\param	valeur Valeur trouvée
+ *	\param	meilleur_coup Meilleur coup trouvé (case y * dim + x), ou #AUCUN_COUP
+ *
+ *	Politique de remplacement: si le nœud est déjà présent, son entrée est mise à jour, sauf si elle
+ *	provient de la recherche en cours avec un horizon supérieur (elle est alors plus précieuse).
+ *	Sinon, on remplace l'entrée la moins utile du seau: une entrée vide, ou à défaut celle dont
+ *	l'horizon, diminué d'une pénalité proportionnelle à son ancienneté, est le plus faible.
+ *	L'écriture se fait sans verrou (voir #entree_stockee): si deux fils écrivent la même entrée en
+ *	même temps, le mélange éventuel de leurs deux mots sera rejeté à la lecture.
+ */
+void stockeTransposition(uint64_t cle, int profondeur, int borne, int valeur, int meilleur_coup)
+{
+	int k, utilite, utilite_min = 1000000;
+	volatile entree_stockee *entree, *victime = NULL;
+	entree_transposition ancienne, nouvelle;
+	uint64_t donnees;
+
+	if(tableTransposition == NULL)
+	{
+		return;
+	}
+
+	entree = tableTransposition[cle & masqueTransposition].entrees;
+	for ( k = 0 ; k < ENTREES_PAR_SEAU ; k++ )
+	{
+		donnees = entree[k].donnees;
+		developpe_entree(donnees, &ancienne);
+
+		if(donnees != 0 && (entree[k].verification ^ donnees) == cle) // Le nœud est déjà présent
+		{
+			if(ancienne.age == ageTransposition && ancienne.profondeur > profondeur && borne != BORNE_EXACTE)
+			{
+				return;
+			}
+			victime = &entree[k];
+			break;
+		}
+
+		if(donnees == 0) // Entrée vide
+		{
+			utilite = -1000;
+		}
+		else
+		{
+			utilite = ancienne.profondeur - 4 * (unsigned char)(ageTransposition - ancienne.age);
+		}
+
+		if(utilite < utilite_min)
+		{
+			utilite_min = utilite;
+			victime = &entree[k];
+		}
+	}
+
+	nouvelle.valeur = valeur;
+	nouvelle.profondeur = profondeur;
+	nouvelle.meilleur_coup = meilleur_coup;
+	nouvelle.borne = borne;
+	nouvelle.age = ageTransposition;
+	donnees = condense_entree(&nouvelle);
+
+	victime->donnees = donnees;
+	victime->verification = cle ^ donnees;
+}
@@ -7,6 +7,8 @@
  *	Artificielle en procédant à une "mise en cache" des plateaux évalués, de manière
  *	à éviter des évaluations répétées d'une même situation (l'ordre dans lequel les coups
  *	sont joués n'ayant pas d'influence sur la "valeur" d'un plateau donné pour un joueur)
+ *	Il contient aussi la table de transposition, qui conserve les résultats des nœuds
+ *	intérieurs de l'AlphaBeta (valeur, nature de la borne, horizon et meilleur coup).
  */
 
 #ifndef HASH_TABLE_H_INCLUDED
@@ -14,15 +16,94 @@
 
 #include "eval_functions.h"
 
-#define DIM_TABLES 65535 ///< Dimension des tables de condensats
+#define DIM_TABLES 65536 ///< Dimension des tables de condensats (puissance de 2)
+
+/*!
+ *	\brief	Entrée d'une table de condensats
+ *	\author	Julien Laurent
+ *
+ *	La clé complète du plateau évalué est conservée avec la valeur: deux plateaux tombant dans
+ *	la même case de la table ne sont donc plus confondus. Comme dans la table de transposition
+ *	(voir #entree_stockee), la clé est "ou-exclusivée" avec la valeur, pour que les fils de
+ *	recherche puissent partager les tables sans verrou.
+ */
+struct entree_condensat
+{
+	uint64_t cle; ///< Clé de Zobrist du plateau évalué, "ou-exclusivée" avec la valeur
+	int valeur; ///< Évaluation du plateau (-20000 si l'entrée est vide)
+};
+typedef struct entree_condensat entree_condensat; ///< Raccourci d'utilisation du type #entree_condensat
+
+
+#define TAILLE_TRANSPOSITION 16 ///< Budget mémoire par défaut de la table de transposition (en Mo)
+#define ENTREES_PAR_SEAU 4 ///< Nombre d'entrées par seau de la table de transposition (4 x 16 octets = une ligne de cache)
+
+#define BORNE_EXACTE 0 ///< La valeur stockée est la valeur exacte du nœud
+#define BORNE_INFERIEURE 1 ///< La valeur exacte du nœud est supérieure ou égale à la valeur stockée (coupure bêta)
+#define BORNE_SUPERIEURE 2 ///< La valeur exacte du nœud est inférieure ou égale à la valeur stockée (coupure alpha)
+
+#define AUCUN_COUP 255 ///< Valeur du meilleur coup d'une entrée de transposition qui n'en a pas
+
+/*!
+ *	\brief	Entrée de la table de transposition
+ *	\author	Julien Laurent
+ *
+ *	Résultat d'une recherche AlphaBeta sur un nœud intérieur de l'arbre: valeur, nature de cette
+ *	valeur (exacte ou simple borne, selon la fenêtre alpha-bêta de la recherche), horizon de la
+ *	recherche, et meilleur coup trouvé (case y * dim + x), à essayer en premier lors d'une nouvelle
+ *	visite du nœud. C'est la forme décodée d'une #entree_stockee.
+ */
+struct entree_transposition
+{
+	uint64_t cle; ///< Clé du nœud (clé de Zobrist du plateau, combinée au point de vue de la recherche)
+	short valeur; ///< Valeur du nœud (ou borne de cette valeur)
+	unsigned char profondeur; ///< Horizon de la recherche ayant produit l'entrée (0 pour une entrée vide)
+	unsigned char meilleur_coup; ///< Meilleur coup trouvé (ou #AUCUN_COUP)
+	unsigned char borne; ///< Nature de la valeur (#BORNE_EXACTE, #BORNE_INFERIEURE ou #BORNE_SUPERIEURE)
+	unsigned char age; ///< Numéro de la recherche ayant produit l'entrée
+};
+typedef struct entree_transposition entree_transposition; ///< Raccourci d'utilisation du type #entree_transposition
+
+/*!
+ *	\brief	Entrée de la table de transposition, telle qu'elle est stockée
+ *	\author	Julien Laurent
+ *
+ *	Les champs d'une #entree_transposition (hors clé) sont regroupés dans un seul mot de 64 bits,
+ *	et la clé n'est pas stockée telle quelle, mais "ou-exclusivée" avec ce mot. Les fils de recherche
+ *	lisent et écrivent la table sans verrou: si une lecture croise une écriture concurrente, les deux
+ *	mots lus ne correspondent pas, et la clé reconstituée ne correspond plus au nœud cherché.
+ *	L'entrée déchirée est alors simplement ignorée.
+ */
+struct entree_stockee
+{
+	uint64_t verification; ///< Clé du nœud, "ou-exclusivée" avec le mot de données
+	uint64_t donnees; ///< Valeur, horizon, meilleur coup, nature de la borne et âge de l'entrée
+};
+typedef struct entree_stockee entree_stockee; ///< Raccourci d'utilisation du type #entree_stockee
+
+/*!
+ *	\brief	Seau de la table de transposition
+ *	\author	Julien Laurent
+ *
+ *	Les entrées sont regroupées par seaux de la taille d'une ligne de cache (64 octets), alignés en
+ *	mémoire: la consultation d'un nœud ne coûte donc qu'un seul défaut de cache.
+ */
+struct seau_transposition
+{
+	entree_stockee entrees[ENTREES_PAR_SEAU]; ///< Entrées du seau
+};
+typedef struct seau_transposition seau_transposition; ///< Raccourci d'utilisation du type #seau_transposition
 
 /// Convertit une couleur de pion en entier court non-signé (pour le hachage)
 unsigned short int numeroCouleur(char couleur);
 
-/// Renvoie un entier court non-signé correspondant au condensat du plateau passé en paramètre
-unsigned short int calculeHash(const plateau *p);
+/// Recalcule entièrement la clé de Zobrist du plateau passé en paramètre (pour vérifier la clé incrémentale)
+uint64_t calculeHash(const plateau *p);
 
-/// Fonction de "mise en cache" (écriture et lecture des tables de condensats pour les évaluations)
+/// Fonction de "mise en cache" (écriture et lecture des tables de condensats pour les évaluations de la fonction passée en paramètre)
+int hashEvaluation(plateau *p, char pion, int (*eval) (plateau *, char));
+
+/// Fonction de "mise en cache" des évaluations par #eval_losanges()
 int hashLosanges(plateau *p, char pion);
 
 /// Fonction d'initialisation des tables de condensats
@@ -31,10 +112,31 @@ void initTables();
 /// Fonction de destruction (et remise à NULL) des tables de condensats
 void detruisTables();
 
+/// Fixe le budget mémoire (en Mo) de la table de transposition, pris en compte au prochain appel d'#initTables()
+void fixeTailleTransposition(int megaoctets);
+
+/// Alloue la table de transposition (vide) dans la limite du budget mémoire passé en paramètre (en Mo)
+void initTransposition(int megaoctets);
+
+/// Détruit la table de transposition
+void detruisTransposition();
+
+/// Signale le début d'une nouvelle recherche (les entrées des recherches précédentes deviennent remplaçables)
+void vieillisTransposition();
+
+/// Renvoie la clé de transposition d'un nœud (plateau, couleur au sommet de l'arbre, et nature du nœud)
+uint64_t cleTransposition(const plateau *p, char pion, bool maximisation);
+
+/// Cherche le nœud de clé donnée dans la table de transposition, et en copie l'entrée si elle existe
+bool sondeTransposition(uint64_t cle, entree_transposition *resultat);
+
+/// Enregistre le résultat de la recherche d'un nœud dans la table de transposition
+void stockeTransposition(uint64_t cle, int profondeur, int borne, int valeur, int meilleur_coup);
+
 /// Table de condensats pour le joueur noir
-int *tableNoire;
+entree_condensat *tableNoire;
 
 /// Table de condensats pour le joueur blanc
-int *tableBlanche;
+entree_condensat *tableBlanche;
 
 #endif // HASH_TABLE_H_INCLUDED
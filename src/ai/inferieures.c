@@ -0,0 +1,198 @@
+/*!
+ *	\file	inferieures.c
+ *	\brief	Analyse des cases inférieures
+ *	\author	Julien Laurent
+ *
+ *	Ce fichier contient la détection des cases mortes, capturées et dominées (voir inferieures.h).
+ *	Les six voisines d'une case y sont toujours parcourues dans le même ordre circulaire (haut,
+ *	haut-droite, droite, bas, bas-gauche, gauche): deux voisines consécutives sont donc voisines
+ *	entre elles, et la voisine d'indice d+3 (modulo 6) est opposée à celle d'indice d.
+ *	Le contenu de ces six voisines est codé en base 3 (0: vide, 1: noir, 2: blanc), les frontières
+ *	comptant comme des pions de leur couleur. Les anneaux qui rendent morte la case qu'ils entourent
+ *	sont donnés par la table #motifs_morts, générée avec le logiciel (voir motifs.h), et la
+ *	contribution des frontières à l'anneau de chaque case par la topologie du plateau (topologie.h).
+ */
+
+#include "inferieures.h"
+
+static const int puissances[6] = {1, 3, 9, 27, 81, 243}; ///< Poids de chaque voisine dans le code d'un anneau
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur le plateau analysé
+ *	\param	remplies Pions de chaque couleur (réels et fictifs)
+ *	\param	couleur Indice de la couleur
+ *	\return	Vrai si les pions donnés de la couleur relient ses deux frontières
+ */
+static bool frontieres_reliees(const plateau *p, const bitboard remplies[2], int couleur)
+{
+	bitboard atteintes = bb_nul(), suivantes = bb_et(remplies[couleur], p->bords[2*couleur]);
+
+	while(!bb_egal(atteintes, suivantes))
+	{
+		atteintes = suivantes;
+		suivantes = bb_et(bb_ou(atteintes, voisinage(p, atteintes)), remplies[couleur]);
+	}
+
+	return !bb_est_nul(bb_et(atteintes, p->bords[2*couleur+1]));
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	remplies Pions de chaque couleur (réels et fictifs), à compléter
+ *	\param	vides Cases encore vides, à mettre à jour
+ *	\param	codes Code de l'anneau de chaque case vide, à mettre à jour
+ *	\param	voisins Indices des six voisines de la case
+ *	\param	k Indice de la case à remplir
+ *	\param	couleur Indice de la couleur du pion fictif
+ */
+static void remplit_case(bitboard remplies[2], bitboard *vides, int codes[], const short voisins[6], int k, int couleur)
+{
+	int d;
+
+	bb_place(&remplies[couleur], k);
+	bb_retire(vides, k);
+	for ( d = 0 ; d < 6 ; d++ ) // La case est la voisine opposée de chacune de ses voisines
+	{
+		codes[voisins[d]] += (couleur + 1) * puissances[(d+3) % 6];
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur le plateau à analyser
+ *	\param	joueur Couleur du joueur qui a le trait
+ *	\param	gagnant Pointeur sur l'indice de la couleur assurée de gagner (-1 si aucune)
+ *	\return	Cases vides que le joueur n'a pas besoin de jouer
+ *
+ *	Les cases mortes sont remplies (par la couleur du joueur, la couleur importe peu), ainsi que
+ *	les paires capturées (par la couleur qui les capture): une paire de cases voisines est capturée
+ *	par une couleur si chacune devient morte dès que l'autre est de cette couleur. Ces remplissages
+ *	ne changent pas l'issue de la partie, et sont répétés tant qu'ils révèlent de nouvelles cases
+ *	mortes ou capturées. Si l'une des couleurs relie alors ses frontières, elle est assurée de
+ *	gagner.
+ *	Parmi les cases restantes, une case que le joueur rendrait morte (ou capturerait, avec sa
+ *	voisine) en jouant une case voisine est dominée par cette dernière: elle est écartée, à moins
+ *	que la case voisine ne l'ait déjà été elle-même, si bien qu'il reste toujours au moins un coup.
+ *	Les deux coins aigus, dont l'anneau n'est pas défini, ne sont jamais écartés.
+ */
+bitboard cases_inferieures(const plateau *p, char joueur, int *gagnant)
+{
+	const topologie *topo = p->topo;
+	int codes[BITS_BITBOARD];
+	int couleur = indice_couleur(joueur), c, d, k, v, w, code_v, code_w, code_paire;
+	bitboard remplies[2] = {p->pions[0], p->pions[1]};
+	bitboard vides = cases_vides(p), candidates, parcours, dominees = bb_nul();
+	bool remplissage = true;
+
+	*gagnant = -1;
+	parcours = vides;
+	while((k = bb_extrait(&parcours)) >= 0)
+	{
+		codes[k] = topo->codes_bords[k];
+		for ( d = 0 ; d < 6 ; d++ )
+		{
+			if(bb_teste(&remplies[0], topo->voisins[k][d]))
+			{
+				codes[k] += puissances[d];
+			}
+			else if(bb_teste(&remplies[1], topo->voisins[k][d]))
+			{
+				codes[k] += 2 * puissances[d];
+			}
+		}
+	}
+
+	while(remplissage) // Remplissage des cases mortes et des paires capturées
+	{
+		remplissage = false;
+		parcours = bb_et(vides, topo->analysables);
+		while((k = bb_extrait(&parcours)) >= 0)
+		{
+			if(!bb_teste(&vides, k)) // (Remplie entre-temps avec une paire)
+			{
+				continue;
+			}
+			else if(motifs_morts[codes[k]])
+			{
+				remplit_case(remplies, &vides, codes, topo->voisins[k], k, couleur);
+				remplissage = true;
+				continue;
+			}
+
+			for ( d = 0 ; d < 3 ; d++ ) // (Chaque paire n'est examinée qu'à partir d'une de ses cases)
+			{
+				v = topo->voisins[k][d];
+				if(!bb_teste(&vides, v) || !bb_teste(&topo->analysables, v))
+				{
+					continue;
+				}
+				for ( c = 0 ; c < 2 ; c++ )
+				{
+					if(motifs_morts[codes[k] + (c+1) * puissances[d]] && motifs_morts[codes[v] + (c+1) * puissances[d+3]])
+					{
+						remplit_case(remplies, &vides, codes, topo->voisins[k], k, c);
+						remplit_case(remplies, &vides, codes, topo->voisins[v], v, c);
+						remplissage = true;
+						break;
+					}
+				}
+				if(!bb_teste(&vides, k))
+				{
+					break;
+				}
+			}
+		}
+	}
+
+	for ( c = 0 ; c < 2 ; c++ )
+	{
+		if(frontieres_reliees(p, remplies, c))
+		{
+			*gagnant = c;
+			return bb_nul();
+		}
+	}
+
+	// Cases dominées: v (et sa voisine w) deviennent mortes (ou capturées) si le joueur joue k
+	candidates = bb_et(vides, topo->analysables);
+	parcours = vides;
+	while((k = bb_extrait(&parcours)) >= 0)
+	{
+		if(bb_teste(&dominees, k))
+		{
+			continue;
+		}
+		for ( d = 0 ; d < 6 ; d++ )
+		{
+			v = topo->voisins[k][d];
+			if(!bb_teste(&candidates, v))
+			{
+				continue;
+			}
+			code_v = codes[v] + (couleur+1) * puissances[(d+3) % 6];
+			if(motifs_morts[code_v])
+			{
+				bb_place(&dominees, v);
+				bb_retire(&candidates, v);
+				continue;
+			}
+
+			w = topo->voisins[k][(d+1) % 6]; // Voisine suivante de k, voisine de v dans la direction d+2
+			if(bb_teste(&candidates, w))
+			{
+				code_paire = (couleur+1) * puissances[(d+2) % 6];
+				code_w = codes[w] + (couleur+1) * puissances[(d+4) % 6] + (couleur+1) * puissances[(d+5) % 6];
+				if(motifs_morts[code_v + code_paire] && motifs_morts[code_w])
+				{
+					bb_place(&dominees, v);
+					bb_place(&dominees, w);
+					bb_retire(&candidates, v);
+					bb_retire(&candidates, w);
+				}
+			}
+		}
+	}
+
+	return bb_ou(bb_sauf(cases_vides(p), vides), dominees);
+}
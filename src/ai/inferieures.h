@@ -0,0 +1,27 @@
+/*!
+ *	\file	inferieures.h
+ *	\brief	Prototypes de l'analyse des cases inférieures
+ *	\author	Julien Laurent
+ *
+ *	Ce fichier contient les déclarations de l'analyse locale des cases vides, qui écarte de la
+ *	génération des coups de l'AlphaBeta les cases dont l'occupation ne peut rien changer à l'issue
+ *	de la partie:
+ *	- les cases mortes, dont la couleur finale n'a aucune influence sur le gagnant;
+ *	- les paires capturées, qu'une couleur est assurée d'obtenir (elle répond dans l'une à tout
+ *	  coup adverse dans l'autre, qui devient alors morte);
+ *	- les cases dominées, dont un coup voisin du même joueur tue ou capture la case (jouer ce
+ *	  coup voisin vaut alors au moins autant).
+ *	Les cases mortes et capturées sont remplies (fictivement), ce qui révèle parfois de nouvelles
+ *	cases inférieures, jusqu'à ce qu'il n'y en ait plus. Chaque case n'est jugée que d'après ses six
+ *	voisines, à l'aide d'une table de motifs générée une fois pour toutes (voir motifs.h).
+ */
+
+#ifndef INFERIEURES_H_INCLUDED
+#define INFERIEURES_H_INCLUDED
+
+#include "../model/data_models.h"
+
+/// Renvoie les cases vides que le joueur donné n'a pas besoin de jouer, et indique (par \a gagnant) la couleur déjà assurée de gagner d'après le remplissage (-1 si aucune)
+bitboard cases_inferieures(const plateau *p, char joueur, int *gagnant);
+
+#endif // INFERIEURES_H_INCLUDED
@@ -0,0 +1,573 @@
+/*!
+ *	\file	mcts.c
+ *	\brief	Fonctions de l'IA Monte-Carlo ("Roulette")
+ *	\author	Julien Laurent
+ *
+ *	Ce fichier contient la recherche arborescente Monte-Carlo: sélection des coups par la formule
+ *	UCT corrigée par les statistiques AMAF (RAVE), développement des feuilles, simulations aléatoires
+ *	jusqu'à la fin de la partie, et remontée des résultats.
+ *	Tous les fils d'exécution descendent dans le même arbre. Les compteurs des nœuds sont modifiés
+ *	par des opérations atomiques, et chaque fil compte provisoirement des défaites fictives
+ *	(#PERTE_VIRTUELLE) dans les nœuds qu'il traverse, pour que les autres fils préfèrent d'autres
+ *	branches tant que sa simulation n'est pas terminée. Un nœud est développé par un seul fil, qui
+ *	le réserve puis publie ses fils par des échanges atomiques (compare-and-swap).
+ *	Les fils d'un nœud sont toujours placés après lui dans la réserve: c'est ce qui permet de
+ *	compacter l'arbre en un seul parcours quand un sous-arbre devient la nouvelle racine.
+ */
+
+#include <math.h>
+#include <SDL_timer.h>
+#include <SDL_thread.h>
+
+#include "mcts.h"
+#include "resolues.h"
+#include "ouvertures.h"
+
+static noeud_mcts *reserve = NULL; ///< Réserve des nœuds de l'arbre (la racine est le nœud 0)
+static int *renumerotation = NULL; ///< Nouvel indice de chaque nœud conservé lors du compactage de l'arbre (-1 pour les autres)
+static int capacite = 0; ///< Nombre de nœuds de la réserve
+static volatile int nb_noeuds = 0; ///< Nombre de nœuds utilisés dans la réserve
+
+static bool reutilisation_active = true; ///< Vrai si l'arbre est réutilisé d'un coup à l'autre (voir #prepare_arbre())
+static bool arbre_conserve = false; ///< Vrai si la réserve contient l'arbre de la dernière recherche
+static bitboard pions_racine[2]; ///< Pions de la position à la racine de la dernière recherche
+static int largeur_racine = 0; ///< Largeur des #bitboard du plateau de la dernière recherche
+static char pion_racine = 'V'; ///< Couleur du joueur qui avait le trait à la racine de la dernière recherche
+static unsigned long nb_reutilisees = 0; ///< Nombre de simulations héritées par la racine de la dernière recherche
+
+static unsigned int duree_imposee = 0; ///< Temps de réflexion imposé par #fixe_budget_monte_carlo() (0 si aucun)
+static unsigned long simulations_imposees = 0; ///< Nombre de simulations imposé par #fixe_budget_monte_carlo() (0 si aucun)
+static volatile unsigned long nb_simulations = 0; ///< Nombre de simulations jouées lors de la dernière recherche
+static volatile bool arret_simulations = false; ///< Passe à vrai quand le budget de la recherche en cours est épuisé
+
+/*!
+ *	\brief	Paramètres d'un fil de la recherche Monte-Carlo
+ *	\author	Julien Laurent
+ */
+struct fil_mcts
+{
+	const plateau *p; ///< Plateau à la racine (que chaque fil recopie)
+	char pion; ///< Couleur du pion joué par l'IA
+	unsigned int debut; ///< Début de la recherche (en ms)
+	unsigned int duree_max; ///< Temps de réflexion (en ms, 0 si illimité)
+	unsigned long simulations_max; ///< Nombre de simulations (0 si illimité)
+	generateur alea; ///< Générateur pseudo-aléatoire propre au fil
+};
+typedef struct fil_mcts fil_mcts; ///< Raccourci d'utilisation du type #fil_mcts
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	duree_max Temps de réflexion (en ms, 0 si illimité)
+ *	\param	simulations_max Nombre de simulations (0 si illimité)
+ *
+ *	Comme pour #fixe_budget_recherche(), un budget fixe permet des mesures reproductibles. L'appel
+ *	avec (0, 0) rétablit le temps de réflexion par niveau (voir #duree_reflexion()).
+ */
+void fixe_budget_monte_carlo(unsigned int duree_max, unsigned long simulations_max)
+{
+	duree_imposee = duree_max;
+	simulations_imposees = simulations_max;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\return	Nombre de simulations jouées lors de la dernière recherche
+ */
+unsigned long simulations_monte_carlo(void)
+{
+	return nb_simulations;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\return	Nombre de simulations de la racine de la dernière recherche qui avaient été jouées lors de la recherche précédente
+ */
+unsigned long simulations_reutilisees(void)
+{
+	return nb_reutilisees;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	actif Vrai pour réutiliser l'arbre d'un coup à l'autre (par défaut), faux pour repartir d'un arbre vide
+ *
+ *	Ne sert qu'à mesurer l'apport de la réutilisation (voir reutilisationTestBed() dans main.c).
+ */
+void active_reutilisation_arbre(bool actif)
+{
+	reutilisation_active = actif;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	n Nœud à initialiser
+ *	\param	coup Case jouée pour atteindre le nœud
+ */
+static void initialise_noeud(noeud_mcts *n, int coup)
+{
+	n->fils = AUCUN_FILS;
+	n->nb_fils = 0;
+	n->coup = coup;
+	n->visites = 0;
+	n->victoires = 0;
+	n->visites_amaf = 0;
+	n->victoires_amaf = 0;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Plateau de la nouvelle recherche
+ *	\param	pion Couleur du joueur qui a le trait
+ *	\return	Indice du nœud de la position dans l'arbre de la recherche précédente, ou -1 s'il n'y figure pas
+ *
+ *	La position est cherchée jusqu'à deux coups sous l'ancienne racine: le coup joué depuis
+ *	l'ancienne racine (par le joueur qui y avait le trait), puis éventuellement la réponse de
+ *	l'adversaire. C'est le cas de l'IA qui rejoue après la réponse de l'adversaire, mais aussi celui
+ *	de deux IA Monte-Carlo qui s'affrontent, chacune héritant de l'arbre de l'autre.
+ */
+static int cherche_position(const plateau *p, char pion)
+{
+	bitboard nouveaux[2];
+	int c, f, k, n = 0, nb_nouveaux[2];
+	char joueur = pion_racine;
+
+	if(!arbre_conserve || p->largeur != largeur_racine || reserve[0].fils < 0)
+	{
+		return -1;
+	}
+
+	for ( c = 0 ; c < 2 ; c++ )
+	{
+		if(!bb_est_nul(bb_sauf(pions_racine[c], p->pions[c]))) // Un pion de l'ancienne racine a disparu
+		{
+			return -1;
+		}
+		nouveaux[c] = bb_sauf(p->pions[c], pions_racine[c]);
+		nb_nouveaux[c] = bb_compte(nouveaux[c]);
+	}
+
+	if(nb_nouveaux[indice_couleur(pion_racine)] != (nb_nouveaux[0] + nb_nouveaux[1] + 1) / 2 || nb_nouveaux[0] + nb_nouveaux[1] > 2
+		|| joueur != ((nb_nouveaux[0] + nb_nouveaux[1] == 1) ? couleur_opposee(pion) : pion))
+	{
+		return -1;
+	}
+
+	while(!bb_est_nul(nouveaux[indice_couleur(joueur)])) // Descente le long des coups joués, dans l'ordre
+	{
+		k = bb_extrait(&nouveaux[indice_couleur(joueur)]);
+		if(reserve[n].fils < 0)
+		{
+			return -1;
+		}
+		for ( f = reserve[n].fils ; f < reserve[n].fils + reserve[n].nb_fils && reserve[f].coup != k ; f++ );
+		if(f == reserve[n].fils + reserve[n].nb_fils)
+		{
+			return -1;
+		}
+		n = f;
+		joueur = couleur_opposee(joueur);
+	}
+
+	return n;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	racine Indice du nœud qui devient la racine
+ *
+ *	Les nœuds du sous-arbre sont marqués en un seul parcours de la réserve (un nœud est marqué si
+ *	son père l'est, et le père est toujours placé avant ses fils), puis renumérotés dans l'ordre et
+ *	recopiés vers le début de la réserve. Le nouvel indice d'un nœud ne dépasse jamais l'ancien: la
+ *	recopie peut donc se faire sur place, et les blocs de fils restent consécutifs.
+ */
+static void promeut_sous_arbre(int racine)
+{
+	int i, f, n = 0, fin = (nb_noeuds < capacite) ? nb_noeuds : capacite;
+
+	for ( i = 0 ; i < fin ; i++ )
+	{
+		renumerotation[i] = (i == racine) ? 0 : -1;
+	}
+	for ( i = racine ; i < fin ; i++ ) // Marquage
+	{
+		if(renumerotation[i] == 0 && reserve[i].fils >= 0)
+		{
+			for ( f = 0 ; f < reserve[i].nb_fils ; f++ )
+			{
+				renumerotation[reserve[i].fils + f] = 0;
+			}
+		}
+	}
+	for ( i = racine ; i < fin ; i++ ) // Renumérotation et recopie
+	{
+		if(renumerotation[i] == 0)
+		{
+			renumerotation[i] = n;
+			reserve[n] = reserve[i];
+			n++;
+		}
+	}
+	for ( i = 0 ; i < n ; i++ )
+	{
+		if(reserve[i].fils >= 0)
+		{
+			reserve[i].fils = renumerotation[reserve[i].fils];
+		}
+	}
+
+	nb_noeuds = n;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Plateau de la nouvelle recherche
+ *	\param	pion Couleur du pion joué par l'IA
+ *	\return	Vrai si l'arbre est prêt, faux si la réserve de nœuds n'a pas pu être allouée
+ *
+ *	La réserve est allouée lors de la première recherche, puis conservée. Si la position figure dans
+ *	l'arbre de la recherche précédente (voir #cherche_position()), son sous-arbre devient la racine;
+ *	sinon, la recherche repart d'un arbre réduit à sa racine.
+ */
+static bool prepare_arbre(const plateau *p, char pion)
+{
+	int racine = -1;
+
+	if(reserve == NULL)
+	{
+		capacite = (TAILLE_MCTS << 20) / (sizeof(noeud_mcts) + sizeof(int));
+		reserve = malloc(capacite * sizeof(noeud_mcts));
+		renumerotation = malloc(capacite * sizeof(int));
+		if(reserve == NULL || renumerotation == NULL)
+		{
+			free(reserve);
+			free(renumerotation);
+			reserve = NULL;
+			renumerotation = NULL;
+			capacite = 0;
+			return false;
+		}
+	}
+
+	if(reutilisation_active)
+	{
+		racine = cherche_position(p, pion);
+	}
+	if(racine >= 0)
+	{
+		promeut_sous_arbre(racine);
+	}
+	else
+	{
+		initialise_noeud(&reserve[0], 0);
+		nb_noeuds = 1;
+	}
+
+	nb_reutilisees = reserve[0].visites;
+	arbre_conserve = true;
+	pions_racine[0] = p->pions[0];
+	pions_racine[1] = p->pions[1];
+	largeur_racine = p->largeur;
+	pion_racine = pion;
+	return true;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	n Nœud à développer
+ *	\param	p Plateau correspondant au nœud
+ *
+ *	Crée un fils par case vide, dans un bloc de nœuds réservé atomiquement à la suite de ceux déjà
+ *	utilisés. Le fil qui développe le nœud le marque d'abord comme #EN_DEVELOPPEMENT (les autres
+ *	fils le traitent alors comme une feuille), puis publie le bloc une fois ses fils initialisés.
+ *	S'il n'y a aucun coup à jouer ou plus de place dans la réserve, le nœud reste une feuille.
+ */
+static void developpe(noeud_mcts *n, const plateau *p)
+{
+	bitboard vides = cases_vides(p);
+	int k, f, debut, nb = bb_compte(vides);
+
+	if(nb == 0 || nb_noeuds + nb > capacite || !__sync_bool_compare_and_swap(&n->fils, AUCUN_FILS, EN_DEVELOPPEMENT))
+	{
+		return;
+	}
+
+	debut = __sync_fetch_and_add(&nb_noeuds, nb);
+	if(debut + nb > capacite) // (Un autre fil a pris la dernière place entre-temps)
+	{
+		n->fils = AUCUN_FILS;
+		return;
+	}
+
+	for ( f = debut ; (k = bb_extrait(&vides)) >= 0 ; f++ )
+	{
+		initialise_noeud(&reserve[f], k);
+	}
+	n->nb_fils = nb;
+	__sync_bool_compare_and_swap(&n->fils, EN_DEVELOPPEMENT, debut); // (Barrière: les fils sont visibles avant le bloc)
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	n Nœud (développé) dont on choisit un fils
+ *	\return	Fils à explorer
+ *
+ *	Chaque fils est noté par son taux de victoires, mélangé à son taux de victoires AMAF avec un poids
+ *	qui décroît à mesure que le fils est visité (de 1 pour un fils jamais visité, à 1/2 environ au bout
+ *	de #EQUIVALENCE_RAVE visites), et augmenté du terme d'exploration d'UCT. Un fils qui n'a aucune
+ *	statistique AMAF est crédité d'un taux neutre de 1/2. Les pertes virtuelles des simulations en
+ *	cours dans d'autres fils d'exécution font baisser le taux de victoires des nœuds concernés.
+ */
+static noeud_mcts *selectionne(const noeud_mcts *n)
+{
+	int f, premier = n->fils;
+	double q, amaf, beta, score, meilleur_score = -1.0;
+	double log_visites = log(n->visites + 1);
+	noeud_mcts *fils, *meilleur = &reserve[premier];
+
+	for ( f = 0 ; f < n->nb_fils ; f++ )
+	{
+		fils = &reserve[premier + f];
+
+		amaf = (fils->visites_amaf > 0) ? (double)fils->victoires_amaf / fils->visites_amaf : 0.5;
+		if(fils->visites > 0)
+		{
+			q = (double)fils->victoires / fils->visites;
+			beta = sqrt(EQUIVALENCE_RAVE / (3.0 * fils->visites + EQUIVALENCE_RAVE));
+		}
+		else
+		{
+			q = 0.0;
+			beta = 1.0;
+		}
+
+		score = (1.0 - beta) * q + beta * amaf + EXPLORATION_UCT * sqrt(log_visites / (fils->visites + 1));
+		if(score > meilleur_score)
+		{
+			meilleur_score = score;
+			meilleur = fils;
+		}
+	}
+
+	return meilleur;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	n Nœud traversé
+ *	\param	couleur Joueur du coup menant au nœud
+ *	\param	vainqueur Vainqueur de la simulation
+ *
+ *	Remplace la perte virtuelle comptée lors de la descente par le résultat de la simulation.
+ */
+static inline void compte_resultat(noeud_mcts *n, char couleur, char vainqueur)
+{
+	__sync_fetch_and_sub(&n->visites, PERTE_VIRTUELLE - 1);
+	if(vainqueur == couleur)
+	{
+		__sync_fetch_and_add(&n->victoires, 1);
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Plateau à la racine de l'arbre (rendu dans son état initial)
+ *	\param	pion Couleur du pion joué par l'IA (qui joue à la racine)
+ *	\param	alea Générateur du fil
+ *
+ *	Joue une simulation: descente dans l'arbre par #selectionne(), développement de la feuille
+ *	atteinte si elle a été assez visitée, fin de partie au hasard (voir #partie_aleatoire()), puis
+ *	mise à jour des statistiques des nœuds traversés et des statistiques AMAF de leurs fils.
+ *	Le nœud de profondeur i a été joué par l'IA si i est impair, par l'adversaire sinon (la racine
+ *	comprise).
+ */
+static void simule(plateau *p, char pion, generateur *alea)
+{
+	noeud_mcts *chemin[DIM_MAX*DIM_MAX+1];
+	noeud_mcts *n = &reserve[0], *fils;
+	int i, f, premier, profondeur = 0, base = p->nb_coups;
+	char joueur = pion, vainqueur = 'V', couleur;
+	bitboard finals[2], *occupees = p->pions; // Pions en fin de partie
+
+	__sync_fetch_and_add(&n->visites, PERTE_VIRTUELLE);
+	chemin[profondeur++] = n;
+	while(vainqueur == 'V' && n->fils >= 0)
+	{
+		n = selectionne(n);
+		__sync_fetch_and_add(&n->visites, PERTE_VIRTUELLE);
+		joue_coup(p, n->coup % p->largeur, n->coup / p->largeur - 2, joueur);
+		joueur = couleur_opposee(joueur);
+		chemin[profondeur++] = n;
+
+		vainqueur = gagnant(p);
+		// Simulations terminées (ou en cours dans d'autres fils): la perte virtuelle du fil n'y compte pas
+		if(vainqueur == 'V' && n->fils == AUCUN_FILS && n->visites - PERTE_VIRTUELLE >= SEUIL_EXPANSION)
+		{
+			developpe(n, p); // (En cas de succès, la descente continue vers l'un des nouveaux fils)
+		}
+	}
+
+	if(vainqueur == 'V')
+	{
+		vainqueur = partie_aleatoire(p, joueur, alea, finals);
+		occupees = finals;
+	}
+
+	for ( i = 0 ; i < profondeur ; i++ )
+	{
+		n = chemin[i];
+		couleur = (i % 2) ? pion : couleur_opposee(pion); // Joueur du coup menant au nœud
+		compte_resultat(n, couleur, vainqueur);
+
+		// Les fils sont joués par l'autre joueur: leurs cases occupées par ce joueur en fin de
+		// partie l'ont forcément été après le nœud (elles y étaient vides)
+		couleur = couleur_opposee(couleur);
+		premier = n->fils;
+		for ( f = 0 ; premier >= 0 && f < n->nb_fils ; f++ )
+		{
+			fils = &reserve[premier + f];
+			if(bb_teste(&occupees[indice_couleur(couleur)], fils->coup))
+			{
+				__sync_fetch_and_add(&fils->visites_amaf, 1);
+				if(vainqueur == couleur)
+				{
+					__sync_fetch_and_add(&fils->victoires_amaf, 1);
+				}
+			}
+		}
+	}
+
+	while(p->nb_coups > base)
+	{
+		dejoue_coup(p);
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	donnees Pointeur sur le #fil_mcts décrivant le travail du fil
+ *	\return	0
+ *
+ *	Fonction exécutée par chaque fil de la recherche: joue des simulations sur sa propre copie du
+ *	plateau jusqu'à épuisement du budget. Le compteur partagé de simulations n'est mis à jour (et
+ *	l'horloge consultée) que toutes les #INTERVALLE_SIMULATIONS simulations, ou après chaque
+ *	simulation si le budget est un nombre de simulations.
+ */
+static int cherche_monte_carlo(void *donnees)
+{
+	fil_mcts *fil = donnees;
+	plateau p = *fil->p; // Copie de travail propre au fil
+	unsigned long total;
+	int n = 0;
+
+	while(!arret_simulations)
+	{
+		simule(&p, fil->pion, &fil->alea);
+
+		if(++n == INTERVALLE_SIMULATIONS || fil->simulations_max > 0)
+		{
+			total = __sync_add_and_fetch(&nb_simulations, n);
+			n = 0;
+			if(fil->simulations_max > 0 && total >= fil->simulations_max)
+			{
+				arret_simulations = true;
+			}
+			else if(fil->duree_max > 0 && SDL_GetTicks() - fil->debut >= fil->duree_max)
+			{
+				arret_simulations = true;
+			}
+		}
+	}
+	__sync_add_and_fetch(&nb_simulations, n);
+
+	return 0;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Copie du plateau sur lequel l'IA doit jouer
+ *	\param	pion Couleur du pion joué par l'IA
+ *	\param	level Niveau de l'IA, qui détermine son temps de réflexion (voir #duree_reflexion())
+ *	\return	Coordonnées à jouer (le coup le plus simulé)
+ *
+ *	Cette Intelligence Artificielle ("Roulette" dans les menus) joue autant de simulations que son
+ *	temps de réflexion le permet, puis renvoie le coup de la racine qui a été le plus simulé (plus
+ *	robuste que celui du meilleur taux de victoires, qui peut ne reposer que sur peu de simulations).
+ *	Les simulations sont réparties entre #compte_fils() fils d'exécution (voir #fixe_nombre_fils()).
+ *	Une position gagnée des tables de positions résolues (voir resolues.h), ou une position du livre
+ *	d'ouvertures (voir ouvertures.h), est jouée sans simulation.
+ */
+coord ia_monte_carlo(plateau p, char pion, int level)
+{
+	coord a_renvoyer = ia_hasard(p, pion, level);
+	SDL_Thread *fils[NB_FILS_MAX];
+	fil_mcts parametres[NB_FILS_MAX];
+	noeud_mcts *racine, *meilleur;
+	int f, nb_lances, nb_fils = compte_fils();
+	unsigned int debut = SDL_GetTicks();
+
+	p.tab = NULL; // La recherche ne doit pas toucher à la matrice du plateau affiché
+	nb_simulations = 0;
+	arret_simulations = false;
+
+	if(coup_table_resolue(&p, pion, &a_renvoyer) || coup_livre_ouvertures(&p, pion, &a_renvoyer)) // Coup connu sans simulation
+	{
+		return a_renvoyer;
+	}
+	if(!prepare_arbre(&p, pion))
+	{
+		return a_renvoyer;
+	}
+	racine = &reserve[0];
+	developpe(racine, &p);
+	if(racine->fils < 0) // Aucun coup à jouer
+	{
+		return a_renvoyer;
+	}
+
+	for ( f = 0 ; f < nb_fils ; f++ )
+	{
+		parametres[f].p = &p;
+		parametres[f].pion = pion;
+		parametres[f].debut = debut;
+		parametres[f].duree_max = duree_imposee;
+		parametres[f].simulations_max = simulations_imposees;
+		if(duree_imposee == 0 && simulations_imposees == 0)
+		{
+			parametres[f].duree_max = duree_reflexion(level);
+		}
+		initialise_generateur(&parametres[f].alea, ((uint64_t)rand() << 32) ^ (uint64_t)rand() ^ f);
+	}
+
+	for ( f = 1 ; f < nb_fils ; f++ ) // Le fil appelant joue lui-même le rôle du premier fil
+	{
+		if((fils[f] = SDL_CreateThread(cherche_monte_carlo, &parametres[f])) == NULL)
+		{
+			break; // (La recherche se contente des fils déjà créés)
+		}
+	}
+	nb_lances = f;
+	cherche_monte_carlo(&parametres[0]);
+	while(--f > 0)
+	{
+		SDL_WaitThread(fils[f], NULL);
+	}
+
+	meilleur = &reserve[racine->fils];
+	for ( f = 1 ; f < racine->nb_fils ; f++ )
+	{
+		if(reserve[racine->fils + f].visites > meilleur->visites)
+		{
+			meilleur = &reserve[racine->fils + f];
+		}
+	}
+	a_renvoyer.x = meilleur->coup % p.largeur;
+	a_renvoyer.y = meilleur->coup / p.largeur - 2;
+
+	// (Debug) On affiche le résultat de la recherche
+	printf("Monte-Carlo: %lu simulations (%d fils, %lu heritees), %d noeuds, %u ms\n", nb_simulations, nb_lances, nb_reutilisees,
+			(nb_noeuds < capacite) ? nb_noeuds : capacite, SDL_GetTicks() - debut);
+	printf("##################\nCoup choisi: [%d,%d] (%u simulations, %.1f%% de victoires)\n##################\n",
+			a_renvoyer.x+1, a_renvoyer.y+1, meilleur->visites, meilleur->visites ? 100.0 * meilleur->victoires / meilleur->visites : 0.0);
+
+	return a_renvoyer;
+}
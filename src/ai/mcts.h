@@ -0,0 +1,73 @@
+/*!
+ *	\file	mcts.h
+ *	\brief	Prototypes de l'IA Monte-Carlo ("Roulette")
+ *	\author	Julien Laurent
+ *
+ *	Ce fichier contient les déclarations de la recherche arborescente Monte-Carlo (UCT, complétée
+ *	par l'heuristique RAVE / AMAF). Au lieu d'évaluer les positions, cette IA joue un grand nombre
+ *	de parties aléatoires à partir de la position courante, en concentrant peu à peu ses simulations
+ *	sur les coups qui gagnent le plus souvent. Contrairement à l'AlphaBeta, elle n'a pas besoin
+ *	d'horizon, et reste utilisable sur les plus grands plateaux.
+ *	Les simulations sont réparties entre plusieurs fils d'exécution, qui parcourent tous le même
+ *	arbre (parallélisation "par l'arbre"), sans aucun verrou.
+ *	L'arbre est conservé d'un coup à l'autre: si la nouvelle position y figure (après le coup joué
+ *	par l'IA et la réponse de l'adversaire), son sous-arbre devient la racine de la recherche
+ *	suivante, avec toutes ses simulations.
+ */
+
+#ifndef MCTS_H_INCLUDED
+#define MCTS_H_INCLUDED
+
+#include "ai.h"
+#include "playout.h"
+
+#define TAILLE_MCTS 64 ///< Budget mémoire de l'arbre de recherche Monte-Carlo (en Mo)
+#define SEUIL_EXPANSION 4 ///< Nombre de simulations passées par une feuille avant qu'elle ne soit développée
+#define EXPLORATION_UCT 0.2 ///< Coefficient du terme d'exploration de la formule UCT
+#define EQUIVALENCE_RAVE 1000 ///< Nombre de simulations au bout duquel les statistiques AMAF ne comptent plus que pour moitié (environ)
+#define INTERVALLE_SIMULATIONS 64 ///< Nombre de simulations entre deux consultations de l'horloge
+#define PERTE_VIRTUELLE 3 ///< Nombre de défaites fictives comptées à un nœud par chaque fil qui le traverse, jusqu'à la fin de sa simulation
+
+#define AUCUN_FILS -1 ///< Indice du premier fils d'un nœud non développé
+#define EN_DEVELOPPEMENT -2 ///< Indice du premier fils d'un nœud en cours de développement par un fil
+
+/*!
+ *	\brief	Nœud de l'arbre de recherche Monte-Carlo
+ *	\author	Julien Laurent
+ *
+ *	Chaque nœud correspond à un coup, et compte les simulations qui l'ont traversé et celles qui ont
+ *	été gagnées par le joueur de ce coup. Il compte aussi les statistiques AMAF ("All Moves As First")
+ *	du coup: les simulations, passées par son père, au cours desquelles le joueur du coup a occupé
+ *	sa case, à n'importe quel moment de la partie. Ces statistiques, bien plus nombreuses mais moins
+ *	fiables, orientent la recherche tant que le nœud n'a été que peu visité (heuristique RAVE).
+ *	Les fils d'un nœud sont rangés consécutivement dans la réserve de nœuds de l'arbre.
+ *	Les compteurs sont partagés entre les fils d'exécution, et modifiés par des opérations atomiques.
+ */
+struct noeud_mcts
+{
+	volatile int fils; ///< Indice du premier fils dans la réserve de nœuds (#AUCUN_FILS si le nœud n'est pas développé, #EN_DEVELOPPEMENT s'il est en train de l'être)
+	unsigned short nb_fils; ///< Nombre de fils (un par case vide), valide dès que \a fils est un indice
+	unsigned char coup; ///< Case jouée pour atteindre ce nœud (indice dans les #bitboard)
+	volatile unsigned int visites; ///< Nombre de simulations passées par le nœud (y compris les pertes virtuelles en cours)
+	volatile unsigned int victoires; ///< Nombre de ces simulations gagnées par le joueur du coup
+	volatile unsigned int visites_amaf; ///< Nombre de simulations où le joueur du coup a occupé sa case (après le père)
+	volatile unsigned int victoires_amaf; ///< Nombre de ces simulations gagnées par le joueur du coup
+};
+typedef struct noeud_mcts noeud_mcts; ///< Raccourci d'utilisation du type #noeud_mcts
+
+/// Impose un budget (temps en ms, nombre de simulations) à toutes les recherches Monte-Carlo suivantes, ou rétablit le budget par niveau avec (0, 0)
+void fixe_budget_monte_carlo(unsigned int duree_max, unsigned long simulations_max);
+
+/// Renvoie le nombre de simulations jouées lors de la dernière recherche Monte-Carlo
+unsigned long simulations_monte_carlo(void);
+
+/// Renvoie le nombre de simulations héritées de la recherche précédente par la racine de la dernière recherche Monte-Carlo
+unsigned long simulations_reutilisees(void);
+
+/// Active (par défaut) ou désactive la réutilisation de l'arbre Monte-Carlo d'un coup à l'autre
+void active_reutilisation_arbre(bool actif);
+
+/// Renvoie les coordonnées (valides) à jouer, choisies par recherche Monte-Carlo pendant le temps accordé au niveau \a level
+coord ia_monte_carlo(plateau p, char pion, int level);
+
+#endif // MCTS_H_INCLUDED
@@ -0,0 +1,353 @@
+/*!
+ *	\file	ouvertures.c
+ *	\brief	Livre d'ouvertures
+ *	\author	Julien Laurent
+ *
+ *	Ce fichier contient la génération, le chargement et la consultation des livres d'ouvertures
+ *	(voir ouvertures.h).
+ */
+
+#include "ouvertures.h"
+
+static entree_ouverture *livres[DIM_MAX+1]; ///< Entrées (triées par clé) du livre de chaque dimension (NULL s'il n'est pas chargé)
+static int nb_entrees_livres[DIM_MAX+1]; ///< Nombre d'entrées du livre de chaque dimension
+static bool livres_actifs = true; ///< Vrai si les IA consultent les livres (voir #coup_livre_ouvertures())
+
+/*!
+ *	\brief	Livre en cours de génération
+ *	\author	Julien Laurent
+ */
+struct livre_ouvertures
+{
+	entree_ouverture *entrees; ///< Entrées déjà cherchées (dans l'ordre de la recherche)
+	int nb_entrees; ///< Nombre d'entrées
+	int capacite; ///< Nombre d'entrées allouées
+	int pions_max; ///< Nombre maximal de pions des positions du livre
+	int level; ///< Niveau de l'IA Solveur qui cherche les coups
+};
+typedef struct livre_ouvertures livre_ouvertures; ///< Raccourci d'utilisation du type #livre_ouvertures
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur le plateau
+ *	\param	joueur Couleur du joueur qui a le trait
+ *	\param	tournee Pointeur sur un booléen, à renseigner: vrai si la clé renvoyée est celle de la position tournée
+ *	\return	Clé canonique de la position
+ *
+ *	La rotation d'un demi-tour (case (x,y) en (dim-1-x, dim-1-y)) conserve les couleurs et les
+ *	frontières: la position tournée est équivalente, et sa clé est calculée pion par pion.
+ */
+static uint64_t cle_canonique(const plateau *p, char joueur, bool *tournee)
+{
+	uint64_t cle = p->cle, cle_tournee = 0;
+	int couleur, k, x, y;
+	bitboard parcours;
+
+	for ( couleur = 0 ; couleur < 2 ; couleur++ )
+	{
+		parcours = p->pions[couleur];
+		while((k = bb_extrait(&parcours)) >= 0)
+		{
+			x = k % p->largeur;
+			y = k / p->largeur - 2;
+			cle_tournee ^= cles_zobrist[couleur][indice_case(p, p->dim-1-x, p->dim-1-y)];
+		}
+	}
+
+	if(indice_couleur(joueur) == 1)
+	{
+		cle ^= CLE_TRAIT_OUVERTURES;
+		cle_tournee ^= CLE_TRAIT_OUVERTURES;
+	}
+
+	*tournee = (cle_tournee < cle);
+	return *tournee ? cle_tournee : cle;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	a Pointeur sur la première entrée
+ *	\param	b Pointeur sur la seconde entrée
+ *	\return	Ordre des clés des deux entrées (pour qsort() et bsearch())
+ */
+static int compare_entrees(const void *a, const void *b)
+{
+	uint64_t cle_a = ((const entree_ouverture *) a)->cle, cle_b = ((const entree_ouverture *) b)->cle;
+
+	return (cle_a > cle_b) - (cle_a < cle_b);
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur le plateau de la position (rendu inchangé)
+ *	\param	joueur Couleur du joueur du livre, qui a le trait
+ *	\param	livre Pointeur sur le livre en cours de génération
+ *	\return	0 en cas de succès, -1 si la mémoire a manqué
+ *
+ *	Le coup du joueur est cherché, puis toutes les réponses de l'adversaire à ce coup sont ajoutées
+ *	à leur tour (le livre ne contient donc que les positions où le joueur a suivi le livre).
+ */
+static int ajoute_position(plateau *p, char joueur, livre_ouvertures *livre)
+{
+	entree_ouverture *entrees, *entree;
+	int i, k, pions = bb_compte(p->pions[0]) + bb_compte(p->pions[1]), resultat = 0;
+	bool tournee;
+	uint64_t cle;
+	coord coup;
+	bitboard vides;
+
+	if(pions > livre->pions_max || gagnant(p) != 'V' || bb_est_nul(cases_vides(p)))
+	{
+		return 0;
+	}
+
+	cle = cle_canonique(p, joueur, &tournee);
+	for ( i = 0 ; i < livre->nb_entrees ; i++ ) // Position (ou sa tournée) déjà cherchée par un autre chemin
+	{
+		if(livre->entrees[i].cle == cle)
+		{
+			return 0;
+		}
+	}
+
+	if(livre->nb_entrees == livre->capacite)
+	{
+		entrees = realloc(livre->entrees, 2 * livre->capacite * sizeof(entree_ouverture));
+		if(entrees == NULL)
+		{
+			return -1;
+		}
+		livre->entrees = entrees;
+		livre->capacite *= 2;
+	}
+
+	detruisTables(); // (Chaque recherche part de tables vides, comme au premier coup d'une partie)
+	initTables();
+	coup = ia_solveur(*p, joueur, livre->level);
+
+	entree = &livre->entrees[livre->nb_entrees++];
+	entree->cle = cle;
+	entree->coup = tournee ? (p->dim-1-coup.y) * p->dim + (p->dim-1-coup.x) : coup.y * p->dim + coup.x;
+	entree->pions = pions;
+	entree->reserve = 0;
+
+	// (Debug) On affiche l'avancement de la génération
+	printf("Livre %dx%d: %d positions\n", p->dim, p->dim, livre->nb_entrees);
+
+	joue_coup(p, coup.x, coup.y, joueur);
+	if(pions + 2 <= livre->pions_max && gagnant(p) == 'V')
+	{
+		vides = cases_vides(p);
+		while((k = bb_extrait(&vides)) >= 0 && resultat == 0)
+		{
+			joue_coup(p, k % p->largeur, k / p->largeur - 2, couleur_opposee(joueur));
+			resultat = ajoute_position(p, joueur, livre);
+			dejoue_coup(p);
+		}
+	}
+	dejoue_coup(p);
+
+	return resultat;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur un plateau vide de la dimension du livre (rendu vide)
+ *	\param	pions_max Nombre maximal de pions des positions du livre
+ *	\param	level Niveau de l'IA Solveur qui cherche chaque coup (voir #duree_reflexion())
+ *	\return	0 en cas de succès, -1 sinon
+ *
+ *	Le livre couvre les parties où l'IA joue les Noirs (à partir du plateau vide) et celles où elle
+ *	joue les Blancs (à partir de chaque premier coup des Noirs). Chaque coup est celui de l'IA
+ *	Solveur: prouvé gagnant si la position a pu être résolue, et sinon celui de l'IA Electrique.
+ *	Les tables de condensats sont détruites à la fin de la génération.
+ */
+int genere_livre_ouvertures(plateau *p, int pions_max, int level)
+{
+	livre_ouvertures livre;
+	entete_ouvertures entete;
+	char nom[64];
+	FILE *fichier;
+	int k, resultat;
+	bitboard vides;
+
+	if(pions_max < 0 || !bb_est_nul(bb_ou(p->pions[0], p->pions[1])))
+	{
+		return -1;
+	}
+
+	livre.capacite = 64;
+	livre.nb_entrees = 0;
+	livre.pions_max = pions_max;
+	livre.level = level;
+	livre.entrees = malloc(livre.capacite * sizeof(entree_ouverture));
+	if(livre.entrees == NULL)
+	{
+		return -1;
+	}
+
+	active_livres_ouvertures(false); // Les coups ne doivent pas être lus dans l'ancien livre
+	resultat = ajoute_position(p, 'N', &livre);
+	if(pions_max >= 1)
+	{
+		vides = cases_vides(p);
+		while((k = bb_extrait(&vides)) >= 0 && resultat == 0)
+		{
+			joue_coup(p, k % p->largeur, k / p->largeur - 2, 'N');
+			resultat = ajoute_position(p, 'B', &livre);
+			dejoue_coup(p);
+		}
+	}
+	active_livres_ouvertures(true);
+	detruisTables();
+
+	if(resultat != 0)
+	{
+		free(livre.entrees);
+		return -1;
+	}
+
+	qsort(livre.entrees, livre.nb_entrees, sizeof(entree_ouverture), compare_entrees);
+
+	memcpy(entete.signature, SIGNATURE_OUVERTURES, sizeof(entete.signature));
+	entete.dimension = p->dim;
+	entete.pions_max = pions_max;
+	entete.nb_entrees = livre.nb_entrees;
+	entete.reserve = 0;
+
+	sprintf(nom, FICHIER_OUVERTURES, p->dim, p->dim);
+	fichier = fopen(nom, "wb");
+	if(fichier == NULL || fwrite(&entete, sizeof(entete), 1, fichier) != 1
+		|| fwrite(livre.entrees, sizeof(entree_ouverture), livre.nb_entrees, fichier) != (size_t) livre.nb_entrees)
+	{
+		if(fichier != NULL)
+		{
+			fclose(fichier);
+		}
+		free(livre.entrees);
+		return -1;
+	}
+
+	fclose(fichier);
+	free(livre.entrees);
+	return 0;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *
+ *	Un fichier absent est simplement ignoré (le livre de sa dimension n'est alors pas consulté), de
+ *	même qu'un fichier dont l'en-tête est incorrect.
+ */
+void charge_livres_ouvertures(void)
+{
+	entete_ouvertures entete;
+	char nom[64];
+	FILE *fichier;
+	int dim;
+
+	for ( dim = 1 ; dim <= DIM_MAX ; dim++ )
+	{
+		if(livres[dim] != NULL)
+		{
+			continue;
+		}
+
+		sprintf(nom, FICHIER_OUVERTURES, dim, dim);
+		fichier = fopen(nom, "rb");
+		if(fichier == NULL)
+		{
+			continue;
+		}
+
+		if(fread(&entete, sizeof(entete), 1, fichier) == 1 && memcmp(entete.signature, SIGNATURE_OUVERTURES, sizeof(entete.signature)) == 0
+			&& entete.dimension == (uint32_t) dim && entete.nb_entrees > 0 && entete.nb_entrees <= (1u << 24))
+		{
+			livres[dim] = malloc(entete.nb_entrees * sizeof(entree_ouverture));
+			if(livres[dim] != NULL && fread(livres[dim], sizeof(entree_ouverture), entete.nb_entrees, fichier) == entete.nb_entrees)
+			{
+				nb_entrees_livres[dim] = entete.nb_entrees;
+				printf("Livre %s charge (%d positions)\n", nom, nb_entrees_livres[dim]);
+			}
+			else
+			{
+				free(livres[dim]);
+				livres[dim] = NULL;
+			}
+		}
+		if(livres[dim] == NULL)
+		{
+			printf("Livre %s invalide: ignore\n", nom);
+		}
+		fclose(fichier);
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ */
+void libere_livres_ouvertures(void)
+{
+	int dim;
+
+	for ( dim = 1 ; dim <= DIM_MAX ; dim++ )
+	{
+		free(livres[dim]);
+		livres[dim] = NULL;
+		nb_entrees_livres[dim] = 0;
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	actif Vrai pour que les IA consultent les livres
+ */
+void active_livres_ouvertures(bool actif)
+{
+	livres_actifs = actif;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur le plateau sur lequel l'IA doit jouer
+ *	\param	joueur Couleur du pion joué par l'IA
+ *	\param	coup Pointeur sur les coordonnées du coup à jouer, à remplir (inchangées si le livre n'en donne pas)
+ *	\return	Vrai si le livre donne un coup pour la position
+ *
+ *	Le coût de la consultation est celui du calcul de la clé de la position tournée (proportionnel au
+ *	nombre de pions, petit en début de partie) et d'une recherche dichotomique.
+ */
+bool coup_livre_ouvertures(const plateau *p, char joueur, coord *coup)
+{
+	entree_ouverture cherchee;
+	const entree_ouverture *trouvee;
+	coord trouve;
+	bool tournee;
+
+	if(!livres_actifs || p->dim < 1 || p->dim > DIM_MAX || livres[p->dim] == NULL)
+	{
+		return false;
+	}
+
+	cherchee.cle = cle_canonique(p, joueur, &tournee);
+	trouvee = bsearch(&cherchee, livres[p->dim], nb_entrees_livres[p->dim], sizeof(entree_ouverture), compare_entrees);
+	if(trouvee == NULL || trouvee->coup >= p->dim * p->dim)
+	{
+		return false;
+	}
+
+	trouve.x = trouvee->coup % p->dim;
+	trouve.y = trouvee->coup / p->dim;
+	if(tournee)
+	{
+		trouve.x = p->dim-1 - trouve.x;
+		trouve.y = p->dim-1 - trouve.y;
+	}
+	if(case_plateau(p, trouve.x, trouve.y) != 'V') // (Protection contre une collision de clés)
+	{
+		return false;
+	}
+
+	*coup = trouve;
+	return true;
+}
@@ -0,0 +1,68 @@
+/*!
+ *	\file	ouvertures.h
+ *	\brief	Prototypes du livre d'ouvertures
+ *	\author	Julien Laurent
+ *
+ *	Ce fichier contient les déclarations du livre d'ouvertures: pour les premières positions d'une
+ *	partie, le coup à jouer a été cherché une fois pour toutes (hors partie, avec une recherche bien
+ *	plus longue que celle d'un coup ordinaire) par #genere_livre_ouvertures(), et les IA le jouent
+ *	sans aucune recherche, au moment où la recherche serait la plus coûteuse (plateau presque vide).
+ *	Le livre de chaque dimension est un fichier d'entrées triées par clé, chargé au démarrage par
+ *	#charge_livres_ouvertures() et consulté par recherche dichotomique.
+ *	La clé d'une position est sa clé de Zobrist (combinée au trait), ou celle de la position tournée
+ *	d'un demi-tour si elle est plus petite: une position et sa tournée, équivalentes, partagent la
+ *	même entrée (dont le coup est tourné au besoin).
+ */
+
+#ifndef OUVERTURES_H_INCLUDED
+#define OUVERTURES_H_INCLUDED
+
+#include "dfpn.h"
+
+#define FICHIER_OUVERTURES "ouvertures_%dx%d.bin" ///< Nom du fichier du livre de chaque dimension (dans le répertoire courant, comme save.hex)
+#define SIGNATURE_OUVERTURES "HEXOUV01" ///< Signature des fichiers de livres d'ouvertures (à changer si les clés de Zobrist changent)
+#define CLE_TRAIT_OUVERTURES 0x9E3779B97F4A7C15ULL ///< Clé "ou-exclusivée" avec celle du plateau quand les Blancs ont le trait
+
+/*!
+ *	\brief	En-tête d'un fichier de livre d'ouvertures
+ *	\author	Julien Laurent
+ */
+struct entete_ouvertures
+{
+	char signature[8]; ///< #SIGNATURE_OUVERTURES
+	uint32_t dimension; ///< Dimension du plateau
+	uint32_t pions_max; ///< Nombre maximal de pions des positions du livre
+	uint32_t nb_entrees; ///< Nombre d'entrées (#entree_ouverture) qui suivent l'en-tête
+	uint32_t reserve; ///< Inutilisé (alignement)
+};
+typedef struct entete_ouvertures entete_ouvertures; ///< Raccourci d'utilisation du type #entete_ouvertures
+
+/*!
+ *	\brief	Entrée d'un livre d'ouvertures
+ *	\author	Julien Laurent
+ */
+struct entree_ouverture
+{
+	uint64_t cle; ///< Clé canonique de la position (la plus petite de la position et de sa tournée)
+	uint16_t coup; ///< Coup à jouer dans la position de clé \a cle (case y * dim + x)
+	uint16_t pions; ///< Nombre de pions de la position
+	uint32_t reserve; ///< Inutilisé (alignement)
+};
+typedef struct entree_ouverture entree_ouverture; ///< Raccourci d'utilisation du type #entree_ouverture
+
+/// Cherche le coup de l'IA Solveur (au niveau donné) dans chaque position jusqu'au nombre de pions donné, et écrit le livre de la dimension du plateau (vide) donné dans son fichier (0 en cas de succès, -1 sinon)
+int genere_livre_ouvertures(plateau *p, int pions_max, int level);
+
+/// Charge les fichiers de livres d'ouvertures présents (à appeler au démarrage)
+void charge_livres_ouvertures(void);
+
+/// Libère les livres d'ouvertures chargés
+void libere_livres_ouvertures(void);
+
+/// Active (par défaut) ou désactive la consultation des livres par les IA
+void active_livres_ouvertures(bool actif);
+
+/// Renvoie vrai si le livre (s'il est activé) contient la position, et donne le coup à jouer
+bool coup_livre_ouvertures(const plateau *p, char joueur, coord *coup);
+
+#endif // OUVERTURES_H_INCLUDED
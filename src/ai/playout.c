@@ -0,0 +1,112 @@
+/*!
+ *	\file	playout.c
+ *	\brief	Noyau de parties aléatoires ("playouts")
+ *	\author	Julien Laurent
+ *
+ *	Ce fichier contient le générateur pseudo-aléatoire des simulations, le remplissage aléatoire
+ *	d'un plateau, et la recherche du gagnant d'un plateau plein, par propagation sur les #bitboard.
+ */
+
+#include "playout.h"
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	g Générateur à initialiser
+ *	\param	graine Graine quelconque (même nulle)
+ *
+ *	La graine est d'abord mélangée (étape finale de "splitmix64"), pour que des graines voisines
+ *	(comme celles de fils d'exécution numérotés) donnent des états sans rapport entre eux.
+ */
+void initialise_generateur(generateur *g, uint64_t graine)
+{
+	uint64_t z = graine + 0x9E3779B97F4A7C15ULL;
+
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	z ^= z >> 31;
+
+	g->etat = z ? z : 0x9E3779B97F4A7C15ULL; // (L'état nul est le seul point fixe du générateur)
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	b Ensemble de cases
+ *	\param	L Largeur d'une ligne des #bitboard
+ *	\return	Ensemble des cases de \a b et de leurs voisines
+ *
+ *	Même calcul que #voisinage() (auquel la case elle-même est ajoutée), mais inséré directement
+ *	dans la boucle de propagation.
+ */
+static inline bitboard etend(bitboard b, int L)
+{
+	bitboard r = bb_ou(b, bb_ou(bb_decale(b, -L), bb_decale(b, -L+1)));
+
+	r = bb_ou(r, bb_ou(bb_decale(b, 1), bb_decale(b, -1)));
+	r = bb_ou(r, bb_ou(bb_decale(b, L), bb_decale(b, L-1)));
+
+	return r;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Plateau (seules sa géométrie et ses frontières sont utilisées)
+ *	\param	noirs Ensemble des pions noirs
+ *	\return	Vrai si un groupe de pions noirs touche les deux frontières noires
+ *
+ *	Les pions noirs reliés à la frontière du haut sont propagés tous à la fois, ligne après ligne,
+ *	jusqu'à atteindre la frontière du bas ou ne plus progresser. Sur un plateau plein, c'est la seule
+ *	vérification nécessaire: si les noirs ne sont pas reliés, les blancs le sont.
+ */
+bool relie_noirs(const plateau *p, bitboard noirs)
+{
+	bitboard groupe = bb_nul(), suivant = bb_et(noirs, p->bords[0]);
+
+	while(!bb_egal(groupe, suivant))
+	{
+		groupe = suivant;
+		if(!bb_est_nul(bb_et(groupe, p->bords[1])))
+		{
+			return true;
+		}
+		suivant = bb_et(etend(groupe, p->largeur), noirs);
+	}
+
+	return false;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Plateau de départ (non modifié)
+ *	\param	joueur Couleur du joueur qui doit jouer
+ *	\param	g Générateur du fil d'exécution
+ *	\param	pions Pions noirs (indice 0) et blancs (indice 1) du plateau rempli
+ *	\return	Couleur du gagnant de la partie ('N' ou 'B')
+ *
+ *	Les deux joueurs jouant à tour de rôle, celui qui doit jouer occupera la moitié (arrondie au-dessus)
+ *	des cases vides, et son adversaire le reste. Un mélange partiel (Fisher-Yates) des cases vides
+ *	suffit donc à tirer les cases du premier joueur, et le plateau n'est jamais modifié.
+ */
+char partie_aleatoire(const plateau *p, char joueur, generateur *g, bitboard pions[2])
+{
+	unsigned char cases[DIM_MAX*DIM_MAX];
+	int i, j, k, nb = 0, indice = indice_couleur(joueur);
+	bitboard vides = cases_vides(p), tirees = bb_nul();
+
+	while((k = bb_extrait(&vides)) >= 0)
+	{
+		cases[nb++] = k;
+	}
+
+	for ( i = 0 ; i < (nb+1) / 2 ; i++ )
+	{
+		j = i + tirage(g, nb - i);
+		k = cases[j];
+		cases[j] = cases[i];
+		bb_place(&tirees, k);
+	}
+
+	pions[indice] = bb_ou(p->pions[indice], tirees);
+	pions[1-indice] = bb_ou(p->pions[1-indice], bb_sauf(cases_vides(p), tirees));
+
+	return relie_noirs(p, pions[0]) ? 'N' : 'B';
+}
@@ -0,0 +1,60 @@
+/*!
+ *	\file	playout.h
+ *	\brief	Prototypes du noyau de parties aléatoires ("playouts")
+ *	\author	Julien Laurent
+ *
+ *	Ce fichier contient les déclarations du noyau de simulation utilisé par l'IA Monte-Carlo: un
+ *	générateur pseudo-aléatoire rapide, propre à chaque fil d'exécution, et le remplissage aléatoire
+ *	d'un plateau, suivi d'une seule recherche du gagnant. Un plateau de Hex plein ayant toujours
+ *	exactement un gagnant, il est inutile de vérifier la fin de la partie après chaque coup, et
+ *	même de jouer les coups un par un: il suffit de tirer au hasard les cases de chaque joueur.
+ */
+
+#ifndef PLAYOUT_H_INCLUDED
+#define PLAYOUT_H_INCLUDED
+
+#include "../model/data_models.h"
+
+/*!
+ *	\brief	Générateur pseudo-aléatoire "xorshift64*"
+ *	\author	Julien Laurent
+ *
+ *	Chaque fil d'exécution possède son propre générateur: rand() ne peut pas servir aux simulations,
+ *	car son état est partagé (et protégé par un verrou, sur la plupart des systèmes).
+ *	Le générateur doit être initialisé par #initialise_generateur().
+ */
+struct generateur
+{
+	uint64_t etat; ///< État du générateur (jamais nul)
+};
+typedef struct generateur generateur; ///< Raccourci d'utilisation du type #generateur
+
+/// Renvoie un entier pseudo-aléatoire de 64 bits
+static inline uint64_t aleatoire(generateur *g)
+{
+	uint64_t x = g->etat;
+
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	g->etat = x;
+
+	return x * 0x2545F4914F6CDD1DULL;
+}
+
+/// Renvoie un entier pseudo-aléatoire de [0, n[ (par multiplication plutôt que par modulo, plus lent)
+static inline int tirage(generateur *g, int n)
+{
+	return (int)(((aleatoire(g) >> 32) * (uint64_t)n) >> 32);
+}
+
+/// Initialise un générateur à partir d'une graine quelconque (deux graines différentes donnent des suites indépendantes)
+void initialise_generateur(generateur *g, uint64_t graine);
+
+/// Renvoie vrai si les pions noirs donnés relient les deux frontières noires du plateau
+bool relie_noirs(const plateau *p, bitboard noirs);
+
+/// Remplit au hasard les cases vides du plateau (le joueur donné jouant le premier), et renvoie le gagnant ('N' ou 'B')
+char partie_aleatoire(const plateau *p, char joueur, generateur *g, bitboard pions[2]);
+
+#endif // PLAYOUT_H_INCLUDED
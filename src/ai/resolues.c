@@ -0,0 +1,498 @@
+/*!
+ *	\file	resolues.c
+ *	\brief	Tables de positions résolues
+ *	\author	Julien Laurent
+ *
+ *	Ce fichier contient la génération, la projection en mémoire et la consultation des tables de
+ *	positions résolues (voir resolues.h).
+ *	Les cases d'un plateau de dimension d y sont numérotées y * d + x (de 0 à d * d - 1). Les
+ *	positions de s pions sont rangées après celles de moins de s pions: d'abord par ensemble de
+ *	cases occupées, puis par sous-ensemble (de taille (s + 1) / 2, les Noirs commençant) de ces
+ *	cases qui portent un pion noir.
+ */
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "resolues.h"
+
+#define NB_CASES_MAX (DIMENSION_MAX_RESOLUES*DIMENSION_MAX_RESOLUES) ///< Nombre de cases du plus grand plateau des tables
+
+static uint32_t binomiaux[NB_CASES_MAX+1][NB_CASES_MAX+1]; ///< Coefficients binomiaux C(n, k) (nuls si k > n)
+static bool binomiaux_calcules = false; ///< Vrai une fois la table #binomiaux calculée
+
+static const unsigned char *tables[DIMENSION_MAX_RESOLUES+1]; ///< Entrées de la table de chaque dimension (NULL si elle n'est pas chargée)
+static int pions_tables[DIMENSION_MAX_RESOLUES+1]; ///< Nombre maximal de pions des positions de chaque table
+static uint32_t debuts_tables[DIMENSION_MAX_RESOLUES+1][NB_CASES_MAX+2]; ///< Rang de la première position de chaque nombre de pions, pour chaque dimension
+static void *projections[DIMENSION_MAX_RESOLUES+1]; ///< Début de la projection en mémoire du fichier de chaque table
+static size_t tailles_projections[DIMENSION_MAX_RESOLUES+1]; ///< Taille de la projection en mémoire du fichier de chaque table
+static bool tables_actives = true; ///< Vrai si les IA consultent les tables (voir #coup_table_resolue())
+
+/*!
+ *	\author	Julien Laurent
+ */
+static void calcule_binomiaux(void)
+{
+	int n, k;
+
+	if(binomiaux_calcules)
+	{
+		return;
+	}
+
+	for ( n = 0 ; n <= NB_CASES_MAX ; n++ )
+	{
+		binomiaux[n][0] = 1;
+		for ( k = 1 ; k <= NB_CASES_MAX ; k++ )
+		{
+			binomiaux[n][k] = (n == 0) ? 0 : binomiaux[n-1][k-1] + binomiaux[n-1][k];
+		}
+	}
+
+	binomiaux_calcules = true;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	nb_cases Nombre de cases du plateau
+ *	\param	debuts Rang de la première position de chaque nombre de pions (de 0 à nb_cases + 1), à remplir
+ */
+static void calcule_debuts(int nb_cases, uint32_t debuts[])
+{
+	int s;
+
+	debuts[0] = 0;
+	for ( s = 0 ; s <= nb_cases ; s++ )
+	{
+		debuts[s+1] = debuts[s] + binomiaux[nb_cases][s] * binomiaux[s][(s+1)/2];
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	contenu Contenu de chaque case (0: vide, 1: noir, 2: blanc)
+ *	\param	nb_cases Nombre de cases du plateau
+ *	\param	debuts Rangs des premières positions de chaque nombre de pions (voir #calcule_debuts())
+ *	\param	pions_max Nombre maximal de pions des positions de la table
+ *	\return	Rang de la position dans la table, ou -1 si elle n'y est pas
+ *
+ *	Dans le système de numération combinatoire, l'ensemble {c1 < c2 < ... < cs} a pour rang la
+ *	somme des C(ci, i): chaque pion ajoute un terme au rang de l'ensemble des cases occupées, et
+ *	chaque pion noir un terme (calculé sur son rang parmi les cases occupées) à celui des pions noirs.
+ */
+static long rang_position(const int contenu[], int nb_cases, const uint32_t debuts[], int pions_max)
+{
+	uint32_t rang_cases = 0, rang_noirs = 0;
+	int c, pions = 0, noirs = 0;
+
+	for ( c = 0 ; c < nb_cases ; c++ )
+	{
+		if(contenu[c] != 0)
+		{
+			rang_cases += binomiaux[c][pions+1];
+			if(contenu[c] == 1)
+			{
+				rang_noirs += binomiaux[pions][noirs+1];
+				noirs++;
+			}
+			pions++;
+		}
+	}
+
+	if(pions > pions_max || noirs != (pions+1) / 2)
+	{
+		return -1;
+	}
+	return debuts[pions] + rang_cases * binomiaux[pions][noirs] + rang_noirs;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	rang Rang de l'ensemble
+ *	\param	n Nombre d'éléments parmi lesquels l'ensemble est choisi
+ *	\param	k Taille de l'ensemble
+ *	\param	elements Appartenance de chaque élément à l'ensemble, à remplir
+ *
+ *	Opération inverse du calcul de rang de #rang_position(): le plus grand élément est le plus grand
+ *	c tel que C(c, k) ne dépasse pas le rang, et ainsi de suite.
+ */
+static void ensemble_de_rang(uint32_t rang, int n, int k, bool elements[])
+{
+	int c;
+
+	for ( c = n-1 ; c >= 0 ; c-- )
+	{
+		elements[c] = (k > 0 && binomiaux[c][k] <= rang);
+		if(elements[c])
+		{
+			rang -= binomiaux[c][k];
+			k--;
+		}
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur un plateau vide de la dimension à résoudre (rendu vide)
+ *	\param	pions_max Nombre maximal de pions des positions à résoudre
+ *	\return	0 en cas de succès, -1 sinon
+ *
+ *	Les positions sont résolues du plus grand nombre de pions au plus petit. Celles qui ont
+ *	\a pions_max pions sont résolues par le solveur DFPN (sans limite), et les autres par un seul
+ *	niveau de NegaMax: la position est gagnée si l'un de ses coups mène à une position (déjà
+ *	résolue) perdue pour l'adversaire. Une partie terminée est perdue pour le joueur qui a le trait.
+ *	La rotation d'un demi-tour du plateau (case c en nb_cases - 1 - c) conserve les couleurs et les
+ *	frontières: une position dont la tournée a un rang plus petit en reprend l'entrée (avec le coup
+ *	tourné), si bien que seule une position sur deux est réellement résolue.
+ */
+int genere_table_resolue(plateau *p, int pions_max)
+{
+	const int nb_cases = p->dim * p->dim;
+	uint32_t debuts[NB_CASES_MAX+2], i, nb_noirs_possibles;
+	int contenu[NB_CASES_MAX], tourne[NB_CASES_MAX];
+	bool occupees[NB_CASES_MAX], noirs[NB_CASES_MAX];
+	int s, c, j, couleur, resultat;
+	long rang, rang_tourne, rang_fils;
+	char joueur, vainqueur;
+	unsigned char *positions, entree;
+	coord coup;
+	entete_resolues entete;
+	char nom[64];
+	FILE *fichier;
+	clock_t debut = clock();
+
+	if(p->dim < DIMENSION_MIN_RESOLUES || p->dim > DIMENSION_MAX_RESOLUES || pions_max < 0 || pions_max > nb_cases || !bb_est_nul(bb_ou(p->pions[0], p->pions[1])))
+	{
+		return -1;
+	}
+
+	calcule_binomiaux();
+	calcule_debuts(nb_cases, debuts);
+	positions = malloc(debuts[pions_max+1]);
+	if(positions == NULL)
+	{
+		return -1;
+	}
+
+	for ( s = pions_max ; s >= 0 ; s-- )
+	{
+		joueur = (s % 2 == 0) ? 'N' : 'B'; // (Les Noirs commencent)
+		couleur = indice_couleur(joueur) + 1;
+		nb_noirs_possibles = binomiaux[s][(s+1)/2];
+		for ( i = 0 ; i < debuts[s+1] - debuts[s] ; i++ )
+		{
+			ensemble_de_rang(i / nb_noirs_possibles, nb_cases, s, occupees);
+			ensemble_de_rang(i % nb_noirs_possibles, s, (s+1)/2, noirs);
+			for ( c = 0, j = 0 ; c < nb_cases ; c++ )
+			{
+				contenu[c] = occupees[c] ? (noirs[j++] ? 1 : 2) : 0;
+				tourne[nb_cases-1-c] = contenu[c];
+			}
+
+			rang = debuts[s] + i;
+			rang_tourne = rang_position(tourne, nb_cases, debuts, pions_max);
+			if(rang_tourne < rang) // Position symétrique déjà résolue
+			{
+				entree = positions[rang_tourne];
+				if((entree & POSITION_GAGNEE) && (entree & AUCUN_COUP_RESOLUES) != AUCUN_COUP_RESOLUES)
+				{
+					entree = POSITION_GAGNEE | (nb_cases - 1 - (entree & AUCUN_COUP_RESOLUES));
+				}
+				positions[rang] = entree;
+				continue;
+			}
+
+			for ( c = 0 ; c < nb_cases ; c++ )
+			{
+				if(contenu[c] != 0)
+				{
+					joue_coup(p, c % p->dim, c / p->dim, (contenu[c] == 1) ? 'N' : 'B');
+				}
+			}
+
+			vainqueur = gagnant(p);
+			if(vainqueur != 'V') // Partie terminée
+			{
+				entree = (vainqueur == joueur) ? POSITION_GAGNEE | AUCUN_COUP_RESOLUES : AUCUN_COUP_RESOLUES;
+			}
+			else if(s == pions_max)
+			{
+				resultat = resous_position(p, joueur, 0, 0, &coup);
+				if(resultat == DFPN_INCONNU) // (Mémoire insuffisante pour le solveur)
+				{
+					free(positions);
+					return -1;
+				}
+				entree = (resultat == DFPN_GAGNE) ? POSITION_GAGNEE | (coup.y * p->dim + coup.x) : AUCUN_COUP_RESOLUES;
+			}
+			else
+			{
+				entree = AUCUN_COUP_RESOLUES;
+				for ( c = 0 ; c < nb_cases && entree == AUCUN_COUP_RESOLUES ; c++ )
+				{
+					if(contenu[c] == 0)
+					{
+						contenu[c] = couleur;
+						rang_fils = rang_position(contenu, nb_cases, debuts, pions_max);
+						contenu[c] = 0;
+						if(!(positions[rang_fils] & POSITION_GAGNEE)) // Coup gagnant
+						{
+							entree = POSITION_GAGNEE | c;
+						}
+					}
+				}
+			}
+			positions[rang] = entree;
+
+			for ( c = 0 ; c < s ; c++ )
+			{
+				dejoue_coup(p);
+			}
+		}
+
+		// (Debug) On affiche l'avancement de la génération
+		printf("Table %dx%d: positions de %d pions resolues (%u ms)\n", p->dim, p->dim, s, (unsigned int) ((clock() - debut) * 1000 / CLOCKS_PER_SEC));
+	}
+
+	memcpy(entete.signature, SIGNATURE_RESOLUES, sizeof(entete.signature));
+	entete.dimension = p->dim;
+	entete.pions_max = pions_max;
+	entete.nb_positions = debuts[pions_max+1];
+	entete.reserve = 0;
+
+	sprintf(nom, FICHIER_RESOLUES, p->dim, p->dim);
+	fichier = fopen(nom, "wb");
+	if(fichier == NULL || fwrite(&entete, sizeof(entete), 1, fichier) != 1 || fwrite(positions, 1, entete.nb_positions, fichier) != entete.nb_positions)
+	{
+		if(fichier != NULL)
+		{
+			fclose(fichier);
+		}
+		free(positions);
+		return -1;
+	}
+
+	fclose(fichier);
+	free(positions);
+	return 0;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	nom Nom du fichier à projeter
+ *	\param	taille Pointeur sur la taille du fichier, à remplir
+ *	\return	Début de la projection en lecture seule du fichier, ou NULL si elle a échoué
+ */
+static void * projette_fichier(const char *nom, size_t *taille)
+{
+	void *projection = NULL;
+#ifdef _WIN32
+	HANDLE fichier, correspondance;
+	LARGE_INTEGER taille_fichier;
+
+	fichier = CreateFileA(nom, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(fichier == INVALID_HANDLE_VALUE)
+	{
+		return NULL;
+	}
+	if(GetFileSizeEx(fichier, &taille_fichier) && taille_fichier.QuadPart > 0)
+	{
+		correspondance = CreateFileMappingA(fichier, NULL, PAGE_READONLY, 0, 0, NULL);
+		if(correspondance != NULL)
+		{
+			projection = MapViewOfFile(correspondance, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(correspondance); // (La vue garde la correspondance ouverte)
+		}
+		*taille = (size_t) taille_fichier.QuadPart;
+	}
+	CloseHandle(fichier);
+#else
+	struct stat infos;
+	int fichier = open(nom, O_RDONLY);
+
+	if(fichier < 0)
+	{
+		return NULL;
+	}
+	if(fstat(fichier, &infos) == 0 && infos.st_size > 0)
+	{
+		projection = mmap(NULL, infos.st_size, PROT_READ, MAP_SHARED, fichier, 0);
+		if(projection == MAP_FAILED)
+		{
+			projection = NULL;
+		}
+		*taille = infos.st_size;
+	}
+	close(fichier); // (La projection reste valide)
+#endif
+	return projection;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	projection Début de la projection à libérer
+ *	\param	taille Taille de la projection
+ */
+static void libere_projection(void *projection, size_t taille)
+{
+#ifdef _WIN32
+	(void) taille;
+	UnmapViewOfFile(projection);
+#else
+	munmap(projection, taille);
+#endif
+}
+
+/*!
+ *	\author	Julien Laurent
+ *
+ *	Un fichier absent est simplement ignoré (la table de sa dimension n'est alors pas consultée),
+ *	de même qu'un fichier dont l'en-tête ne correspond pas à sa taille.
+ */
+void charge_tables_resolues(void)
+{
+	const entete_resolues *entete;
+	char nom[64];
+	int dim;
+
+	calcule_binomiaux();
+	for ( dim = DIMENSION_MIN_RESOLUES ; dim <= DIMENSION_MAX_RESOLUES ; dim++ )
+	{
+		if(tables[dim] != NULL)
+		{
+			continue;
+		}
+
+		sprintf(nom, FICHIER_RESOLUES, dim, dim);
+		projections[dim] = projette_fichier(nom, &tailles_projections[dim]);
+		if(projections[dim] == NULL)
+		{
+			continue;
+		}
+
+		entete = projections[dim];
+		calcule_debuts(dim * dim, debuts_tables[dim]);
+		if(tailles_projections[dim] < sizeof(entete_resolues) || memcmp(entete->signature, SIGNATURE_RESOLUES, sizeof(entete->signature)) != 0
+			|| entete->dimension != (uint32_t) dim || entete->pions_max > (uint32_t) (dim * dim)
+			|| entete->nb_positions != debuts_tables[dim][entete->pions_max+1]
+			|| tailles_projections[dim] < sizeof(entete_resolues) + entete->nb_positions)
+		{
+			printf("Table %s invalide: ignoree\n", nom);
+			libere_projection(projections[dim], tailles_projections[dim]);
+			projections[dim] = NULL;
+			continue;
+		}
+
+		pions_tables[dim] = entete->pions_max;
+		tables[dim] = (const unsigned char *) (entete + 1);
+		printf("Table %s chargee (positions jusqu'a %d pions)\n", nom, pions_tables[dim]);
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ */
+void libere_tables_resolues(void)
+{
+	int dim;
+
+	for ( dim = DIMENSION_MIN_RESOLUES ; dim <= DIMENSION_MAX_RESOLUES ; dim++ )
+	{
+		if(projections[dim] != NULL)
+		{
+			libere_projection(projections[dim], tailles_projections[dim]);
+			projections[dim] = NULL;
+			tables[dim] = NULL;
+		}
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	actif Vrai pour que les IA consultent les tables
+ */
+void active_tables_resolues(bool actif)
+{
+	tables_actives = actif;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur le plateau à consulter
+ *	\param	joueur Couleur du joueur qui a le trait
+ *	\param	coup Pointeur sur les coordonnées du coup gagnant, à remplir ({-1,-1} si aucun)
+ *	\return	Issue de la position pour le joueur (#DFPN_GAGNE, #DFPN_PERDU ou #DFPN_INCONNU)
+ *
+ *	La position n'est dans la table que si elle a au plus le nombre de pions de la table, et si le
+ *	trait et les nombres de pions de chaque couleur correspondent à une partie commencée par les
+ *	Noirs. Le coût de la consultation ne dépend que du nombre de cases.
+ */
+int consulte_table_resolue(const plateau *p, char joueur, coord *coup)
+{
+	int contenu[NB_CASES_MAX];
+	int x, y, k, pions = bb_compte(p->pions[0]) + bb_compte(p->pions[1]);
+	long rang;
+	unsigned char entree;
+
+	coup->x = coup->y = -1;
+	if(p->dim < DIMENSION_MIN_RESOLUES || p->dim > DIMENSION_MAX_RESOLUES || tables[p->dim] == NULL
+		|| pions > pions_tables[p->dim] || joueur != ((pions % 2 == 0) ? 'N' : 'B'))
+	{
+		return DFPN_INCONNU;
+	}
+
+	for ( y = 0 ; y < p->dim ; y++ )
+	{
+		for ( x = 0 ; x < p->dim ; x++ )
+		{
+			k = indice_case(p, x, y);
+			contenu[y * p->dim + x] = bb_teste(&p->pions[0], k) ? 1 : bb_teste(&p->pions[1], k) ? 2 : 0;
+		}
+	}
+
+	rang = rang_position(contenu, p->dim * p->dim, debuts_tables[p->dim], pions_tables[p->dim]);
+	if(rang < 0)
+	{
+		return DFPN_INCONNU;
+	}
+
+	entree = tables[p->dim][rang];
+	if(!(entree & POSITION_GAGNEE))
+	{
+		return DFPN_PERDU;
+	}
+	if((entree & AUCUN_COUP_RESOLUES) != AUCUN_COUP_RESOLUES)
+	{
+		coup->x = (entree & AUCUN_COUP_RESOLUES) % p->dim;
+		coup->y = (entree & AUCUN_COUP_RESOLUES) / p->dim;
+	}
+	return DFPN_GAGNE;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur le plateau sur lequel l'IA doit jouer
+ *	\param	joueur Couleur du pion joué par l'IA
+ *	\param	coup Pointeur sur les coordonnées du coup gagnant, à remplir (inchangées si la table n'en donne pas)
+ *	\return	Vrai si la table donne un coup gagnant
+ *
+ *	Une position perdue n'est pas jouée depuis la table: l'IA cherche alors elle-même le coup qui
+ *	résiste le mieux (les coordonnées reçues, souvent le coup de secours de l'IA, sont conservées).
+ */
+bool coup_table_resolue(const plateau *p, char joueur, coord *coup)
+{
+	coord gagnant;
+
+	if(!tables_actives || consulte_table_resolue(p, joueur, &gagnant) != DFPN_GAGNE || gagnant.x < 0)
+	{
+		return false;
+	}
+
+	*coup = gagnant;
+	return true;
+}
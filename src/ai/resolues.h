@@ -0,0 +1,71 @@
+/*!
+ *	\file	resolues.h
+ *	\brief	Prototypes des tables de positions résolues
+ *	\author	Julien Laurent
+ *
+ *	Ce fichier contient les déclarations des tables de positions résolues des petits plateaux: pour
+ *	chaque position (jusqu'à un nombre de pions donné), la table indique si le joueur qui a le trait
+ *	gagne, et par quel coup. Les IA y trouvent leur coup sans aucune recherche, et les bancs d'essai
+ *	s'en servent d'oracle pour juger les coups des autres IA.
+ *	Les tables sont calculées une fois pour toutes par #genere_table_resolue(), hors partie, par le
+ *	programme outils/genere_resolues.c (la table 5x5 demande un quart d'heure de calcul). Elles sont écrites
+ *	dans un fichier par dimension, puis projetées en mémoire au démarrage par #charge_tables_resolues()
+ *	(le système ne lit que les pages consultées). Le jeu est fourni avec la table 5x5; la table 4x4
+ *	ne sert que d'oracle aux bancs d'essai, le jeu ne proposant pas de plateau 4x4.
+ *	Une position est repérée par son rang parmi les positions de même nombre de pions (système de
+ *	numération combinatoire): l'ensemble des cases occupées, puis celui des pions noirs parmi elles.
+ *	Ce rang est un hachage parfait et minimal: chaque position possible (les Noirs commençant) a sa
+ *	propre entrée, et il n'y a aucune entrée inutilisée.
+ */
+
+#ifndef RESOLUES_H_INCLUDED
+#define RESOLUES_H_INCLUDED
+
+#include "dfpn.h"
+
+#define DIMENSION_MIN_RESOLUES 4 ///< Plus petite dimension des tables de positions résolues
+#define DIMENSION_MAX_RESOLUES 5 ///< Plus grande dimension des tables de positions résolues
+#define PIONS_MAX_RESOLUES_4 16 ///< Nombre maximal de pions des positions de la table 4x4 (toutes les positions: oracle des bancs d'essai seulement)
+#define PIONS_MAX_RESOLUES_5 6 ///< Nombre maximal de pions des positions de la table 5x5 (ouvertures: au-delà, le solveur DFPN conclut en quelques millisecondes)
+#define FICHIER_RESOLUES "resolues_%dx%d.bin" ///< Nom du fichier de la table de chaque dimension (dans le répertoire d'où le jeu est lancé, comme save.hex et le répertoire images)
+#define SIGNATURE_RESOLUES "HEXRES01" ///< Signature des fichiers de tables de positions résolues
+
+#define POSITION_GAGNEE 0x80 ///< Bit d'une entrée indiquant que le joueur qui a le trait gagne
+#define AUCUN_COUP_RESOLUES 0x7F ///< Coup d'une entrée perdue (ou d'une partie déjà gagnée)
+
+/*!
+ *	\brief	En-tête d'un fichier de table de positions résolues
+ *	\author	Julien Laurent
+ *
+ *	L'en-tête est suivi d'un octet par position: #POSITION_GAGNEE si le joueur qui a le trait gagne,
+ *	et le coup gagnant (case y * dim + x) dans les 7 bits de poids faible (#AUCUN_COUP_RESOLUES sinon).
+ */
+struct entete_resolues
+{
+	char signature[8]; ///< #SIGNATURE_RESOLUES
+	uint32_t dimension; ///< Dimension du plateau
+	uint32_t pions_max; ///< Nombre maximal de pions des positions de la table
+	uint32_t nb_positions; ///< Nombre de positions (d'octets) qui suivent l'en-tête
+	uint32_t reserve; ///< Inutilisé (alignement)
+};
+typedef struct entete_resolues entete_resolues; ///< Raccourci d'utilisation du type #entete_resolues
+
+/// Résout toutes les positions du plateau (vide) donné jusqu'au nombre de pions donné, et écrit la table de sa dimension dans son fichier (0 en cas de succès, -1 sinon)
+int genere_table_resolue(plateau *p, int pions_max);
+
+/// Projette en mémoire les fichiers de tables présents (à appeler au démarrage)
+void charge_tables_resolues(void);
+
+/// Libère les tables projetées en mémoire
+void libere_tables_resolues(void);
+
+/// Active (par défaut) ou désactive la consultation des tables par les IA (les bancs d'essai y gardent accès par #consulte_table_resolue())
+void active_tables_resolues(bool actif);
+
+/// Renvoie l'issue de la position pour le joueur qui a le trait d'après les tables (#DFPN_GAGNE, #DFPN_PERDU, ou #DFPN_INCONNU si elle n'y est pas), et donne le coup gagnant s'il y en a un
+int consulte_table_resolue(const plateau *p, char joueur, coord *coup);
+
+/// Renvoie vrai si les tables (si elles sont activées) donnent un coup gagnant pour le joueur, et le donne
+bool coup_table_resolue(const plateau *p, char joueur, coord *coup);
+
+#endif // RESOLUES_H_INCLUDED
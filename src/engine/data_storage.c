@@ -111,7 +111,7 @@ int charge_partie(plateau **p, joueur **J1, joueur **J2, int *difficulte, int *n
 	FILE *container = fopen("save.hex","r");
 
 	int i,j, type_j1, type_j2, taille;
-	char pion_j1, pion_j2, pion_courant;
+	char pion_j1, pion_j2, pion_courant, pion_lu;
 
 	if(container == NULL) // Si l'ouverture a échoué, on renvoie un code d'erreur
 	{
@@ -146,7 +146,8 @@ int charge_partie(plateau **p, joueur **J1, joueur **J2, int *difficulte, int *n
 		{
 			for ( j = 0 ; j < (*p)->dim ; j++ )
 			{
-				fread(&((*p)->tab[i][j]), sizeof(char), 1, container);
+				fread(&pion_lu, sizeof(char), 1, container);
+				pose_pion(*p, j, i, pion_lu); // (Mise à jour des bitboards en même temps que la matrice)
 			}
 		}
 
@@ -39,6 +39,22 @@ joueur * nouveau_joueur(char couleur, int type)
 			nj->joue = ia_losanges; // Le joueur est une IA de type Losanges (réfléchit à l'aide des bridges)
 		break;
 
+		case 3:
+			nj->joue = ia_electrique; // Le joueur est une IA de type Electrique (réfléchit à l'aide de la résistance du plateau)
+		break;
+
+		case 4:
+			nj->joue = ia_monte_carlo; // Le joueur est une IA de type Roulette (simule des parties au hasard)
+		break;
+
+		case 5:
+			nj->joue = ia_solveur; // Le joueur est une IA de type Solveur (prouve la victoire quand il le peut)
+		break;
+
+		case 6:
+			nj->joue = ia_deux_distances; // Le joueur est une IA de type Distances (réfléchit à l'aide des doubles distances aux bords)
+		break;
+
 		default:
 			nj->joue = ia_hasard;
 		break;
@@ -90,6 +106,18 @@ int type_joueur(joueur *J_type)
 	{
 		return 3;
 	}
+	else if(J_type->joue == ia_monte_carlo)
+	{
+		return 4;
+	}
+	else if(J_type->joue == ia_solveur)
+	{
+		return 5;
+	}
+	else if(J_type->joue == ia_deux_distances)
+	{
+		return 6;
+	}
 	else
 	{
 		return 0;
@@ -105,7 +133,7 @@ int type_joueur(joueur *J_type)
  */
 plateau * nouveau_plateau(int dim)
 {
-	if(dim < 0)	// (Sécurité anti-idioties)
+	if(dim < 0 || dim > DIM_MAX)	// (Sécurité anti-idioties)
 	{
 		return NULL;
 	}
@@ -122,13 +150,6 @@ plateau * nouveau_plateau(int dim)
 		np->tab[i] = malloc(dim * sizeof(char)); // Initialisation des colonnes du plateau
 	}
 
-	// La matrice booléenne sert à éviter les boucles infinies lors des parcours récursifs:
-	np->checked = malloc(dim * sizeof(bool *)); // Initialisation des lignes de la matrice booléenne
-	for (i = 0 ; i < dim ; i++)
-	{
-		np->checked[i] = malloc(dim * sizeof(bool)); // Initialisation des colonnes de la matrice booléenne
-	}
-
 	/*np->valeurN = malloc(dim * sizeof(int *)); // Initialisation des lignes de la matrice booléenne
 	for (i = 0 ; i < dim ; i++)
 	{
@@ -150,6 +171,37 @@ plateau * nouveau_plateau(int dim)
 		}
 	}
 
+	// Les bitboards sont vides au départ, seuls les masques de cases et de frontières sont remplis:
+	np->largeur = dim + 2;
+	np->topo = topologie_plateau(dim); // (Seule la première construction de cette dimension la calcule)
+	np->pions[0] = bb_nul();
+	np->pions[1] = bb_nul();
+	np->cases = bb_nul();
+	for ( i = 0 ; i < 4 ; i++ )
+	{
+		np->bords[i] = bb_nul();
+	}
+
+	for ( i = 0 ; i < dim ; i++ )
+	{
+		for ( j = 0 ; j < dim ; j++ )
+		{
+			bb_place(&np->cases, indice_case(np, j, i));
+		}
+		bb_place(&np->bords[0], indice_case(np, i, 0)); // Frontière noire du haut
+		bb_place(&np->bords[1], indice_case(np, i, dim-1)); // Frontière noire du bas
+		bb_place(&np->bords[2], indice_case(np, 0, i)); // Frontière blanche de gauche
+		bb_place(&np->bords[3], indice_case(np, dim-1, i)); // Frontière blanche de droite
+	}
+
+	connexite_initialise(&np->groupes, dim*dim); // Aucun groupe n'est formé sur un plateau vide
+	np->nb_coups = 0; // Et l'historique des coups est vide
+
+	initialise_zobrist(); // (Seule la première construction remplit la table des clés)
+	np->cle = 0; // La clé d'un plateau vide est nulle
+	np->scores_losanges[0] = np->scores_losanges[1] = 0; // (Ainsi que ses scores)
+	np->scores_connexions[0] = np->scores_connexions[1] = 0;
+
 	/*for ( i = 0 ; i < dim ; i++ )
 	{
 		for ( j = 0 ; j<dim+1/2 ; j++)
@@ -177,12 +229,6 @@ void detruis_plateau(plateau **p_det)
 
 	if(*p_det != NULL)	// On ne peut détruire un plateau que s'il existe.
 	{
-		for ( i = 0 ; i < (*p_det)->dim ; i++ ) // Destruction du tableau de booléens
-		{
-			free((*p_det)->checked[i]);
-		}
-		free((*p_det)->checked);
-
 		for ( i = 0 ; i < (*p_det)->dim ; i++ ) // Destruction du tableau de pions
 		{
 			free((*p_det)->tab[i]);
@@ -242,7 +288,7 @@ char lance_partie(plateau *jeu, joueur *J1, joueur *J2, int difficulte, int *num
 		// Si le signal de sauvegarde est reçu, on le renvoie à la fonction appelante
 		if((a_placer.x==-1)&&(a_placer.y==-1)) return 'S';
 
-		jeu->tab[(int)a_placer.y][(int)a_placer.x] = (*joueur_courant)->pion; // Placement du pion correspondant dans la case demandée
+		joue_coup(jeu, a_placer.x, a_placer.y, (*joueur_courant)->pion); // Placement du pion correspondant dans la case demandée
 
 		if(difficulte <= 8)	// La difficulté "Nash 2 en 1" implique l'incapacité, pour l'humain,
 		{					// de voir les pions actuellement en jeu.
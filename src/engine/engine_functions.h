@@ -14,6 +14,10 @@
 #include "../interfaces/graph_menus.h"
 //#include "console_display.h" // Inusité (migration vers SDL!)
 #include "../ai/ai.h"
+#include "../ai/mcts.h"
+#include "../ai/dfpn.h"
+#include "../ai/resolues.h"
+#include "../ai/ouvertures.h"
 
 plateau * nouveau_plateau(int dim); ///< Crée un nouveau plateau, de la dimension passée en paramètre
 void detruis_plateau(plateau **p_det); ///< Détruit le plateau pointé par le pointeur dont l'adresse est passée en paramètre
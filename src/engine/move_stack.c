@@ -0,0 +1,68 @@
+/*!
+ *	\file	move_stack.c
+ *	\brief	Fonctions de jeu et d'annulation de coups
+ *	\author	Julien Laurent
+ *
+ *	Définitions de la couche "jouer / déjouer un coup" du moteur. Chaque coup est empilé dans
+ *	l'historique du plateau: son annulation se fait donc toujours dans l'ordre inverse des poses,
+ *	ce qui permet aux structures incrémentales (comme les groupes connexes) de revenir exactement
+ *	à leur état précédent sans recalcul.
+ */
+
+#include "move_stack.h"
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur le plateau à modifier
+ *	\param	x Abscisse matricielle de la case à jouer
+ *	\param	y Ordonnée matricielle de la case à jouer
+ *	\param	pion Pion à poser ('N' ou 'B')
+ *	\pre	La case doit exister et être vide.
+ */
+void joue_coup(plateau *p, int x, int y, char pion)
+{
+	coup_joue *coup = &p->historique[p->nb_coups++]; // On empile le coup,
+
+	coup->x = x;
+	coup->y = y;
+	coup->pion = pion;
+
+	pose_pion(p, x, y, pion); // puis on le joue (mise à jour des bitboards et des groupes)
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur le plateau à modifier
+ *
+ *	Dépile le dernier coup de l'historique et vide la case correspondante. Le coup étant le dernier
+ *	posé, #pose_pion() annule simplement ses effets sur les groupes connexes.
+ */
+void dejoue_coup(plateau *p)
+{
+	if(p->nb_coups <= 0) // (Sécurité anti-idioties)
+	{
+		return;
+	}
+
+	coup_joue *coup = &p->historique[--p->nb_coups];
+
+	pose_pion(p, coup->x, coup->y, 'V');
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur le plateau à consulter
+ *	\return	Coordonnées du dernier coup joué, ou {-1, -1} si l'historique est vide
+ */
+coord dernier_coup(const plateau *p)
+{
+	coord c = {-1, -1};
+
+	if(p->nb_coups > 0)
+	{
+		c.x = p->historique[p->nb_coups-1].x;
+		c.y = p->historique[p->nb_coups-1].y;
+	}
+
+	return c;
+}
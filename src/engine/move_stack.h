@@ -0,0 +1,27 @@
+/*!
+ *	\file	move_stack.h
+ *	\brief	Prototypes des fonctions de jeu et d'annulation de coups
+ *	\author	Julien Laurent
+ *
+ *	Ce fichier déclare la couche "jouer / déjouer un coup" du moteur. Toute modification du plateau
+ *	pendant une partie ou la construction d'un arbre de jeu passe par ces deux fonctions, qui tiennent
+ *	à jour l'ensemble de l'état dérivé du plateau (bitboards, groupes connexes, historique des coups...)
+ *	Contrairement à engine_functions.h, ce fichier ne dépend pas de l'interface graphique: il peut donc
+ *	être inclus par les modules d'intelligence artificielle.
+ */
+
+#ifndef MOVE_STACK_H_INCLUDED
+#define MOVE_STACK_H_INCLUDED
+
+#include "../model/data_models.h"
+
+/// Joue le pion donné sur la case (vide) aux coordonnées données, et empile le coup dans l'historique
+void joue_coup(plateau *p, int x, int y, char pion);
+
+/// Annule le dernier coup joué par #joue_coup()
+void dejoue_coup(plateau *p);
+
+/// Renvoie le dernier coup de l'historique du plateau ({-1, -1} si l'historique est vide)
+coord dernier_coup(const plateau *p);
+
+#endif // MOVE_STACK_H_INCLUDED
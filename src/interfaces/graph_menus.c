@@ -7,6 +7,7 @@
  */
 
 #include "graph_menus.h"
+#include "graph_game_ui.h"
 
 
 /*!
@@ -223,20 +224,53 @@ char choix_couleur(SDL_Surface *fond, SDL_Surface *ecran)
 	return couleur;
 }
 
+/*!
+ *	\author	Julien Laurent
+ *	\param	ecran Pointeur sur la surface d'affichage
+ *	\param	nb_pions Nombre de pions du sélecteur (un par processeur, au plus #NB_PIONS_FILS)
+ *	\param	nb_fils Nombre de fils d'exécution choisi (0: autant que de processeurs)
+ *
+ *	Affiche le sélecteur du nombre de fils d'exécution de l'IA, à droite du menu de difficulté:
+ *	un pion par fil utilisable, noir si le fil sera utilisé, blanc sinon.
+ */
+static void affiche_choix_fils(SDL_Surface *ecran, int nb_pions, int nb_fils)
+{
+	int k;
+
+	for ( k = 0 ; k < nb_pions ; k++ )
+	{
+		affiche_pion(ABSCISSE_COIN_FILS + ECART_FILS_X * (k % FILS_PAR_LIGNE), ORDONNEE_COIN_FILS + ECART_FILS_Y * (k / FILS_PAR_LIGNE),
+				ecran, (nb_fils == 0 || k < nb_fils) ? 'N' : 'B');
+	}
+}
+
 /*!
  *	\author	Alexis Brisset
  *	\param	fond Fond à afficher derrière le menu
  *	\param 	ecran Pointeur sur la surface d'affichage
+ *	\param	nb_fils Nombre de fils d'exécution de la recherche de l'IA (0: autant que de processeurs), modifié si l'utilisateur clique sur le sélecteur
  *	\return	Niveau d'IA choisi par l'utilisateur
  *
- *	Affiche les niveaux d'IA disponibles, et interroge l'utilisateur sur son choix
+ *	Affiche les niveaux d'IA disponibles, et interroge l'utilisateur sur son choix.
+ *	Sur une machine à plusieurs processeurs, le nombre de fils d'exécution de la recherche peut
+ *	aussi être choisi en cliquant sur l'un des pions affichés à droite du menu (le k-ième pion
+ *	demande k fils, le dernier demande tous les processeurs).
  */
-int choix_level(SDL_Surface *fond, SDL_Surface *ecran)
+int choix_level(SDL_Surface *fond, SDL_Surface *ecran, int *nb_fils)
 {
-	int choix = -1;
+	int choix = -1, k, nb_pions = nombre_coeurs();
 	SDL_Surface *image = NULL;
 	SDL_Rect positionImage;
 
+	if(nb_pions > NB_PIONS_FILS)
+	{
+		nb_pions = NB_PIONS_FILS;
+	}
+	if(nb_pions < 2) // (Un seul processeur: rien à choisir)
+	{
+		nb_pions = 0;
+	}
+
 	positionImage.x=0;
 	positionImage.y = 0;
 
@@ -246,6 +280,7 @@ int choix_level(SDL_Surface *fond, SDL_Surface *ecran)
 
 	SDL_BlitSurface(fond, NULL, ecran, &positionImage);
 	SDL_BlitSurface(image, NULL, ecran, &positionImage);
+	affiche_choix_fils(ecran, nb_pions, *nb_fils);
 
 	SDL_Flip(ecran);
 
@@ -256,6 +291,19 @@ int choix_level(SDL_Surface *fond, SDL_Surface *ecran)
 	{
 			positionClick = get_click();
 
+			for ( k = 0 ; k < nb_pions ; k++ )
+			{
+				if ((positionClick.x >= ABSCISSE_COIN_FILS + ECART_FILS_X * (k % FILS_PAR_LIGNE)) && (positionClick.x <= ABSCISSE_COIN_FILS + ECART_FILS_X * (k % FILS_PAR_LIGNE) + LARGEUR_PION_FILS)
+					&& (positionClick.y >= ORDONNEE_COIN_FILS + ECART_FILS_Y * (k / FILS_PAR_LIGNE)) && (positionClick.y <= ORDONNEE_COIN_FILS + ECART_FILS_Y * (k / FILS_PAR_LIGNE) + HAUTEUR_PION_FILS))
+				{	// Clic sur le (k+1)-ième pion: on change le nombre de fils, puis on réaffiche le menu
+					*nb_fils = (k == nb_pions - 1) ? 0 : k + 1;
+					SDL_BlitSurface(fond, NULL, ecran, &positionImage);
+					SDL_BlitSurface(image, NULL, ecran, &positionImage);
+					affiche_choix_fils(ecran, nb_pions, *nb_fils);
+					SDL_Flip(ecran);
+				}
+			}
+
 			if ((positionClick.x >= ABSCISSE_COIN_DIFFICULTE) && (positionClick.x <= ABSCISSE_COIN_DIFFICULTE + LARGEUR_MENU_DIFFICULTE) && (positionClick.y >= ORDONNEE_COIN_DIFFICULTE) && (positionClick.y <= ORDONNEE_COIN_DIFFICULTE + HAUTEUR_MENU_DIFFICULTE ))
 			choix = 1; // renvoie le choix du click sur "Facile"
 
@@ -319,9 +367,11 @@ int choix_ia(SDL_Surface *fond, SDL_Surface *ecran)
 			if ((positionClick.x >= ABSCISSE_COIN_IA2) && (positionClick.x <= ABSCISSE_COIN_IA2 + LARGEUR_MENU_IA2) && (positionClick.y >= ORDONNEE_COIN_IA2) && (positionClick.y <= ORDONNEE_COIN_IA2 + HAUTEUR_MENU_IA2 ))
 			ia = 2; // renvoie le choix du click sur "Losanges"
 
-			// IA indisponible pour le moment:
-			//if ((positionClick.x >= ABSCISSE_COIN_IA3) && (positionClick.x <= ABSCISSE_COIN_IA3 + LARGEUR_MENU_IA3) && (positionClick.y >= ORDONNEE_COIN_IA3) && (positionClick.y <= ORDONNEE_COIN_IA3 + HAUTEUR_MENU_IA3 ))
-			//ia = 3; // renvoie le choix du click sur "Electrique"
+			if ((positionClick.x >= ABSCISSE_COIN_IA3) && (positionClick.x <= ABSCISSE_COIN_IA3 + LARGEUR_MENU_IA3) && (positionClick.y >= ORDONNEE_COIN_IA3) && (positionClick.y <= ORDONNEE_COIN_IA3 + HAUTEUR_MENU_IA3 ))
+			ia = 3; // renvoie le choix du click sur "Electrique"
+
+			if ((positionClick.x >= ABSCISSE_COIN_IA5) && (positionClick.x <= ABSCISSE_COIN_IA5 + LARGEUR_MENU_IA5) && (positionClick.y >= ORDONNEE_COIN_IA5) && (positionClick.y <= ORDONNEE_COIN_IA5 + HAUTEUR_MENU_IA5))
+			ia = 4; // renvoie le choix du click sur "Roulette"
 
 			if ((positionClick.x >= ABSCISSE_COIN_IA4) && (positionClick.x <= ABSCISSE_COIN_IA4 + LARGEUR_MENU_IA4) && (positionClick.y >= ORDONNEE_COIN_IA4) && (positionClick.y <= ORDONNEE_COIN_IA4 + HAUTEUR_MENU_IA4))
 			ia = 0; // renvoie le choix du click sur "Retour"
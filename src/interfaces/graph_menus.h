@@ -53,6 +53,11 @@
 #define LARGEUR_MENU_IA3 277
 #define HAUTEUR_MENU_IA3 56
 
+#define ABSCISSE_COIN_IA5 503
+#define ORDONNEE_COIN_IA5 634
+#define LARGEUR_MENU_IA5 277
+#define HAUTEUR_MENU_IA5 56
+
 #define ABSCISSE_COIN_IA4 540
 #define ORDONNEE_COIN_IA4 710
 #define LARGEUR_MENU_IA4 202
@@ -88,6 +93,15 @@
 #define LARGEUR_MENU_DIFFICULTE6 202
 #define HAUTEUR_MENU_DIFFICULTE6 45
 
+#define ABSCISSE_COIN_FILS 830
+#define ORDONNEE_COIN_FILS 364
+#define ECART_FILS_X 70
+#define ECART_FILS_Y 68
+#define LARGEUR_PION_FILS 64
+#define HAUTEUR_PION_FILS 53
+#define FILS_PAR_LIGNE 4
+#define NB_PIONS_FILS 8
+
 #define ABSCISSE_COIN_COULEUR 450
 #define ORDONNEE_COIN_COULEUR 402
 #define LARGEUR_MENU_COULEUR 378
@@ -169,8 +183,8 @@ int choix_dimension(SDL_Surface *fond, SDL_Surface *ecran);
 /// Demande la couleur de pion du joueur, puis la renvoie
 char choix_couleur(SDL_Surface *fond, SDL_Surface *ecran);
 
-/// Demande le niveau de difficulté de l'IA, puis le renvoie
-int choix_level(SDL_Surface *fond, SDL_Surface *ecran);
+/// Demande le niveau de difficulté de l'IA (et le nombre de fils d'exécution de sa recherche), puis le renvoie
+int choix_level(SDL_Surface *fond, SDL_Surface *ecran, int *nb_fils);
 
 /// Demande le type d'Intelligence Artificielle au joueur, puis le renvoie
 int choix_ia(SDL_Surface *fond, SDL_Surface *ecran);
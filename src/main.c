@@ -64,6 +64,45 @@
 /// Fonction de benchmarking pour le système de mise en cache des plateaux (compte et affiche le nombre de collisions de la fonction de hachage)
 void collisionTestBed(int dimension, int iterations);
 
+/// Fonction de benchmarking pour l'ordonnancement des coups de l'AlphaBeta (compte et affiche le nombre de nœuds cherchés jusqu'à un horizon fixe)
+void ordonnancementTestBed(int dimension, int horizon, int positions);
+
+/// Fonction de benchmarking pour la recherche parallèle (mesure le temps de recherche jusqu'à un horizon fixe selon le nombre de fils)
+void parallelismeTestBed(int dimension, int horizon, int positions);
+
+/// Fonction de benchmarking pour la recherche Monte-Carlo parallèle (mesure le nombre de simulations par seconde selon le nombre de fils)
+void monteCarloTestBed(int dimension, unsigned int duree);
+
+/// Fonction de benchmarking pour le noyau de parties aléatoires (mesure le nombre de parties par seconde pour chaque dimension de plateau)
+void simulationTestBed(int iterations);
+
+/// Fonction de benchmarking pour l'évaluation par double distance (vérifie la mise à jour incrémentale des cartes, et mesure son apport)
+void deuxDistancesTestBed(int dimension, int evaluations);
+
+/// Fonction de benchmarking pour les connexions virtuelles (compte et affiche le nombre de nœuds cherchés jusqu'à un horizon fixe, avec et sans elles)
+void connexionsTestBed(int dimension, int pions, int horizon, int positions);
+
+/// Fonction de benchmarking pour l'élagage des cases inférieures (compte et affiche le nombre de nœuds cherchés jusqu'à un horizon fixe, avec et sans lui)
+void inferieuresTestBed(int dimension, int pions, int horizon, int positions);
+
+/// Fonction de benchmarking pour le solveur DFPN (résout des positions aléatoires, et affiche le nombre de positions prouvées, de nœuds cherchés et le temps total)
+void solveurTestBed(int dimension, int pions, int positions, unsigned int duree_max);
+
+/// Fonction de vérification des tables de positions résolues (compare la table chargée d'une dimension avec le solveur DFPN sur des positions aléatoires)
+void tablesResoluesTestBed(int dimension, int pions_max, int verifications);
+
+/// Fonction de benchmarking utilisant les tables de positions résolues comme oracle (compte les coups perdants des IA dans des positions gagnées)
+void oracleTestBed(int dimension, int pions, int positions, int level);
+
+/// Fonction de génération des livres d'ouvertures (génère le livre d'une dimension, le charge, puis mesure le temps du premier coup avec et sans lui)
+void ouverturesTestBed(int dimension, int pions_max, int level);
+
+/// Fonction de benchmarking pour la réutilisation de l'arbre Monte-Carlo (compte les simulations héritées d'un coup à l'autre au cours de parties Roulette contre Roulette)
+void reutilisationTestBed(int dimension, int parties, unsigned int duree);
+
+/// Fonction de vérification et de benchmarking de l'évaluation incrémentale par les losanges (compare les sommes tenues à jour par pose_pion() au calcul complet sur toutes les positions d'un petit plateau, puis mesure le temps des deux évaluations)
+void losangesTestBed(int exhaustive, int dimension, int evaluations);
+
 
 /*!
  *	\brief	Fonction principale du logiciel
@@ -87,6 +126,9 @@ int main(int argc, char *argv[])
 	tableNoire = NULL; // Mise à NULL des pointeurs vers les tables de condensats
 	tableBlanche = NULL;
 
+	charge_tables_resolues(); // Projection en mémoire des tables de positions résolues (si elles ont été générées)
+	charge_livres_ouvertures(); // Chargement des livres d'ouvertures (s'ils ont été générés)
+
 	SDL_Surface *ecran = initFenetre(); // Initialisation de la fenêtre et préparation du pointeur associé
 	SDL_Surface *fond = NULL; // Pointeur sur la surface servant de "fond d'écran" (décor)
 
@@ -97,6 +139,7 @@ int main(int argc, char *argv[])
 	int difficulte_choisie = -1;
 	int type_de_jeu_choisi = -1;
 	int ia_choisie = -1;
+	int nombre_fils_choisi = 0; // (0: autant de fils d'exécution que de processeurs)
 	char couleur_joueur_humain = 'V';
 
 	/*
@@ -117,6 +160,20 @@ int main(int argc, char *argv[])
 	// L'instruction qui suit effectue un test de collisions au démarrage
 	// (à commenter pour les versions de production)
 	//collisionTestBed(5,1000);
+	//ordonnancementTestBed(7,3,10);
+	//parallelismeTestBed(7,5,5);
+	//monteCarloTestBed(11,2000);
+	//simulationTestBed(1000000);
+	//deuxDistancesTestBed(11,100000);
+	//connexionsTestBed(7,14,4,10);
+	//inferieuresTestBed(7,14,4,10);
+	//solveurTestBed(7,12,10,10000);
+	//tablesResoluesTestBed(4,PIONS_MAX_RESOLUES_4,1000); // (Table générée par outils/genere_resolues.c)
+	//tablesResoluesTestBed(5,PIONS_MAX_RESOLUES_5,1000);
+	//oracleTestBed(5,4,20,4);
+	//ouverturesTestBed(7,2,8);
+	//reutilisationTestBed(11,2,500);
+	//losangesTestBed(4,11,1000000);
 
 	// On crée un curseur d'étapes, et on l'initialise au premier menu:
 	etape_menu etape = MENU_PRINCIPAL;
@@ -166,22 +223,12 @@ int main(int argc, char *argv[])
 				{
 					etape = MENU_PRINCIPAL; // On repasse à l'étape précédente
 				}
-				else if(dimension_choisie <= 7) // Si la dimension est acceptable pour une IA:
-				{
+				else // Toutes les dimensions sont jouables par une IA (au-delà de DIMENSION_MAX_LOSANGES, le bouton
+				{	 // Losanges donne l'IA à double distance, voir CHOIX_TYPE_IA)
 					detruis_plateau(&jeu); // On détruit l'éventuel plateau précédemment créé (en cas de retour par exemple)
 					jeu = nouveau_plateau(dimension_choisie); // On en crée un nouveau, adapté au dernier choix effectué
 					etape = CHOIX_TYPE_DE_JEU; // On passe à l'étape suivante
 				}
-				else // Si la dimension est trop grande pour laisser une IA jouer:
-				{
-					detruis_plateau(&jeu); // On détruit les éventuels plateaux et joueurs précédemment construits
-					detruis_joueur(&J1);
-					detruis_joueur(&J2);
-					jeu = nouveau_plateau(dimension_choisie); // On crée le nouveau plateau, adapté au dernier choix effectué
-					J1 = nouveau_joueur('N', 0); // Puis on configure une partie de type "humain contre humain",
-					J2 = nouveau_joueur('B', 0); // car la dimension est trop élevée pour faire intervenir l'IA
-					etape = LANCEMENT_PARTIE; // On lance la partie nouvellement configurée
-				}
 			break;
 
 			case CHOIX_TYPE_DE_JEU: // Choix du type de partie:
@@ -240,6 +287,19 @@ int main(int argc, char *argv[])
 						break;						// être réglée.
 
 						case 2: // Losanges
+							if(jeu->dim > DIMENSION_MAX_LOSANGES) // Plateau trop grand pour les losanges: l'IA évalue les
+							{									 // positions par double distance
+								ia_choisie = 6;
+							}
+							// (Puis même traitement que pour les IA Electrique et Roulette)
+							/* FALLTHRU */
+						case 3: // Electrique
+							if(ia_choisie == 3 && jeu->dim <= DIMENSION_MAX_SOLVEUR) // Petit plateau: l'IA cherche d'abord
+							{														 // à prouver sa victoire
+								ia_choisie = 5;
+							}
+							/* FALLTHRU */
+						case 4: // Roulette
 							detruis_joueur(&J2);
 							J2 = nouveau_joueur(couleur_opposee(couleur_joueur_humain), ia_choisie);
 							etape = CHOIX_NIVEAU_IA;
@@ -264,6 +324,19 @@ int main(int argc, char *argv[])
 						break;
 
 						case 2: // Losange
+							if(jeu->dim > DIMENSION_MAX_LOSANGES) // Plateau trop grand pour les losanges: l'IA évalue les
+							{									 // positions par double distance
+								ia_choisie = 6;
+							}
+							// (Puis même traitement que pour les IA Electrique et Roulette)
+							/* FALLTHRU */
+						case 3: // Electrique
+							if(ia_choisie == 3 && jeu->dim <= DIMENSION_MAX_SOLVEUR) // Petit plateau: l'IA cherche d'abord
+							{														 // à prouver sa victoire
+								ia_choisie = 5;
+							}
+							/* FALLTHRU */
+						case 4: // Roulette
 							detruis_joueur(&J1);
 							detruis_joueur(&J2);
 							J1 = nouveau_joueur('N', ia_choisie);
@@ -276,33 +349,35 @@ int main(int argc, char *argv[])
 			break;
 
 			case CHOIX_NIVEAU_IA:
-				switch(difficulte_choisie = choix_level(fond, ecran))
+				difficulte_choisie = choix_level(fond, ecran, &nombre_fils_choisi);
+				fixe_nombre_fils(nombre_fils_choisi);
+				switch(difficulte_choisie)
 				{
 					case 0: // Retour
 						etape = CHOIX_TYPE_IA;
 					break;
 
-					case 1: // Facile
+					case 1: // Facile (0,5 s de réflexion par coup)
 						difficulte_choisie = 5;
 						etape = LANCEMENT_PARTIE;
 					break;
 
-					case 2: // Moyen
+					case 2: // Moyen (1 s de réflexion par coup)
 						difficulte_choisie = 6;
 						etape = LANCEMENT_PARTIE;
 					break;
 
-					case 3: // Difficile
+					case 3: // Difficile (2 s de réflexion par coup)
 						difficulte_choisie = 7;
 						etape = LANCEMENT_PARTIE;
 					break;
 
-					case 4: // Nash
+					case 4: // Nash (4 s de réflexion par coup)
 						difficulte_choisie = 8;
 						etape = LANCEMENT_PARTIE;
 					break;
 
-					case 5: // Nash 2 en 1
+					case 5: // Nash 2 en 1 (8 s de réflexion par coup)
 						difficulte_choisie = 9;
 						etape = LANCEMENT_PARTIE;
 					break;
@@ -379,6 +454,8 @@ int main(int argc, char *argv[])
 				SDL_FreeSurface(ecran);
 
 				detruisTables();
+				libere_tables_resolues();
+				libere_livres_ouvertures();
 
 				SDL_Quit();
 			break;
@@ -397,13 +474,15 @@ int main(int argc, char *argv[])
  *
  *	Cette fonction crée des configurations aléatoires (et pas forcément valides)
  *	de plateaux, et teste la fonction de mise en cache de l'IA pour vérifier
- *	si des collisions se présentent (entre des plateaux non-équivalents)
+ *	si des collisions se présentent (entre des plateaux non-équivalents).
+ *	Elle vérifie aussi que la clé de Zobrist tenue à jour par #pose_pion()
+ *	correspond bien à celle recalculée entièrement par #calculeHash().
  */
 void collisionTestBed(int dimension, int iterations)
 {
 	if(iterations<=0) return;
 
-	int i,j, valeurN,valeurB, collisions=0;
+	int i,j, valeurN,valeurB, collisions=0, desynchronisations=0;
 	plateau *p;
 
 	p = nouveau_plateau(dimension);
@@ -420,15 +499,15 @@ void collisionTestBed(int dimension, int iterations)
 				switch(hasard(0,2))
 				{
 					case 0:
-						p->tab[i][j]='V';
+						pose_pion(p, j, i, 'V');
 					break;
 
 					case 1:
-						p->tab[i][j]='N';
+						pose_pion(p, j, i, 'N');
 					break;
 
 					case 2:
-						p->tab[i][j]='B';
+						pose_pion(p, j, i, 'B');
 					break;
 				}
 			}
@@ -437,6 +516,7 @@ void collisionTestBed(int dimension, int iterations)
 		valeurB = hashLosanges(p, 'B');
 		if(valeurN != eval_losanges(p,'N')) collisions++;
 		if(valeurB != eval_losanges(p,'B')) collisions++;
+		if(p->cle != calculeHash(p)) desynchronisations++;
 
 		iterations--;
 	}while(iterations>0);
@@ -444,6 +524,885 @@ void collisionTestBed(int dimension, int iterations)
 	detruisTables();
 
 	printf("Nombre de collisions: %d\n", collisions);
+	printf("Nombre de cles desynchronisees: %d\n", desynchronisations);
+
+	return;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	dimension Dimension du plateau à créer
+ *	\param	pions Nombre de pions à placer (alternativement par les deux couleurs, les Noirs en premier)
+ *	\param	coups Coups joués, à renseigner (NULL s'ils ne sont pas utiles)
+ *	\return	Pointeur sur le plateau nouvellement créé
+ *
+ *	Tire une position aléatoire sans partie déjà gagnée: la position est recommencée dès que l'un
+ *	des coups fait gagner sa couleur.
+ */
+static plateau * position_aleatoire(int dimension, int pions, coord *coups)
+{
+	int n, x, y;
+	plateau *p = nouveau_plateau(dimension);
+
+	for ( n = 0 ; n < pions ; n++ )
+	{
+		do
+		{
+			x = hasard(0, dimension-1);
+			y = hasard(0, dimension-1);
+		}while(case_plateau(p, x, y) != 'V');
+		joue_coup(p, x, y, (n%2) ? 'B' : 'N');
+		if(coups != NULL)
+		{
+			coups[n].x = x;
+			coups[n].y = y;
+		}
+
+		if(gagnant(p) != 'V') // On recommence la position
+		{
+			detruis_plateau(&p);
+			p = nouveau_plateau(dimension);
+			n = -1;
+		}
+	}
+
+	return p;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	dimension Dimension des plateaux à créer pour les tests
+ *	\param	pions Nombre de pions des positions aléatoires
+ *	\param	horizon Horizon (fixe) des recherches
+ *	\param	positions Nombre de positions aléatoires à chercher
+ *	\param	active Fonction qui active ou désactive l'amélioration mesurée
+ *	\param	noeuds Nombre total de nœuds cherchés sans (indice 0) puis avec (indice 1) l'amélioration, à compléter
+ *	\param	duree Temps total (en ms) des recherches sans puis avec l'amélioration, à compléter
+ *	\param	ecarts Nombre de positions dont la valeur de la racine change avec l'amélioration, à renseigner: résultat prouvé sans elle (victoire ou défaite) et perdu avec elle (indice 0), résultat prouvé seulement avec elle (indice 1), et autres valeurs différentes (indice 2)
+ *
+ *	Tire des positions aléatoires (les mêmes pour les deux séries), puis les fait chercher par l'IA
+ *	Losanges jusqu'à l'horizon donné, avec un seul fil (pour des décomptes reproductibles), sans
+ *	puis avec l'amélioration. Les tables sont remises à zéro avant chaque recherche, pour que les
+ *	deux séries partent des mêmes conditions. L'amélioration est réactivée à la fin.
+ *	Une amélioration ne doit pas changer le résultat de la recherche: les valeurs de la racine des
+ *	deux séries sont comparées. Seules les connexions virtuelles et le remplissage des cases
+ *	inférieures peuvent prouver une victoire (ou une défaite) au-delà de l'horizon: un résultat
+ *	prouvé seulement avec l'amélioration n'est donc pas une erreur, au contraire d'un résultat
+ *	prouvé sans elle et perdu avec elle.
+ */
+static void compare_noeuds(int dimension, int pions, int horizon, int positions, void (*active)(bool), unsigned long noeuds[2], unsigned int duree[2], int ecarts[3])
+{
+	int i, n, mode;
+	unsigned int debut;
+	coord (*coups)[DIM_MAX*DIM_MAX] = malloc(positions * sizeof(*coups));
+	int (*valeurs)[2] = malloc(positions * sizeof(*valeurs));
+	plateau *p;
+
+	for ( i = 0 ; i < positions ; i++ )
+	{
+		p = position_aleatoire(dimension, pions, coups[i]);
+		detruis_plateau(&p);
+	}
+
+	fixe_budget_recherche(0, 0, horizon);
+	fixe_nombre_fils(1);
+	for ( mode = 0 ; mode < 2 ; mode++ )
+	{
+		active(mode == 1);
+		for ( i = 0 ; i < positions ; i++ )
+		{
+			p = nouveau_plateau(dimension);
+			for ( n = 0 ; n < pions ; n++ )
+			{
+				joue_coup(p, coups[i][n].x, coups[i][n].y, (n%2) ? 'B' : 'N');
+			}
+
+			detruisTables();
+			initTables();
+			debut = SDL_GetTicks();
+			ia_losanges(*p, (pions%2) ? 'B' : 'N', 0);
+			duree[mode] += SDL_GetTicks() - debut;
+			noeuds[mode] += noeuds_recherche();
+			valeurs[i][mode] = valeur_recherche();
+
+			detruis_plateau(&p);
+		}
+	}
+	active(true);
+	fixe_budget_recherche(0, 0, -1);
+	fixe_nombre_fils(0);
+	detruisTables();
+
+	ecarts[0] = ecarts[1] = ecarts[2] = 0;
+	for ( i = 0 ; i < positions ; i++ )
+	{
+		if(valeurs[i][0] == valeurs[i][1])
+		{
+			continue;
+		}
+		else if(vabs(valeurs[i][0]) >= 100) // Résultat prouvé sans l'amélioration
+		{
+			ecarts[0]++;
+		}
+		else if(vabs(valeurs[i][1]) >= 100) // Résultat prouvé seulement avec elle
+		{
+			ecarts[1]++;
+		}
+		else
+		{
+			ecarts[2]++;
+		}
+	}
+
+	free(valeurs);
+	free(coups);
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	ecarts Écarts des valeurs de la racine relevés par #compare_noeuds()
+ */
+static void affiche_ecarts(const int ecarts[3])
+{
+	printf("\tValeurs de la racine: %d resultats prouves perdus (doit etre nul), %d resultats prouves en plus, %d autres ecarts\n",
+			ecarts[0], ecarts[1], ecarts[2]);
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	dimension Dimension des plateaux à créer pour les tests
+ *	\param	horizon Horizon (fixe) des recherches
+ *	\param	positions Nombre de positions aléatoires à chercher
+ *
+ *	Cette fonction crée des positions aléatoires de début de partie (autant de pions que la
+ *	dimension du plateau), puis les fait chercher par l'IA Losanges jusqu'à l'horizon donné,
+ *	sans puis avec l'ordonnancement des coups. Le nombre total de nœuds cherchés dans chaque
+ *	cas mesure l'efficacité des coupures de l'AlphaBeta. Les tables sont remises à zéro avant
+ *	chaque recherche, pour que les deux séries partent des mêmes conditions.
+ */
+void ordonnancementTestBed(int dimension, int horizon, int positions)
+{
+	if(positions<=0) return;
+
+	int ecarts[3];
+	unsigned int duree[2] = {0, 0};
+	unsigned long noeuds[2] = {0, 0};
+
+	compare_noeuds(dimension, dimension, horizon, positions, active_ordonnancement, noeuds, duree, ecarts);
+
+	printf("Noeuds cherches (horizon %d, %d positions %dx%d):\n", horizon, positions, dimension, dimension);
+	printf("\tOrdre des cases: %lu\n", noeuds[0]);
+	printf("\tCoups ordonnes: %lu (%.1f fois moins)\n", noeuds[1], noeuds[1] ? (double)noeuds[0] / noeuds[1] : 0.0);
+	affiche_ecarts(ecarts);
+
+	return;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	dimension Dimension des plateaux à créer pour les tests
+ *	\param	horizon Horizon (fixe) des recherches
+ *	\param	positions Nombre de positions aléatoires à chercher
+ *
+ *	Cette fonction fait chercher des positions aléatoires de début de partie jusqu'à l'horizon
+ *	donné, avec 1, 2, 4, 8 puis 16 fils d'exécution, dans chacun des deux modes de recherche
+ *	parallèle (répartition de la racine, et "Lazy SMP"). Elle affiche pour chaque cas le temps
+ *	total, l'accélération par rapport à un seul fil, et le nombre de nœuds cherchés (en "Lazy SMP",
+ *	les nœuds des fils auxiliaires sont comptés, bien que seul le fil principal fixe la durée).
+ */
+void parallelismeTestBed(int dimension, int horizon, int positions)
+{
+	if(positions<=0) return;
+
+	const int nb_fils[5] = {1, 2, 4, 8, 16};
+	int i, n, f, mode;
+	unsigned int debut, duree, reference = 0;
+	unsigned long noeuds;
+	coord (*coups)[DIM_MAX] = malloc(positions * sizeof(*coups));
+	plateau *p;
+
+	// Tirage des positions (les mêmes pour toutes les séries)
+	for ( i = 0 ; i < positions ; i++ )
+	{
+		p = position_aleatoire(dimension, dimension, coups[i]);
+		detruis_plateau(&p);
+	}
+
+	printf("Recherche parallele (horizon %d, %d positions %dx%d, %d processeurs):\n", horizon, positions, dimension, dimension, nombre_coeurs());
+
+	fixe_budget_recherche(0, 0, horizon);
+	for ( mode = PARALLELE_RACINE ; mode <= PARALLELE_LAZY_SMP ; mode++ )
+	{
+		fixe_mode_parallele(mode);
+		printf("\t%s:\n", (mode == PARALLELE_RACINE) ? "Repartition de la racine" : "Lazy SMP");
+
+		for ( f = 0 ; f < 5 ; f++ )
+		{
+			fixe_nombre_fils(nb_fils[f]);
+			duree = 0;
+			noeuds = 0;
+			for ( i = 0 ; i < positions ; i++ )
+			{
+				p = nouveau_plateau(dimension);
+				for ( n = 0 ; n < dimension ; n++ )
+				{
+					joue_coup(p, coups[i][n].x, coups[i][n].y, (n%2) ? 'B' : 'N');
+				}
+
+				detruisTables();
+				initTables();
+				debut = SDL_GetTicks();
+				ia_losanges(*p, (dimension%2) ? 'B' : 'N', 0);
+				duree += SDL_GetTicks() - debut;
+				noeuds += noeuds_recherche();
+
+				detruis_plateau(&p);
+			}
+
+			if(f == 0)
+			{
+				reference = duree;
+			}
+			printf("\t\t%2d fils: %6u ms (acceleration %.2f), %lu noeuds\n", nb_fils[f], duree,
+					duree ? (double)reference / duree : 0.0, noeuds);
+		}
+	}
+	fixe_mode_parallele(PARALLELE_RACINE);
+	fixe_budget_recherche(0, 0, -1);
+	fixe_nombre_fils(0);
+	detruisTables();
+	free(coups);
+
+	return;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	dimension Dimension du plateau (vide) à chercher
+ *	\param	duree Durée de chaque recherche (en ms)
+ *
+ *	Cette fonction lance une recherche Monte-Carlo de durée fixe sur un plateau vide, avec 1, 2,
+ *	4, 8 puis 16 fils d'exécution, et affiche pour chaque cas le nombre de simulations jouées par
+ *	seconde et l'accélération par rapport à un seul fil.
+ */
+void monteCarloTestBed(int dimension, unsigned int duree)
+{
+	if(duree == 0) return;
+
+	const int nb_fils[5] = {1, 2, 4, 8, 16};
+	int f;
+	double debit, reference = 0.0;
+	plateau *p = nouveau_plateau(dimension);
+
+	printf("Recherche Monte-Carlo parallele (%u ms, plateau %dx%d, %d processeurs):\n", duree, dimension, dimension, nombre_coeurs());
+
+	fixe_budget_monte_carlo(duree, 0);
+	for ( f = 0 ; f < 5 ; f++ )
+	{
+		fixe_nombre_fils(nb_fils[f]);
+		ia_monte_carlo(*p, 'N', 0);
+		debit = 1000.0 * simulations_monte_carlo() / duree;
+
+		if(f == 0)
+		{
+			reference = debit;
+		}
+		printf("\t%2d fils: %9.0f simulations/s (acceleration %.2f)\n", nb_fils[f], debit,
+				reference > 0.0 ? debit / reference : 0.0);
+	}
+	fixe_budget_monte_carlo(0, 0);
+	fixe_nombre_fils(0);
+	detruis_plateau(&p);
+
+	return;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	iterations Nombre de parties aléatoires à jouer pour chaque dimension
+ *
+ *	Cette fonction joue des parties aléatoires (voir #partie_aleatoire()) à partir d'un plateau vide,
+ *	pour chaque dimension proposée par le menu, et affiche le nombre de parties par seconde et la
+ *	proportion de victoires noires. Le gagnant des premières parties est aussi vérifié par #gagnant(),
+ *	après reconstruction des groupes du plateau rempli.
+ */
+void simulationTestBed(int iterations)
+{
+	if(iterations<=0) return;
+
+	const int dimensions[7] = {5, 7, 8, 9, 10, 11, 13};
+	int d, i, victoires_noires, erreurs;
+	unsigned int debut, duree;
+	char vainqueur;
+	bitboard pions[2];
+	generateur alea;
+	plateau *p, *rempli;
+
+	initialise_generateur(&alea, time(NULL));
+	printf("Parties aleatoires (%d par dimension):\n", iterations);
+
+	for ( d = 0 ; d < 7 ; d++ )
+	{
+		p = nouveau_plateau(dimensions[d]);
+		rempli = nouveau_plateau(dimensions[d]);
+		victoires_noires = 0;
+		erreurs = 0;
+
+		debut = SDL_GetTicks();
+		for ( i = 0 ; i < iterations ; i++ )
+		{
+			victoires_noires += (partie_aleatoire(p, 'N', &alea, pions) == 'N');
+		}
+		duree = SDL_GetTicks() - debut;
+
+		for ( i = 0 ; i < 1000 && i < iterations ; i++ ) // Vérification (hors chronométrage)
+		{
+			vainqueur = partie_aleatoire(p, 'N', &alea, pions);
+			rempli->pions[0] = pions[0];
+			rempli->pions[1] = pions[1];
+			reconstruit_groupes(rempli);
+			erreurs += (gagnant(rempli) != vainqueur);
+		}
+
+		printf("\t%2dx%-2d: %10.0f parties/s, %.1f%% de victoires noires, %d erreurs\n", dimensions[d], dimensions[d],
+				duree ? 1000.0 * iterations / duree : 0.0, 100.0 * victoires_noires / iterations, erreurs);
+
+		detruis_plateau(&rempli);
+		detruis_plateau(&p);
+	}
+
+	return;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	dimension Dimension du plateau à créer pour le test
+ *	\param	evaluations Nombre de positions à évaluer
+ *
+ *	Cette fonction parcourt une suite de positions comme le ferait une recherche: à partir d'une
+ *	position aléatoire de début de partie (autant de pions que la dimension du plateau), des coups
+ *	aléatoires sont joués et déjoués jusqu'à quatre coups de profondeur, et la position de départ est
+ *	renouvelée toutes les mille évaluations. Les positions sont évaluées par double distance, d'abord
+ *	avec la mise à jour incrémentale des cartes, puis en les recalculant entièrement. La fonction
+ *	affiche le temps et le nombre de distances calculées par évaluation dans chaque cas, et le nombre
+ *	d'évaluations qui diffèrent (qui doit être nul).
+ */
+void deuxDistancesTestBed(int dimension, int evaluations)
+{
+	if(evaluations<=0) return;
+
+	int i, n, mode, x, y, profondeur = 0, erreurs = 0;
+	int *valeurs = malloc(evaluations * sizeof(int));
+	unsigned long distances[2];
+	unsigned int debut, duree[2];
+	unsigned int graine = rand();
+	char tour = 'N';
+	plateau *p;
+
+	for ( mode = 0 ; mode < 2 ; mode++ )
+	{
+		active_increment_distances(mode == 0);
+		srand(graine); // (Mêmes positions pour les deux séries)
+		p = nouveau_plateau(dimension);
+		distances[mode] = distances_calculees();
+		debut = SDL_GetTicks();
+
+		for ( i = 0 ; i < evaluations ; i++ )
+		{
+			if(i % 1000 == 0) // Nouvelle position de départ
+			{
+				while(p->nb_coups > 0)
+				{
+					dejoue_coup(p);
+				}
+				for ( n = 0 ; n < dimension ; n++ )
+				{
+					do
+					{
+						x = hasard(0, dimension-1);
+						y = hasard(0, dimension-1);
+					}while(case_plateau(p, x, y) != 'V');
+					joue_coup(p, x, y, (n%2) ? 'B' : 'N');
+				}
+				profondeur = 0;
+			}
+			else if(profondeur < 4 && gagnant(p) == 'V' && hasard(0, 2) > 0)
+			{
+				do
+				{
+					x = hasard(0, dimension-1);
+					y = hasard(0, dimension-1);
+				}while(case_plateau(p, x, y) != 'V');
+				joue_coup(p, x, y, ((dimension + profondeur) % 2) ? 'B' : 'N');
+				profondeur++;
+			}
+			else if(profondeur > 0)
+			{
+				dejoue_coup(p);
+				profondeur--;
+			}
+
+			tour = ((dimension + profondeur) % 2) ? 'B' : 'N';
+			n = eval_deux_distances(p, tour);
+			if(mode == 0)
+			{
+				valeurs[i] = n;
+			}
+			else
+			{
+				erreurs += (valeurs[i] != n);
+			}
+		}
+
+		duree[mode] = SDL_GetTicks() - debut;
+		distances[mode] = distances_calculees() - distances[mode];
+		detruis_plateau(&p);
+	}
+	active_increment_distances(true);
+	free(valeurs);
+
+	printf("Double distance (%d evaluations %dx%d):\n", evaluations, dimension, dimension);
+	printf("\tIncrementale: %.2f us/evaluation, %.1f distances/evaluation\n", 1000.0 * duree[0] / evaluations, (double)distances[0] / evaluations);
+	printf("\tComplete: %.2f us/evaluation, %.1f distances/evaluation\n", 1000.0 * duree[1] / evaluations, (double)distances[1] / evaluations);
+	printf("\t%d evaluations differentes\n", erreurs);
+
+	return;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	dimension Dimension des plateaux à créer pour les tests
+ *	\param	pions Nombre de pions des positions aléatoires (placés alternativement par les deux couleurs)
+ *	\param	horizon Horizon (fixe) des recherches
+ *	\param	positions Nombre de positions aléatoires à chercher
+ *
+ *	Cette fonction crée des positions aléatoires de milieu de partie, puis les fait chercher par
+ *	l'IA Losanges jusqu'à l'horizon donné, sans puis avec les connexions virtuelles. Elle affiche
+ *	dans chaque cas le nombre total de nœuds cherchés et le temps total. Les tables sont remises à
+ *	zéro avant chaque recherche, pour que les deux séries partent des mêmes conditions.
+ */
+void connexionsTestBed(int dimension, int pions, int horizon, int positions)
+{
+	if(positions<=0 || pions>dimension*dimension-2) return;
+
+	int ecarts[3];
+	unsigned int duree[2] = {0, 0};
+	unsigned long noeuds[2] = {0, 0};
+
+	compare_noeuds(dimension, pions, horizon, positions, active_connexions, noeuds, duree, ecarts);
+
+	printf("Noeuds cherches (horizon %d, %d positions %dx%d de %d pions):\n", horizon, positions, dimension, dimension, pions);
+	printf("\tSans connexions virtuelles: %lu (%u ms)\n", noeuds[0], duree[0]);
+	printf("\tAvec connexions virtuelles: %lu (%u ms), %.1f fois moins\n", noeuds[1], duree[1], noeuds[1] ? (double)noeuds[0] / noeuds[1] : 0.0);
+	affiche_ecarts(ecarts);
+
+	return;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	dimension Dimension des plateaux à créer pour les tests
+ *	\param	pions Nombre de pions des positions aléatoires (placés alternativement par les deux couleurs)
+ *	\param	horizon Horizon (fixe) des recherches
+ *	\param	positions Nombre de positions aléatoires à chercher
+ *
+ *	Cette fonction crée des positions aléatoires de milieu de partie, puis les fait chercher par
+ *	l'IA Losanges jusqu'à l'horizon donné, sans puis avec l'élagage des cases inférieures (les
+ *	connexions virtuelles restent actives dans les deux cas). Elle affiche dans chaque cas le
+ *	nombre total de nœuds cherchés et le temps total.
+ */
+void inferieuresTestBed(int dimension, int pions, int horizon, int positions)
+{
+	if(positions<=0 || pions>dimension*dimension-2) return;
+
+	int ecarts[3];
+	unsigned int duree[2] = {0, 0};
+	unsigned long noeuds[2] = {0, 0};
+
+	compare_noeuds(dimension, pions, horizon, positions, active_inferieures, noeuds, duree, ecarts);
+
+	printf("Noeuds cherches (horizon %d, %d positions %dx%d de %d pions):\n", horizon, positions, dimension, dimension, pions);
+	printf("\tSans elagage des cases inferieures: %lu (%u ms)\n", noeuds[0], duree[0]);
+	printf("\tAvec elagage des cases inferieures: %lu (%u ms), %.1f fois moins\n", noeuds[1], duree[1], noeuds[1] ? (double)noeuds[0] / noeuds[1] : 0.0);
+	affiche_ecarts(ecarts);
+
+	return;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	dimension Dimension des plateaux à créer pour les tests
+ *	\param	pions Nombre de pions des positions aléatoires (placés alternativement par les deux couleurs, 0 pour le plateau vide)
+ *	\param	positions Nombre de positions aléatoires à résoudre
+ *	\param	duree_max Temps accordé à chaque résolution (en ms, 0 si illimité)
+ *
+ *	Cette fonction crée des positions aléatoires (sans partie déjà gagnée), puis demande au solveur
+ *	de prouver l'issue de chacune pour le joueur qui a le trait, en partant à chaque fois d'une table
+ *	de transposition vide. Elle affiche le nombre de positions gagnées, perdues et non résolues, le
+ *	nombre total de nœuds cherchés et le temps total.
+ */
+void solveurTestBed(int dimension, int pions, int positions, unsigned int duree_max)
+{
+	if(positions<=0 || pions>dimension*dimension-2) return;
+
+	int i, resultats[3] = {0, 0, 0}; // Positions perdues, non résolues et gagnées
+	unsigned int debut, duree = 0;
+	unsigned long noeuds = 0;
+	coord coup;
+	plateau *p;
+
+	for ( i = 0 ; i < positions ; i++ )
+	{
+		p = position_aleatoire(dimension, pions, NULL);
+
+		vide_table_dfpn();
+		debut = SDL_GetTicks();
+		resultats[resous_position(p, (pions%2) ? 'B' : 'N', duree_max, 0, &coup) + 1]++;
+		duree += SDL_GetTicks() - debut;
+		noeuds += noeuds_dfpn();
+
+		detruis_plateau(&p);
+	}
+
+	printf("Solveur DFPN (%d positions %dx%d de %d pions, %u ms au plus par position):\n", positions, dimension, dimension, pions, duree_max);
+	printf("\t%d gagnees, %d perdues, %d non resolues\n", resultats[DFPN_GAGNE + 1], resultats[DFPN_PERDU + 1], resultats[DFPN_INCONNU + 1]);
+	printf("\t%lu noeuds, %u ms\n", noeuds, duree);
+
+	return;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	dimension Dimension du plateau de la table à vérifier
+ *	\param	pions_max Nombre maximal de pions des positions de la table
+ *	\param	verifications Nombre de positions aléatoires à vérifier avec le solveur DFPN
+ *
+ *	Cette fonction résout des positions aléatoires (de 0 à \a pions_max pions) avec le solveur DFPN
+ *	seul, et affiche le nombre de désaccords entre la table chargée de la dimension donnée et le
+ *	solveur (qui doit être nul). La table doit avoir été générée par outils/genere_resolues.c.
+ */
+void tablesResoluesTestBed(int dimension, int pions_max, int verifications)
+{
+	int i, pions, resultat, desaccords = 0;
+	coord coup;
+	plateau *p = nouveau_plateau(dimension);
+
+	resultat = consulte_table_resolue(p, 'N', &coup);
+	detruis_plateau(&p);
+	if(resultat == DFPN_INCONNU)
+	{
+		printf("Aucune table chargee pour les positions %dx%d\n", dimension, dimension);
+		return;
+	}
+
+	active_tables_resolues(false); // Le solveur ne doit pas lire ses réponses dans la table
+	for ( i = 0 ; i < verifications ; i++ )
+	{
+		pions = hasard(0, low(pions_max, dimension*dimension-2));
+		p = position_aleatoire(dimension, pions, NULL);
+
+		resultat = resous_position(p, (pions%2) ? 'B' : 'N', 0, 0, &coup);
+		if(resultat != consulte_table_resolue(p, (pions%2) ? 'B' : 'N', &coup))
+		{
+			desaccords++;
+		}
+		detruis_plateau(&p);
+	}
+	active_tables_resolues(true);
+
+	printf("Table %dx%d: %d desaccords avec le solveur sur %d positions\n", dimension, dimension, desaccords, verifications);
+
+	return;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	dimension Dimension des plateaux à créer pour les tests (celle d'une table chargée)
+ *	\param	pions Nombre de pions des positions aléatoires (au plus celui de la table)
+ *	\param	positions Nombre de positions gagnées à soumettre aux IA
+ *	\param	level Niveau des IA (voir #duree_reflexion())
+ *
+ *	Cette fonction tire des positions aléatoires que la table de positions résolues donne gagnées
+ *	pour le joueur qui a le trait, demande son coup à chaque IA (qui ne consulte pas la table), puis
+ *	vérifie avec la table (ou avec le solveur DFPN, si la position suivante n'y est pas) que ce coup
+ *	conserve la victoire. Elle affiche le nombre de coups perdants de chaque IA.
+ */
+void oracleTestBed(int dimension, int pions, int positions, int level)
+{
+	if(positions<=0 || pions>dimension*dimension-2) return;
+
+	coord (*ia[3]) (plateau, char, int) = {ia_losanges, ia_electrique, ia_monte_carlo};
+	const char *noms[3] = {"Losanges", "Electrique", "Roulette"};
+	int i, f, resultat, erreurs[3] = {0, 0, 0};
+	char joueur = (pions%2) ? 'B' : 'N';
+	coord coup;
+	plateau *p;
+
+	active_tables_resolues(false); // Les IA ne doivent pas lire leurs réponses dans la table
+	for ( i = 0 ; i < positions ; i++ )
+	{
+		p = position_aleatoire(dimension, pions, NULL);
+
+		resultat = consulte_table_resolue(p, joueur, &coup);
+		if(resultat == DFPN_INCONNU)
+		{
+			printf("Aucune table chargee pour les positions %dx%d de %d pions\n", dimension, dimension, pions);
+			detruis_plateau(&p);
+			break;
+		}
+		else if(resultat == DFPN_PERDU) // Seules les positions gagnées ont un bon coup à trouver
+		{
+			detruis_plateau(&p);
+			i--;
+			continue;
+		}
+
+		for ( f = 0 ; f < 3 ; f++ )
+		{
+			detruisTables();
+			initTables();
+			coup = ia[f](*p, joueur, level);
+			joue_coup(p, coup.x, coup.y, joueur);
+			resultat = (gagnant(p) == joueur) ? DFPN_PERDU : consulte_table_resolue(p, couleur_opposee(joueur), &coup);
+			if(resultat == DFPN_INCONNU)
+			{
+				resultat = resous_position(p, couleur_opposee(joueur), 0, 0, &coup);
+			}
+			if(resultat != DFPN_PERDU) // Le coup laisse la victoire à l'adversaire
+			{
+				erreurs[f]++;
+			}
+			dejoue_coup(p);
+		}
+		detruis_plateau(&p);
+	}
+	active_tables_resolues(true);
+	detruisTables();
+
+	printf("Coups perdants dans %d positions %dx%d gagnees de %d pions (niveau %d):\n", positions, dimension, dimension, pions, level);
+	for ( f = 0 ; f < 3 ; f++ )
+	{
+		printf("\t%s: %d\n", noms[f], erreurs[f]);
+	}
+
+	return;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	dimension Dimension du plateau du livre à générer
+ *	\param	pions_max Nombre maximal de pions des positions du livre
+ *	\param	level Niveau de l'IA Solveur qui cherche les coups du livre (voir #duree_reflexion())
+ *
+ *	Cette fonction génère le livre d'ouvertures de la dimension donnée (voir
+ *	#genere_livre_ouvertures(), ce qui peut prendre du temps), le charge à la place de l'éventuel
+ *	livre précédent, puis mesure le temps du premier coup de l'IA Losanges (niveau 4) sur le plateau
+ *	vide, sans puis avec le livre.
+ */
+void ouverturesTestBed(int dimension, int pions_max, int level)
+{
+	int mode;
+	unsigned int debut;
+	plateau *p = nouveau_plateau(dimension);
+
+	debut = SDL_GetTicks();
+	if(genere_livre_ouvertures(p, pions_max, level) != 0)
+	{
+		printf("Echec de la generation du livre %dx%d\n", dimension, dimension);
+		detruis_plateau(&p);
+		return;
+	}
+	printf("Livre %dx%d genere en %u ms\n", dimension, dimension, SDL_GetTicks() - debut);
+	libere_livres_ouvertures();
+	charge_livres_ouvertures();
+
+	for ( mode = 0 ; mode < 2 ; mode++ )
+	{
+		active_livres_ouvertures(mode == 1);
+		detruisTables();
+		initTables();
+		debut = SDL_GetTicks();
+		ia_losanges(*p, 'N', 4);
+		printf("Premier coup %s le livre: %u ms\n", (mode == 1) ? "avec" : "sans", SDL_GetTicks() - debut);
+	}
+	active_livres_ouvertures(true);
+	detruisTables();
+	detruis_plateau(&p);
+
+	return;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	dimension Dimension des plateaux à créer pour les tests
+ *	\param	parties Nombre de parties à jouer (pour chaque mode)
+ *	\param	duree Temps accordé à chaque coup (en ms)
+ *
+ *	Cette fonction fait jouer des parties à l'IA Monte-Carlo contre elle-même (chaque camp héritant
+ *	de l'arbre de l'autre), sans puis avec la réutilisation de l'arbre, et affiche pour chaque mode
+ *	le nombre moyen de simulations de la racine au moment de choisir un coup, et la part de ces
+ *	simulations héritées de la recherche précédente.
+ */
+void reutilisationTestBed(int dimension, int parties, unsigned int duree)
+{
+	if(parties<=0) return;
+
+	int i, mode, coups[2] = {0, 0};
+	unsigned long jouees[2] = {0, 0}, heritees[2] = {0, 0};
+	char joueur;
+	coord coup;
+	plateau *p;
+
+	fixe_budget_monte_carlo(duree, 0);
+	for ( mode = 0 ; mode < 2 ; mode++ )
+	{
+		active_reutilisation_arbre(mode == 1);
+		for ( i = 0 ; i < parties ; i++ )
+		{
+			p = nouveau_plateau(dimension);
+			joueur = 'N';
+			while(gagnant(p) == 'V')
+			{
+				coup = ia_monte_carlo(*p, joueur, 0);
+				jouees[mode] += simulations_monte_carlo();
+				heritees[mode] += simulations_reutilisees();
+				coups[mode]++;
+
+				joue_coup(p, coup.x, coup.y, joueur);
+				joueur = couleur_opposee(joueur);
+			}
+			detruis_plateau(&p);
+		}
+	}
+	active_reutilisation_arbre(true);
+	fixe_budget_monte_carlo(0, 0);
+
+	printf("Simulations de la racine par coup (%d parties %dx%d, %u ms par coup):\n", parties, dimension, dimension, duree);
+	for ( mode = 0 ; mode < 2 ; mode++ )
+	{
+		printf("\t%s reutilisation: %lu (dont %.1f%% heritees)\n", mode ? "Avec" : "Sans",
+				(jouees[mode] + heritees[mode]) / coups[mode], 100.0 * heritees[mode] / (jouees[mode] + heritees[mode]));
+	}
+
+	return;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	exhaustive Dimension du plateau dont toutes les positions sont vérifiées (4 au plus)
+ *	\param	dimension Dimension du plateau à créer pour la mesure des temps
+ *	\param	evaluations Nombre de positions à évaluer pour la mesure des temps
+ *
+ *	Cette fonction énumère d'abord toutes les positions (légales ou non) du plateau de dimension
+ *	\a exhaustive, comme un compteur en base 3 dont chaque chiffre est une case (vide, noire ou
+ *	blanche): chaque position ne diffère de la précédente que par les cases dont le chiffre a changé,
+ *	qui sont modifiées par pose_pion() (toutes les transitions d'une case sont ainsi éprouvées). Dans
+ *	chaque position, eval_losanges() est comparée pour les deux couleurs à eval_losanges_complete()
+ *	(calcul sur tout le plateau à la fois), ainsi qu'à la somme des scores de compte_losanges() et
+ *	compte_connexions() de chaque pion.
+ *	Des coups aléatoires sont ensuite joués et déjoués sur le plateau de dimension \a dimension,
+ *	comme dans deuxDistancesTestBed(), et la fonction affiche le temps d'une évaluation de chaque
+ *	sorte, ainsi que le nombre d'évaluations qui diffèrent (qui doit être nul).
+ */
+void losangesTestBed(int exhaustive, int dimension, int evaluations)
+{
+	if(exhaustive<1 || exhaustive>4 || evaluations<=0) return;
+
+	int i, k, n, mode, x, y, profondeur = 0, erreurs = 0, erreurs_exhaustives = 0;
+	int pions[2];
+	int chiffres[16] = {0};
+	long positions = 0;
+	unsigned int debut, duree[2];
+	unsigned int graine = rand();
+	volatile int somme = 0; // (Pour que les évaluations ne soient pas supprimées à la compilation)
+	const char contenus[3] = {'V', 'N', 'B'};
+	plateau *p = nouveau_plateau(exhaustive);
+
+	do
+	{
+		positions++;
+		pions[0] = pions[1] = 0; // Scores des pions de chaque couleur, un à un
+		for ( k = 0 ; k < exhaustive*exhaustive ; k++ )
+		{
+			if(chiffres[k] != 0)
+			{
+				pions[chiffres[k]-1] += 2*compte_losanges(p, k % exhaustive, k / exhaustive) + compte_connexions(p, k % exhaustive, k / exhaustive);
+			}
+		}
+		erreurs_exhaustives += (eval_losanges(p, 'N') != eval_losanges_complete(p, 'N')) + (eval_losanges(p, 'N') != pions[0] - 2*pions[1]);
+		erreurs_exhaustives += (eval_losanges(p, 'B') != eval_losanges_complete(p, 'B')) + (eval_losanges(p, 'B') != pions[1] - 2*pions[0]);
+
+		for ( k = 0 ; k < exhaustive*exhaustive ; k++ ) // Position suivante
+		{
+			chiffres[k] = (chiffres[k] + 1) % 3;
+			pose_pion(p, k % exhaustive, k / exhaustive, contenus[chiffres[k]]);
+			if(chiffres[k] != 0)
+			{
+				break;
+			}
+		}
+	}while(k < exhaustive*exhaustive);
+	detruis_plateau(&p);
+
+	for ( mode = 0 ; mode < 2 ; mode++ )
+	{
+		srand(graine); // (Mêmes positions pour les deux séries)
+		p = nouveau_plateau(dimension);
+		debut = SDL_GetTicks();
+
+		for ( i = 0 ; i < evaluations ; i++ )
+		{
+			if(i % 1000 == 0) // Nouvelle position de départ
+			{
+				while(p->nb_coups > 0)
+				{
+					dejoue_coup(p);
+				}
+				for ( n = 0 ; n < dimension ; n++ )
+				{
+					do
+					{
+						x = hasard(0, dimension-1);
+						y = hasard(0, dimension-1);
+					}while(case_plateau(p, x, y) != 'V');
+					joue_coup(p, x, y, (n%2) ? 'B' : 'N');
+				}
+				profondeur = 0;
+			}
+			else if(profondeur < 4 && gagnant(p) == 'V' && hasard(0, 2) > 0)
+			{
+				do
+				{
+					x = hasard(0, dimension-1);
+					y = hasard(0, dimension-1);
+				}while(case_plateau(p, x, y) != 'V');
+				joue_coup(p, x, y, ((dimension + profondeur) % 2) ? 'B' : 'N');
+				profondeur++;
+			}
+			else if(profondeur > 0)
+			{
+				dejoue_coup(p);
+				profondeur--;
+			}
+
+			n = (mode == 0) ? eval_losanges(p, 'N') : eval_losanges_complete(p, 'N');
+			somme += n;
+			if(mode == 1)
+			{
+				erreurs += (eval_losanges(p, 'N') != n);
+			}
+		}
+
+		duree[mode] = SDL_GetTicks() - debut;
+		detruis_plateau(&p);
+	}
+
+	printf("Evaluation par les losanges:\n");
+	printf("\t%ld positions %dx%d verifiees, %d evaluations differentes\n", positions, exhaustive, exhaustive, erreurs_exhaustives);
+	printf("\t%d evaluations %dx%d:\n", evaluations, dimension, dimension);
+	printf("\t\tIncrementale: %.3f us/evaluation\n", 1000.0 * duree[0] / evaluations);
+	printf("\t\tComplete: %.3f us/evaluation\n", 1000.0 * duree[1] / evaluations);
+	printf("\t\t%d evaluations differentes\n", erreurs);
 
 	return;
 }
@@ -610,10 +1569,7 @@ void collisionTestBed(int dimension, int iterations)
  *	Ce menu vous propose de choisir parmi les dimensions proposées, celle que vous
  *	souhaitez affecter au plateau de jeu de votre partie.\n
  *	Pour choisir une dimension, cliquez sur la case correspondante.\n
- *		- Si vous choisissez une dimension inférieure ou égale à 7, le jeu passe automatiquement
- *		au menu de \ref choix_type "choix du type de partie".\n
- *		- Sinon, \ref humain_vs_humain "une partie de type Humain contre Humain" est directement lancée.
- *		.
+ *	Le jeu passe alors au menu de \ref choix_type "choix du type de partie".\n
  *	Pour revenir à l'\ref mainmenu "écran principal", cliquez sur le bouton "Retour".\n
  *
  *	\subsection choix_type Choix du type de partie
@@ -652,9 +1608,23 @@ void collisionTestBed(int dimension, int iterations)
  *		connexions possibles et établies dans les deux camps. Elle présente donc un meilleur niveau
  *		de jeu que l'intelligence "Brainless".\n
  *		Un clic sur ce bouton appelle le \ref choix_difficulte "menu de choix de la difficulté".
+ *		Au-delà de 7x7, où les losanges ne suffisent plus à juger une situation de jeu, ce bouton donne
+ *		une intelligence artificielle qui compte plutôt les coups qu'il reste à chaque joueur pour relier
+ *		ses bords (double distance): rapide et solide, elle convient aux grands plateaux.\n
  *		- Electrique\n
- *		Cette intelligence artificielle est actuellement indisponible, et le bouton, bien que présent,
- *		n'est donc pour le moment pas cliquable.
+ *		Cette intelligence artificielle voit le plateau comme un circuit électrique, dans lequel ses pions
+ *		conduisent le courant et ceux de l'adversaire l'arrêtent: elle cherche les coups qui relient le mieux
+ *		ses deux bords, tout en séparant ceux de l'adversaire. Plus lente à réfléchir que l'intelligence
+ *		"Losanges", elle juge cependant bien mieux chaque situation de jeu, et reste utilisable sur tous
+ *		les plateaux.\n
+ *		Jusqu'à 7x7, elle consacre en plus une partie de son temps à chercher une preuve de victoire:
+ *		dès qu'elle l'a trouvée, elle joue parfaitement jusqu'à la fin de la partie.\n
+ *		Un clic sur ce bouton appelle le \ref choix_difficulte "menu de choix de la difficulté".
+ *		- Roulette\n
+ *		Cette intelligence artificielle joue des milliers de parties au hasard à partir de la situation
+ *		de jeu, et choisit le coup qui y réussit le mieux (recherche arborescente Monte-Carlo). Elle est
+ *		la plus à l'aise sur les grands plateaux, jusqu'à 13x13.\n
+ *		Un clic sur ce bouton appelle le \ref choix_difficulte "menu de choix de la difficulté".
  *		.
  *	Pour revenir au \ref choix_couleur "menu de choix de la couleur", cliquez sur le bouton "Retour".
  *
@@ -662,10 +1632,14 @@ void collisionTestBed(int dimension, int iterations)
  *	\image	html menu_difficulte.png
  *	Ce menu vous permet de choisir la difficulté de l'intelligence artificielle dans le cas d'une partie
  *	de type Humain contre Machine, ou encore Machine contre Machine.\n
- *	\note   Plus la difficulté est élevée, plus le temps de calcul nécessaire au jeu de l'intelligence
- *			artificielle est élevé.\n
+ *	\note   Plus la difficulté est élevée, plus l'intelligence artificielle réfléchit longtemps: de 0,5 seconde
+ *			par coup en mode "Facile" à 8 secondes en mode "Nash 2 en 1".\n
  *	\note	Le mode de difficulté extrême, "Nash 2 en 1", empêche l'affichage des pions sur le plateau.
  *			Ainsi, vous devrez retenir l'emplacement de vos pions, ainsi que ceux de l'intelligence artificielle.
+ *	\note	Si votre ordinateur possède plusieurs processeurs, des pions sont affichés à droite du menu: chaque
+ *			pion noir est un fil d'exécution utilisé par l'intelligence artificielle pour réfléchir. Cliquez sur
+ *			un pion pour choisir le nombre de fils (le dernier pion les sélectionne tous, ce qui est le réglage
+ *			par défaut).\n
  *	Pour revenir au \ref choix_ia "menu de choix du type d'intelligence artificielle", cliquez sur le bouton "Retour".
  *
  *	\section	jeu Déroulement d'une partie
@@ -0,0 +1,221 @@
+/*!
+ *	\file	bitboard.h
+ *	\brief	Représentation du plateau par champs de bits
+ *	\author	Julien Laurent
+ *
+ *	Ce fichier définit le type #bitboard (un ensemble de cases codé sur 256 bits), ainsi que les
+ *	opérations élémentaires associées. Elles sont déclarées "static inline", car elles sont appelées
+ *	dans les boucles les plus critiques de l'intelligence artificielle.
+ *
+ *	Disposition des cases: la case (x, y) d'un plateau de dimension \a dim occupe le bit
+ *	(y+2) * (dim+2) + x. Chaque ligne est donc suivie de deux colonnes de garde, et le plateau est
+ *	précédé de deux lignes de garde: les voisins (distance 1) et les cases de \a bridge (distance 2)
+ *	d'une case existante tombent ainsi toujours sur un bit valide, vide s'il est hors du plateau.
+ *	Un simple décalage suffit alors à obtenir les voisins de toutes les cases à la fois, sans test
+ *	de bornes. (Pour une dimension de 13, le bit le plus élevé utilisé est le 254ème)
+ *	Un #bitboard tenant exactement dans un registre AVX2, #bb_paires() dispose d'une version
+ *	vectorielle, compilée quand le compilateur cible ce jeu d'instructions (option -mavx2 ou
+ *	-march=native de gcc): les autres opérations restent portables.
+ */
+
+#ifndef BITBOARD_H_INCLUDED
+#define BITBOARD_H_INCLUDED
+
+#include <stdint.h>
+#include <stdbool.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#define DIM_MAX 13 ///< Dimension maximale d'un plateau représentable
+#define MOTS_BITBOARD 4 ///< Nombre de mots de 64 bits composant un #bitboard
+#define BITS_BITBOARD (64*MOTS_BITBOARD) ///< Nombre total de bits d'un #bitboard
+
+/*!
+ *	\brief	Ensemble de cases du plateau, codé sur 256 bits
+ *	\author	Julien Laurent
+ */
+struct bitboard
+{
+	uint64_t mot[MOTS_BITBOARD]; ///< Mots de 64 bits (le bit \a i est le bit i%64 du mot i/64)
+};
+typedef struct bitboard bitboard; ///< Raccourci d'utilisation du type #bitboard
+
+
+/// Renvoie un #bitboard vide
+static inline bitboard bb_nul(void)
+{
+	bitboard b = {{0, 0, 0, 0}};
+	return b;
+}
+
+/// Renvoie vrai si le bit \a i est actif
+static inline bool bb_teste(const bitboard *b, int i)
+{
+	return (b->mot[i >> 6] >> (i & 63)) & 1;
+}
+
+/// Active le bit \a i
+static inline void bb_place(bitboard *b, int i)
+{
+	b->mot[i >> 6] |= (uint64_t)1 << (i & 63);
+}
+
+/// Désactive le bit \a i
+static inline void bb_retire(bitboard *b, int i)
+{
+	b->mot[i >> 6] &= ~((uint64_t)1 << (i & 63));
+}
+
+/// Intersection de deux ensembles
+static inline bitboard bb_et(bitboard a, bitboard b)
+{
+	int k;
+	for ( k = 0 ; k < MOTS_BITBOARD ; k++ ) a.mot[k] &= b.mot[k];
+	return a;
+}
+
+/// Union de deux ensembles
+static inline bitboard bb_ou(bitboard a, bitboard b)
+{
+	int k;
+	for ( k = 0 ; k < MOTS_BITBOARD ; k++ ) a.mot[k] |= b.mot[k];
+	return a;
+}
+
+/// Différence de deux ensembles (cases de \a a absentes de \a b)
+static inline bitboard bb_sauf(bitboard a, bitboard b)
+{
+	int k;
+	for ( k = 0 ; k < MOTS_BITBOARD ; k++ ) a.mot[k] &= ~b.mot[k];
+	return a;
+}
+
+/// Renvoie vrai si l'ensemble est vide
+static inline bool bb_est_nul(bitboard a)
+{
+	return !(a.mot[0] | a.mot[1] | a.mot[2] | a.mot[3]);
+}
+
+/// Renvoie vrai si les deux ensembles sont identiques
+static inline bool bb_egal(bitboard a, bitboard b)
+{
+	return !((a.mot[0]^b.mot[0]) | (a.mot[1]^b.mot[1]) | (a.mot[2]^b.mot[2]) | (a.mot[3]^b.mot[3]));
+}
+
+/*!
+ *	\brief	Décale l'ensemble de \a n bits (vers les indices croissants si \a n est positif)
+ *
+ *	Le bit \a i de l'ensemble d'origine devient le bit \a i+n du résultat. Les bits sortant
+ *	de l'intervalle [0, #BITS_BITBOARD[ sont perdus. \a n doit être compris entre -63 et 63,
+ *	ce qui couvre largement les décalages de voisinage (au plus 2 lignes de 15 cases).
+ */
+static inline bitboard bb_decale(bitboard a, int n)
+{
+	bitboard r;
+	int k;
+
+	if(n > 0)
+	{
+		r.mot[0] = a.mot[0] << n;
+		for ( k = 1 ; k < MOTS_BITBOARD ; k++ ) r.mot[k] = (a.mot[k] << n) | (a.mot[k-1] >> (64-n));
+	}
+	else if(n < 0)
+	{
+		n = -n;
+		for ( k = 0 ; k < MOTS_BITBOARD-1 ; k++ ) r.mot[k] = (a.mot[k] >> n) | (a.mot[k+1] << (64-n));
+		r.mot[MOTS_BITBOARD-1] = a.mot[MOTS_BITBOARD-1] >> n;
+	}
+	else
+	{
+		r = a;
+	}
+
+	return r;
+}
+
+/// Nombre de bits actifs d'un mot de 64 bits
+static inline int bb_compte_mot(uint64_t m)
+{
+#ifdef __GNUC__
+	return __builtin_popcountll(m);
+#else
+	int n = 0;
+	while(m) { m &= m-1; n++; }
+	return n;
+#endif
+}
+
+/// Nombre de cases de l'ensemble
+static inline int bb_compte(bitboard a)
+{
+	return bb_compte_mot(a.mot[0]) + bb_compte_mot(a.mot[1]) + bb_compte_mot(a.mot[2]) + bb_compte_mot(a.mot[3]);
+}
+
+/*!
+ *	\brief	Nombre de paires de cases de l'ensemble distantes de \a n bits (\a n entre 1 et 63)
+ *
+ *	Compte les cases \a i de l'ensemble telles que \a i+n en fasse aussi partie: avec les décalages de
+ *	voisinage, on obtient d'un coup le nombre de connexions (ou de \a bridges) d'une orientation donnée
+ *	entre les pions d'une couleur, les cases de garde empêchant toute paire de "déborder" d'une ligne
+ *	sur l'autre.
+ *	La version AVX2 décale les quatre mots à la fois (chaque mot recevant les bits sortants de son
+ *	prédécesseur), et compte les bits par demi-octets à l'aide d'une table de 16 entrées.
+ */
+static inline int bb_paires(bitboard a, int n)
+{
+#ifdef __AVX2__
+	const __m256i table = _mm256_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4, 0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4);
+	const __m256i demi_octet = _mm256_set1_epi8(0x0F);
+	__m256i v = _mm256_loadu_si256((const __m256i *)a.mot);
+	__m256i prec = _mm256_blend_epi32(_mm256_permute4x64_epi64(v, 0x90), _mm256_setzero_si256(), 0x03); // Mot k-1 dans le mot k (0 dans le premier)
+	__m256i d = _mm256_or_si256(_mm256_sll_epi64(v, _mm_cvtsi32_si128(n)), _mm256_srl_epi64(prec, _mm_cvtsi32_si128(64-n)));
+	__m256i compte;
+
+	d = _mm256_and_si256(d, v); // (Cases i+n telles que i et i+n sont dans l'ensemble)
+	compte = _mm256_add_epi8(_mm256_shuffle_epi8(table, _mm256_and_si256(d, demi_octet)),
+			_mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi64(d, 4), demi_octet)));
+	compte = _mm256_sad_epu8(compte, _mm256_setzero_si256()); // (Somme des octets de chaque mot)
+
+	return _mm256_extract_epi64(compte, 0) + _mm256_extract_epi64(compte, 1) + _mm256_extract_epi64(compte, 2) + _mm256_extract_epi64(compte, 3);
+#else
+	return bb_compte(bb_et(a, bb_decale(a, n)));
+#endif
+}
+
+/// Indice du bit actif de poids le plus faible d'un mot non nul
+static inline int bb_premier_mot(uint64_t m)
+{
+#ifdef __GNUC__
+	return __builtin_ctzll(m);
+#else
+	int n = 0;
+	while(!(m & 1)) { m >>= 1; n++; }
+	return n;
+#endif
+}
+
+/*!
+ *	\brief	Extrait (et retire de l'ensemble) la case de plus faible indice
+ *	\return	Indice de la case extraite, ou -1 si l'ensemble est vide
+ *
+ *	Permet de parcourir les cases d'un ensemble dans l'ordre croissant des indices (donc ligne
+ *	par ligne, comme les anciens parcours "for i, for j"):
+ *	\code while((i = bb_extrait(&b)) >= 0) { ... } \endcode
+ */
+static inline int bb_extrait(bitboard *b)
+{
+	int k;
+	for ( k = 0 ; k < MOTS_BITBOARD ; k++ )
+	{
+		if(b->mot[k])
+		{
+			int i = bb_premier_mot(b->mot[k]);
+			b->mot[k] &= b->mot[k] - 1;
+			return (k << 6) + i;
+		}
+	}
+	return -1;
+}
+
+#endif // BITBOARD_H_INCLUDED
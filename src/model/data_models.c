@@ -11,6 +11,12 @@
 
 #include "data_models.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
 /*!
  *	\author	Julien Laurent
  *	\param	couleur La couleur considérée
@@ -39,260 +45,323 @@ char couleur_opposee(char couleur)
 }
 
 /*!
- *	\author	Lucas Dessaignes
- *	\param	x Abscisse matricielle de la case à vérifier
- *	\param	y Ordonnée matricielle de la case à vérifier
- *	\param	p Pointeur sur le plateau concerné
- *	\param	pion Couleur du pion demandé
- *	\return	Vrai si la case existe ET est occupée par un pion de la couleur demandée, faux si l'une des deux conditions n'est pas vérifiée.
- *
- *	Cette fonction vérifie si les coordonnées passées en paramètre correspondent à une case existante (et ne risquent donc pas de provoquer une
- *	erreur lors de l'accès au tableau p->tab du #plateau), et dans le cas où la case existe, si elle est occupée par un pion de la couleur
- *	passée en paramètre. Elle ne renvoie vrai que si ces deux conditions sont vérifiées. (dans le bon ordre, pour éviter les erreurs de
- *	segmentation)
+ *	\author	Julien Laurent
+ *	\param	pion Couleur à convertir
+ *	\return	0 pour \a N, 1 pour \a B, -1 pour toute autre valeur
  *
+ *	Convertit une couleur de pion en indice, pour l'accès aux tableaux indexés par couleur
+ *	(comme les #bitboard du #plateau).
  */
-bool coordValide(int x, int y, plateau *p, char pion)
+int indice_couleur(char pion)
 {
-	if(coordExiste(x,y,p))
-	{
-		return (!p->checked[y][x]) && (p->tab[y][x] == pion);
-	}
-	else
+	switch(pion)
 	{
-		return false;
-	}
-}
+		case 'N':
+			return 0;
+		break;
 
-bool coordExiste(int x, int y, plateau *p)
-{
-	return (x>=0)&&(y>=0)&&(x<p->dim)&&(y<p->dim) ;
-}
+		case 'B':
+			return 1;
+		break;
 
+		default:
+			return -1;
+		break;
+	}
+}
 
 /*!
  *	\author	Julien Laurent
- *	\param	nbtours Nombre de tours qui ont eu lieu avant l'appel. Utile pour économiser des traitements en début de partie
- *	\param	x Abscisse matricielle du dernier coup joué
- *	\param	y Ordonnée matricielle du dernier coup joué
- *	\param	p Pointeur sur le plateau à analyser
- *	\return	Vrai si le dernier pion posé est un pion gagnant, faux sinon
+ *	\param	p Pointeur sur le plateau à consulter
+ *	\param	x Abscisse matricielle de la case
+ *	\param	y Ordonnée matricielle de la case
+ *	\return	Contenu de la case (\a N, \a B, ou \a V si elle est vide)
  *
- *	Cette fonction est chargée de vérifier les conditions nécessaires et suffisantes au gain du joueur
- *	qui vient de placer un pion sur la case correspondant aux coordonnées \a x et \a y passées en paramètre.
- *	Si ce joueur n'a pas au moins un pion présent sur chacune des deux frontières de sa couleur, le traitement
- *	est arrêté, et la fonction renvoie faux. Dans le cas contraire, une analyse récursive à l'aide de
- *	#jumperBlanc() et #jumperNoir() est effectuée.
+ *	Lit le contenu d'une case directement dans les #bitboard du plateau.
+ *	Les coordonnées doivent correspondre à une case existante.
  */
-bool check_gain(int nbtours, int x, int y, plateau *p)
+char case_plateau(const plateau *p, int x, int y)
 {
-	if(nbtours < (2*p->dim)-1) // La partie ne peut être gagnée que si un nombre suffisant de pions ont été placés
+	int i = indice_case(p, x, y);
+
+	if(bb_teste(&p->pions[0], i))
 	{
-		return false;
+		return 'N';
 	}
-
-	int i,j; // On met à "false" les booléens anti-stack-overflow
-	for ( i = 0 ; i < p->dim ; i++ )
+	else if(bb_teste(&p->pions[1], i))
 	{
-		for ( j = 0 ; j < p->dim ; j++ )
-		{
-			p->checked[i][j] = false;
-		}
+		return 'B';
 	}
-
-	// La conjonction de ces deux booléens indique si la partie a été gagnée ou non
-	bool winning[2] = {false, false};
-
-	// Selon la couleur du dernier pion joué (celui depuis lequel on part)
-	switch(p->tab[y][x])
+	else
 	{
-		case 'N': // On vérifie la présence d'un pion de la couleur en question sur chacune des deux frontières
-				// qui correspondent:
-			if(presenceLignes('N',p))
-			{
-				jumperNoir(x, y, p, winning); // Puis on lance le jumper qui va bien sur le pion de départ
-			}
-		break;
-
-		case 'B': // On vérifie la présence d'un pion de la couleur en question sur chacune des deux frontières
-				// qui correspondent:
-			if(presenceLignes('B',p))
-			{
-				jumperBlanc(x, y, p, winning); // Puis on lance le jumper qui va bien sur le pion de départ
-			}
-		break;
-
-		default:
-			return false;
-		break;
+		return 'V';
 	}
-
-	// On renvoie finalement la conjonction des deux conditions du gain
-	return winning[0] && winning[1];
 }
 
 /*!
- *	\author	Lucas Dessaignes, Alexis Brisset
- *	\param	pion Couleur considérée (influe sur les frontières vérifiées, et les pions recherchés)
- *	\param	p Pointeur sur le plateau à analyser
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur le plateau à modifier
+ *	\param	x Abscisse matricielle du pion posé
+ *	\param	y Ordonnée matricielle du pion posé
+ *	\param	couleur Indice de la couleur du pion posé
  *
- *	Cette fonction parcourt les deux frontières de la couleur passée en paramètre, et renvoie vrai
- *	si au moins un pion de cette couleur est présent sur chacune des deux frontières. Sinon, elle
- *	renvoie faux. Elle est utilisée par #check_gain() à des fins d'optimisation.
+ *	Enregistre un nouveau coup dans les groupes connexes du plateau, et réunit le pion posé avec les
+ *	pions voisins de même couleur, ainsi qu'avec les frontières de sa couleur qu'il touche.
+ *	Le pion doit déjà être présent dans les bitboards.
  */
-bool presenceLignes(char pion, plateau *p)
+static void relie_pion(plateau *p, int x, int y, int couleur)
 {
-	int i;
-	bool frontiere_1 = false, frontiere_2 = false;
-
-	switch(pion)
-	{
-		case 'N': // Parcours des frontières noires à la recherche d'un pion noir:
-			for(i = 0 ; i < p->dim ; i++)
-			{
-				if(p->tab[0][i] == 'N') frontiere_1 = true;
-			}
-			for(i = 0 ; i < p->dim ; i++)
-			{
-				if(p->tab[p->dim-1][i] == 'N') frontiere_2 = true;
-			}
-		break;
+	int k, i = indice_case(p, x, y), n = y*p->dim + x;
+	const short *voisins = p->topo->voisins[i];
 
-		case 'B': // Parcours des frontières blanches à la recherche d'un pion blanc:
-			for(i = 0 ; i < p->dim ; i++)
-			{
-				if(p->tab[i][0] == 'B') frontiere_1 = true;
-			}
-			for(i = 0 ; i < p->dim ; i++)
-			{
-				if(p->tab[i][p->dim-1] == 'B') frontiere_2 = true;
-			}
-		break;
+	connexite_ouvre_coup(&p->groupes, n);
 
-		default:
-			return false;
-		break;
+	for ( k = 0 ; k < 6 ; k++ ) // Les cases de garde étant vides, aucun test de bornes n'est nécessaire
+	{
+		if(bb_teste(&p->pions[couleur], voisins[k]))
+		{
+			connexite_unit(&p->groupes, couleur, n, p->topo->numeros[voisins[k]]);
+		}
 	}
 
-	return frontiere_1 && frontiere_2;
+	// Frontières: haut/bas pour le noir, gauche/droite pour le blanc (noeuds virtuels nb_cases et nb_cases+1)
+	if(bb_teste(&p->bords[2*couleur], i))
+	{
+		connexite_unit(&p->groupes, couleur, n, p->groupes.nb_cases);
+	}
+	if(bb_teste(&p->bords[2*couleur+1], i))
+	{
+		connexite_unit(&p->groupes, couleur, n, p->groupes.nb_cases+1);
+	}
 }
 
 /*!
- *	\author	Julien Laurent, Lucas Dessaignes
- *	\param	x Abscisse matricielle de la case de départ
- *	\param	y Ordonnée matricielle de la case de départ
- *	\param	p Pointeur sur le plateau à parcourir
- *	\param	winning Tableau de deux booléens, utilisé par #check_gain() pour déterminer si la partie est finie ou non
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur le plateau à modifier
+ *	\param	x Abscisse matricielle de la case
+ *	\param	y Ordonnée matricielle de la case
+ *	\param	pion Pion à placer (\a N ou \a B), ou \a V pour vider la case
  *
- *	Fonction récursive sautant de case blanche en case blanche à partir d'une case de départ,
- *	et plaçant la valeur \a vrai dans l'un des deux booléens du tableau \a winning dès qu'elle atteint
- *	l'une des deux frontières du joueur blanc.
+ *	Seul point d'écriture dans le plateau: met à jour les #bitboard des deux couleurs,
+ *	la matrice \a tab utilisée par l'affichage et la sauvegarde, la clé de Zobrist, les scores des
+ *	pions de chaque couleur, ainsi que les groupes connexes.
+ *	Les scores de #score_losanges() et #score_connexions() sont symétriques (un pion compte pour son
+ *	voisin ce que le voisin compte pour lui): poser ou retirer un pion change donc le total de sa
+ *	couleur de deux fois son propre score, sans qu'il soit nécessaire de revisiter ses voisins.
+ *	Le cas courant (pose sur une case vide, ou retrait du dernier pion posé, comme lors de la
+ *	construction de l'arbre de jeu) est traité de manière incrémentale. Toute autre modification
+ *	provoque une reconstruction complète des groupes.
  */
-void jumperBlanc(int x, int y, plateau *p, bool *winning)
+void pose_pion(plateau *p, int x, int y, char pion)
 {
-	p->checked[y][x] = true; // On marque la case pour ne pas revenir dessus par la suite
+	int i = indice_case(p, x, y);
+	int couleur = indice_couleur(pion);
+	char ancien = case_plateau(p, x, y);
+	int ancienne = indice_couleur(ancien);
 
-	if(x == 0) // Si on a atteint la frontière blanche de gauche, on a l'une des deux conditions de gain
+	if(ancienne >= 0) // On retire la clé et les scores de l'ancien pion,
 	{
-		winning[0] = true;
-	}
-	if (x == p->dim-1) // Si on a atteint la frontière blanche de droite, on a l'une des deux conditions de gain
-	{
-		winning[1] = true;
+		p->cle ^= cles_zobrist[ancienne][i];
+		p->scores_losanges[ancienne] -= 2 * score_losanges(p, i, ancienne);
+		p->scores_connexions[ancienne] -= 2 * score_connexions(p, i, ancienne);
 	}
 
-	// On continue à sauter sur les pions blancs adjacents non-visités:
+	bb_retire(&p->pions[0], i); // on vide la case dans les deux bitboards,
+	bb_retire(&p->pions[1], i);
 
-	if( coordValide(x, y-1, p, 'B') )
+	if(couleur >= 0) // puis on y place le pion demandé s'il s'agit d'un vrai pion
 	{
-		jumperBlanc(x, y-1, p, winning);
+		bb_place(&p->pions[couleur], i);
+		p->cle ^= cles_zobrist[couleur][i];
+		p->scores_losanges[couleur] += 2 * score_losanges(p, i, couleur); // (ses voisins comptent pour lui, et lui pour eux)
+		p->scores_connexions[couleur] += 2 * score_connexions(p, i, couleur);
 	}
 
-	if (coordValide(x+1, y-1, p, 'B'))
+	if(p->tab != NULL) // (Les copies de travail de l'IA n'ont pas de matrice)
 	{
-		jumperBlanc(x+1, y-1, p, winning);
+		p->tab[y][x] = (couleur >= 0) ? pion : 'V';
 	}
 
-	if (coordValide(x+1, y, p, 'B'))
+	if(ancien == 'V' && couleur >= 0) // Pose sur une case vide
 	{
-		jumperBlanc(x+1, y, p, winning);
+		relie_pion(p, x, y, couleur);
 	}
-
-	if (coordValide(x, y+1, p, 'B'))
+	else if(ancien != 'V' && couleur < 0 && connexite_dernier_coup(&p->groupes) == y*p->dim + x) // Retrait du dernier pion
 	{
-		jumperBlanc(x, y+1, p, winning);
+		connexite_annule_coup(&p->groupes);
 	}
-
-	if (coordValide(x-1, y+1, p, 'B'))
+	else if(ancien != pion)
 	{
-		jumperBlanc(x-1, y+1, p, winning);
+		reconstruit_groupes(p);
 	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur le plateau à mettre à jour
+ *
+ *	Repart de groupes vides, et y enregistre un à un tous les pions présents dans les bitboards
+ *	(dans un ordre arbitraire, qui n'a pas d'importance pour la suite). Les pions sont replacés
+ *	progressivement dans les bitboards, pour que chaque union soit attribuée au coup qui l'a provoquée.
+ *	Les scores des pions sont recalculés sur tout le plateau à la fois (utile quand les bitboards ont
+ *	été remplis directement, sans passer par #pose_pion()).
+ */
+void reconstruit_groupes(plateau *p)
+{
+	int couleur, i;
+	bitboard pions[2] = {p->pions[0], p->pions[1]};
+
+	connexite_initialise(&p->groupes, p->dim * p->dim);
+	p->pions[0] = bb_nul();
+	p->pions[1] = bb_nul();
 
-	if (coordValide(x-1, y, p, 'B'))
+	for ( couleur = 0 ; couleur < 2 ; couleur++ )
 	{
-		jumperBlanc(x-1, y, p, winning);
+		while((i = bb_extrait(&pions[couleur])) >= 0)
+		{
+			bb_place(&p->pions[couleur], i);
+			relie_pion(p, i % p->largeur, i / p->largeur - 2, couleur);
+		}
+		p->scores_losanges[couleur] = total_losanges(p, couleur);
+		p->scores_connexions[couleur] = total_connexions(p, couleur);
 	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur le plateau considéré (pour la largeur des lignes)
+ *	\param	b Ensemble de cases de départ
+ *	\return	Ensemble des cases voisines d'au moins une case de \a b
+ *
+ *	Les six voisins d'une case (x, y) sont (x, y-1), (x+1, y-1), (x+1, y), (x, y+1), (x-1, y+1) et (x-1, y),
+ *	ce qui correspond dans un #bitboard aux décalages -L, -L+1, +1, +L, +L-1 et -1 (où L est la largeur
+ *	d'une ligne). Les colonnes de garde garantissent qu'aucun voisin ne "déborde" sur la ligne suivante.
+ *	Le résultat peut contenir des cases de garde: il faut le restreindre à p->cases si nécessaire.
+ */
+bitboard voisinage(const plateau *p, bitboard b)
+{
+	int L = p->largeur;
+	bitboard r = bb_ou(bb_decale(b, -L), bb_decale(b, -L+1));
+
+	r = bb_ou(r, bb_decale(b, 1));
+	r = bb_ou(r, bb_decale(b, L));
+	r = bb_ou(r, bb_decale(b, L-1));
+	r = bb_ou(r, bb_decale(b, -1));
 
-	return;
+	return r;
 }
 
 /*!
- *	\author	Julien Laurent, Lucas Dessaignes
- *	\param	x Abscisse matricielle de la case de départ
- *	\param	y Ordonnée matricielle de la case de départ
+ *	\author	Julien Laurent
  *	\param	p Pointeur sur le plateau à parcourir
- *	\param	winning Tableau de deux booléens, utilisé par #check_gain() pour déterminer si la partie est finie ou non
+ *	\param	i Indice de la case de départ (qui doit contenir un pion de la couleur donnée)
+ *	\param	couleur Indice de la couleur du groupe (0: noir, 1: blanc)
+ *	\return	Ensemble des pions du groupe contenant la case de départ
  *
- *	Fonction récursive sautant de case noire en case noire à partir d'une case de départ,
- *	et plaçant la valeur \a vrai dans l'un des deux booléens du tableau \a winning dès qu'elle atteint
- *	l'une des deux frontières du joueur noir.
+ *	Remplace les anciens parcours récursifs (jumpers): le groupe est étendu à tous les pions de
+ *	la couleur voisins du groupe courant, simultanément, jusqu'à stabilisation.
  */
-void jumperNoir(int x, int y, plateau *p, bool *winning)
+bitboard composante(const plateau *p, int i, int couleur)
 {
-	p->checked[y][x] = true; // On marque la case pour ne pas revenir dessus par la suite
+	bitboard groupe = bb_nul(), suivant = bb_nul();
 
-	if(y == 0) // Si on a atteint la frontière noire du haut, on a l'une des deux conditions de gain
-	{
-		winning[0] = true;
-	}
-	if (y == p->dim-1) // Si on a atteint la frontière noire du bas, on a l'une des deux conditions de gain
+	bb_place(&suivant, i);
+	suivant = bb_et(suivant, p->pions[couleur]);
+
+	while(!bb_egal(groupe, suivant))
 	{
-		winning[1] = true;
+		groupe = suivant;
+		suivant = bb_et(bb_ou(groupe, voisinage(p, groupe)), p->pions[couleur]);
 	}
 
-	// On continue à sauter sur les pions noirs adjacents non-visités:
+	return groupe;
+}
 
-	if( coordValide(x, y-1, p, 'N') )
+/*!
+ *	\author	Julien Laurent
+ *	\param	x Abscisse matricielle de la case à vérifier
+ *	\param	y Ordonnée matricielle de la case à vérifier
+ *	\param	p Pointeur sur le plateau concerné
+ *	\return	Vrai si la case existe sur le plateau, faux sinon
+ */
+bool coordExiste(int x, int y, plateau *p)
+{
+	return (x>=0)&&(y>=0)&&(x<p->dim)&&(y<p->dim) ;
+}
+
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	nbtours Nombre de tours qui ont eu lieu avant l'appel. Utile pour économiser des traitements en début de partie
+ *	\param	x Abscisse matricielle du dernier coup joué
+ *	\param	y Ordonnée matricielle du dernier coup joué
+ *	\param	p Pointeur sur le plateau à analyser
+ *	\return	Vrai si le dernier pion posé est un pion gagnant, faux sinon
+ *
+ *	Cette fonction est chargée de vérifier les conditions nécessaires et suffisantes au gain du joueur
+ *	qui vient de placer un pion sur la case correspondant aux coordonnées \a x et \a y passées en paramètre.
+ *	Les groupes connexes du plateau (voir #connexite) étant tenus à jour à chaque pose de pion, il suffit
+ *	de vérifier que les deux frontières de la couleur de ce pion appartiennent au même groupe.
+ */
+bool check_gain(int nbtours, int x, int y, plateau *p)
+{
+	if(nbtours < (2*p->dim)-1) // La partie ne peut être gagnée que si un nombre suffisant de pions ont été placés
 	{
-		jumperNoir(x, y-1, p, winning);
+		return false;
 	}
 
-	if (coordValide(x+1, y-1, p, 'N'))
+	int couleur = indice_couleur(case_plateau(p, x, y));
+
+	if(couleur < 0)
 	{
-		jumperNoir(x+1, y-1, p, winning);
+		return false;
 	}
 
-	if (coordValide(x+1, y, p, 'N'))
+	// Le joueur a gagné si ses deux frontières appartiennent au même groupe
+	return connexite_relies(&p->groupes, couleur, p->groupes.nb_cases, p->groupes.nb_cases+1);
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	p Pointeur sur le plateau à analyser
+ *	\return	Couleur du gagnant (\a N ou \a B), ou \a V si aucun joueur n'a relié ses frontières
+ *
+ *	Variante de #check_gain() qui ne dépend pas du dernier coup joué.
+ */
+char gagnant(const plateau *p)
+{
+	if(connexite_relies(&p->groupes, 0, p->groupes.nb_cases, p->groupes.nb_cases+1))
 	{
-		jumperNoir(x+1, y, p, winning);
+		return 'N';
 	}
-
-	if (coordValide(x, y+1, p, 'N'))
+	else if(connexite_relies(&p->groupes, 1, p->groupes.nb_cases, p->groupes.nb_cases+1))
 	{
-		jumperNoir(x, y+1, p, winning);
+		return 'B';
 	}
-
-	if (coordValide(x-1, y+1, p, 'N'))
+	else
 	{
-		jumperNoir(x-1, y+1, p, winning);
+		return 'V';
 	}
+}
 
-	if (coordValide(x-1, y, p, 'N'))
+/*!
+ *	\author	Lucas Dessaignes, Alexis Brisset
+ *	\param	pion Couleur considérée (influe sur les frontières vérifiées, et les pions recherchés)
+ *	\param	p Pointeur sur le plateau à analyser
+ *
+ *	Cette fonction renvoie vrai si au moins un pion de la couleur passée en paramètre est présent sur
+ *	chacune des deux frontières de cette couleur. Sinon, elle renvoie faux.
+ */
+bool presenceLignes(char pion, plateau *p)
+{
+	int couleur = indice_couleur(pion);
+
+	if(couleur < 0)
 	{
-		jumperNoir(x-1, y, p, winning);
+		return false;
 	}
 
-	return;
+	return !bb_est_nul(bb_et(p->pions[couleur], p->bords[2*couleur])) && !bb_est_nul(bb_et(p->pions[couleur], p->bords[2*couleur+1]));
 }
 
 /*!
@@ -342,4 +411,18 @@ void latence(int secondes)
     return;
 }
 
-
+/*!
+ *	\author	Julien Laurent
+ *	\return	Nombre de processeurs (logiques) de la machine, au moins 1
+ */
+int nombre_coeurs(void)
+{
+#ifdef _WIN32
+	SYSTEM_INFO infos;
+	GetSystemInfo(&infos);
+	return (infos.dwNumberOfProcessors > 0) ? (int)infos.dwNumberOfProcessors : 1;
+#else
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return (n > 0) ? (int)n : 1;
+#endif
+}
@@ -17,15 +17,41 @@
 #include <stdbool.h>
 #include <time.h>
 
+#include "bitboard.h"
+#include "union_find.h"
+#include "zobrist.h"
+#include "topologie.h"
+#include "motifs.h"
+
 /// Autorise la redirection d'stdin, stdout et stderr sur la console sous Windows malgré l'utilisation de la SDL
 #define WIN_DEBUG
 
+/*!
+ *	\brief	Entrée de l'historique des coups d'un plateau
+ *	\author	Julien Laurent
+ *
+ *	Chaque coup joué par #joue_coup() est empilé dans l'historique du plateau, pour pouvoir être
+ *	annulé par #dejoue_coup().
+ */
+struct coup_joue
+{
+	unsigned char x; ///< Abscisse matricielle du coup
+	unsigned char y; ///< Ordonnée matricielle du coup
+	char pion; ///< Pion posé ('N' ou 'B')
+};
+typedef struct coup_joue coup_joue; ///< Raccourci d'utilisation du type #coup_joue
+
 /*!
  *	\brief	Modèle du plateau de jeu
  *	\author	Julien Laurent, Lucas Dessaignes, Alexis Brisset
  *
  *	Représente le plateau de jeu, les pions qu'il peut contenir, et des métadonnées
  *	utilisées par différentes fonctions (notamment l'IA, et #check_gain())
+ *	Le contenu du plateau est stocké sous forme de #bitboard (un par couleur), sur lesquels
+ *	travaillent l'IA et la détection des gains. La matrice \a tab n'en est qu'une copie,
+ *	conservée pour les modules d'affichage et de sauvegarde: toute modification du plateau
+ *	doit donc passer par #pose_pion(), ou mieux par #joue_coup() et #dejoue_coup() (déclarées dans
+ *	move_stack.h), qui tiennent aussi à jour l'historique des coups.
  *	Le constructeur de plateau est intitulé #nouveau_plateau(), déclaré dans engine_functions.h
  *	et défini dans engine_functions.c
  *	Le destructeur de plateau est intitulé #detruis_plateau(), déclaré dans engine_functions.h
@@ -34,10 +60,18 @@
 struct plateau
 {
 	int dim; ///< Dimension du plateau, initialisée lors de la construction
-	char **tab; ///< Tableau contenant la représentation matricielle du contenu du plateau (N: Noir, B: Blanc, V: Vide)
-	bool **checked; ///< Tableau utilisé par les fonctions de parcours (#jumperBlanc() et #jumperNoir()) pour éviter les boucles infinies
-	//int **valeurN; ///< Tableau de "valeurs" des cases noires
-	//int **valeurB; ///< Tableau de "valeurs" des cases blanches
+	int largeur; ///< Largeur d'une ligne dans les #bitboard du plateau (dimension + 2 colonnes de garde)
+	const topologie *topo; ///< Topologie (voisines, frontières) des plateaux de cette dimension, partagée
+	char **tab; ///< Représentation matricielle du contenu du plateau (N: Noir, B: Blanc, V: Vide), conservée pour l'affichage et la sauvegarde, et tenue à jour par #pose_pion() (NULL pour les copies de travail de l'IA)
+	bitboard pions[2]; ///< Cases occupées par les pions noirs (indice 0) et blancs (indice 1)
+	bitboard cases; ///< Ensemble des cases existantes du plateau (hors colonnes et lignes de garde)
+	bitboard bords[4]; ///< Cases des frontières: haut et bas (noires, indices 0 et 1), gauche et droite (blanches, indices 2 et 3)
+	connexite groupes; ///< Groupes connexes de chaque couleur (avec les frontières), tenus à jour par #pose_pion() pour #check_gain()
+	uint64_t cle; ///< Clé de Zobrist du contenu du plateau, tenue à jour par #pose_pion()
+	int scores_losanges[2]; ///< Somme des #score_losanges() des pions de chaque couleur (chaque \a bridge y compte deux fois), tenue à jour par #pose_pion() pour #eval_losanges()
+	int scores_connexions[2]; ///< Somme des #score_connexions() des pions de chaque couleur, tenue à jour de la même façon
+	coup_joue historique[DIM_MAX*DIM_MAX]; ///< Pile des coups joués par #joue_coup(), dans l'ordre
+	int nb_coups; ///< Nombre de coups dans l'historique
 };
 typedef struct plateau plateau; ///< Raccourci d'utilisation du type #plateau
 
@@ -79,20 +113,86 @@ typedef struct joueur joueur; ///< Raccourci d'utilisation du type #joueur
 char couleur_opposee(char couleur);
 
 
+/// Renvoie l'indice (0 pour N, 1 pour B) associé à une couleur de pion, ou -1 pour toute autre valeur
+int indice_couleur(char pion);
+
+/// Renvoie l'indice dans les #bitboard du plateau de la case aux coordonnées données
+static inline int indice_case(const plateau *p, int x, int y)
+{
+	return (y+2) * p->largeur + x;
+}
+
+/// Renvoie le contenu ('N', 'B' ou 'V') de la case aux coordonnées données
+char case_plateau(const plateau *p, int x, int y);
+
+/// Place le pion donné ('N', 'B', ou 'V' pour vider la case) aux coordonnées données
+void pose_pion(plateau *p, int x, int y, char pion);
+
+/// Renvoie l'ensemble des cases vides (donc jouables) du plateau
+static inline bitboard cases_vides(const plateau *p)
+{
+	return bb_sauf(p->cases, bb_ou(p->pions[0], p->pions[1]));
+}
+
+/// Renvoie le score (pondéré selon l'orientation, voir #poids_losanges) des \a bridges que forme, ou formerait, un pion de la couleur d'indice donné sur la case d'indice \a i
+static inline int score_losanges(const plateau *p, int i, int couleur)
+{
+	const int L = p->largeur;
+	const bitboard *amis = &p->pions[couleur];
+
+	return poids_losanges[couleur][bb_teste(amis, i-2*L+1) | bb_teste(amis, i-L+2) << 1 | bb_teste(amis, i+L+1) << 2
+			| bb_teste(amis, i+2*L-1) << 3 | bb_teste(amis, i+L-2) << 4 | bb_teste(amis, i-L-1) << 5];
+}
+
+/// Renvoie le score (pondéré selon l'orientation, voir #poids_connexions) des connexions directes que forme, ou formerait, un pion de la couleur d'indice donné sur la case d'indice \a i
+static inline int score_connexions(const plateau *p, int i, int couleur)
+{
+	const int L = p->largeur;
+	const bitboard *amis = &p->pions[couleur];
+
+	return poids_connexions[couleur][bb_teste(amis, i-L) | bb_teste(amis, i-L+1) << 1 | bb_teste(amis, i+1) << 2
+			| bb_teste(amis, i+L) << 3 | bb_teste(amis, i+L-1) << 4 | bb_teste(amis, i-1) << 5];
+}
+
+/// Renvoie la somme des #score_losanges() de tous les pions de la couleur d'indice donné, calculée sur tout le plateau à la fois (chaque \a bridge est compté par ses deux pions)
+static inline int total_losanges(const plateau *p, int couleur)
+{
+	const int L = p->largeur;
+	const unsigned char *poids = poids_losanges[couleur]; // (Poids d'une seule case de bridge: poids[1 << d])
+
+	return 2 * (poids[1 << 2] * bb_paires(p->pions[couleur], L+1) + poids[1 << 3] * bb_paires(p->pions[couleur], 2*L-1) + poids[1 << 4] * bb_paires(p->pions[couleur], L-2));
+}
+
+/// Renvoie la somme des #score_connexions() de tous les pions de la couleur d'indice donné, calculée sur tout le plateau à la fois
+static inline int total_connexions(const plateau *p, int couleur)
+{
+	const int L = p->largeur;
+	const unsigned char *poids = poids_connexions[couleur];
+
+	return 2 * (poids[1 << 3] * bb_paires(p->pions[couleur], L) + poids[1 << 4] * bb_paires(p->pions[couleur], L-1) + poids[1 << 2] * bb_paires(p->pions[couleur], 1));
+}
+
+
+/// Renvoie l'ensemble des cases voisines d'au moins une case de l'ensemble passé en paramètre
+bitboard voisinage(const plateau *p, bitboard b);
+
+/// Renvoie la composante connexe (groupe de pions) de la couleur donnée contenant la case d'indice \a i
+bitboard composante(const plateau *p, int i, int couleur);
+
+
+/// Recalcule entièrement les groupes connexes (et les scores des pions) du plateau à partir des bitboards
+void reconstruit_groupes(plateau *p);
+
 /// Renvoie vrai si le dernier pion placé signe une fin de jeu
 bool check_gain(int nbtours, int x, int y, plateau *p);
 
+/// Renvoie la couleur du joueur dont les deux frontières sont reliées ('N' ou 'B'), ou 'V' si personne n'a gagné
+char gagnant(const plateau *p);
+
 /// Renvoie vrai si au moins un pion de la couleur donnée est posé sur chacune des frontières de cette couleur
 bool presenceLignes(char pion, plateau *p);
 
-/// Ce jumper saute de case blanche en case blanche, et indique s'il touche l'une ou l'autre des deux frontières blanches
-void jumperBlanc(int x, int y, plateau *p, bool *winning);
-/// Ce jumper saute de case noire en case noire, et indique s'il touche l'une ou l'autre des deux frontières noires
-void jumperNoir(int x, int y, plateau *p, bool *winning);
 
-
-/// Renvoie vrai si la case aux coordonnées données existe, a la couleur demandée et n'a pas déjà été visitée par un \a jumper
-bool coordValide(int x, int y, plateau *p, char pion);
 /// Renvoie vrai si les coordonnées passées en paramètre sont valides, pour le plateau dont l'adresse est passée en paramètre
 bool coordExiste(int x, int y, plateau *p);
 
@@ -105,5 +205,8 @@ int hasard(int minimum, int maximum);
 /// Suspend l'exécution du programme pendant la durée passée en paramètre
 void latence(int secondes);
 
+/// Renvoie le nombre de processeurs de la machine (pour dimensionner les recherches parallèles)
+int nombre_coeurs(void);
+
 
 #endif // DATA_MODELS_H_INCLUDED
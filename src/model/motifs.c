@@ -0,0 +1,72 @@
+/*!
+ *	\file	motifs.c
+ *	\brief	Tables de motifs de voisinage (fichier généré par outils/genere_motifs.c: ne pas modifier)
+ *	\author	Julien Laurent
+ *
+ *	729 anneaux, dont 52 analysés (un par classe de symétrie).
+ */
+
+#include "motifs.h"
+
+const bool motifs_morts[NB_MOTIFS_ANNEAU] =
+{
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+	0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 1, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 1, 1, 1,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 1, 1, 1,
+	0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 1, 1, 1,
+	0, 1, 0, 0, 1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1, 0, 0, 1, 0, 1, 1, 1,
+	0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 1, 1, 1,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 1, 1, 1,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+	0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 1, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+	0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 1, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+	0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 1, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+	0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 1, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+	0, 0, 1, 1, 1, 1, 0, 0, 1, 0, 0, 1, 1, 1, 1, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1
+};
+
+const unsigned char poids_losanges[2][NB_MOTIFS_AMIS] =
+{
+	{
+		0, 3, 1, 4, 2, 5, 3, 6, 3, 6, 4, 7, 5, 8, 6, 9,
+		1, 4, 2, 5, 3, 6, 4, 7, 4, 7, 5, 8, 6, 9, 7, 10,
+		2, 5, 3, 6, 4, 7, 5, 8, 5, 8, 6, 9, 7, 10, 8, 11,
+		3, 6, 4, 7, 5, 8, 6, 9, 6, 9, 7, 10, 8, 11, 9, 12
+	},
+	{
+		0, 1, 3, 4, 2, 3, 5, 6, 1, 2, 4, 5, 3, 4, 6, 7,
+		3, 4, 6, 7, 5, 6, 8, 9, 4, 5, 7, 8, 6, 7, 9, 10,
+		2, 3, 5, 6, 4, 5, 7, 8, 3, 4, 6, 7, 5, 6, 8, 9,
+		5, 6, 8, 9, 7, 8, 10, 11, 6, 7, 9, 10, 8, 9, 11, 12
+	}
+};
+
+const unsigned char poids_connexions[2][NB_MOTIFS_AMIS] =
+{
+	{
+		0, 3, 2, 5, 1, 4, 3, 6, 3, 6, 5, 8, 4, 7, 6, 9,
+		2, 5, 4, 7, 3, 6, 5, 8, 5, 8, 7, 10, 6, 9, 8, 11,
+		1, 4, 3, 6, 2, 5, 4, 7, 4, 7, 6, 9, 5, 8, 7, 10,
+		3, 6, 5, 8, 4, 7, 6, 9, 6, 9, 8, 11, 7, 10, 9, 12
+	},
+	{
+		0, 1, 2, 3, 3, 4, 5, 6, 1, 2, 3, 4, 4, 5, 6, 7,
+		2, 3, 4, 5, 5, 6, 7, 8, 3, 4, 5, 6, 6, 7, 8, 9,
+		3, 4, 5, 6, 6, 7, 8, 9, 4, 5, 6, 7, 7, 8, 9, 10,
+		5, 6, 7, 8, 8, 9, 10, 11, 6, 7, 8, 9, 9, 10, 11, 12
+	}
+};
@@ -0,0 +1,37 @@
+/*!
+ *	\file	motifs.h
+ *	\brief	Tables de motifs de voisinage
+ *	\author	Julien Laurent
+ *
+ *	Ce fichier déclare les tables indexées par le contenu du voisinage d'une case, qui remplacent
+ *	les calculs (et les branchements) de l'analyse locale par une simple lecture. Les tables sont
+ *	définies dans motifs.c, un fichier généré par le programme outils/genere_motifs.c: il ne doit
+ *	pas être modifié à la main. Pour changer une pondération ou la définition d'un motif, il faut
+ *	modifier le générateur, puis régénérer le fichier:
+ *	\code gcc -o genere_motifs outils/genere_motifs.c && ./genere_motifs > model/motifs.c \endcode
+ *
+ *	Deux sortes de voisinages sont utilisées, parcourus dans l'ordre circulaire (deux voisines
+ *	consécutives sont voisines entre elles, et celle d'indice d+3 (modulo 6) est opposée à celle
+ *	d'indice d):
+ *	- l'anneau des six voisines: haut, haut-droite, droite, bas, bas-gauche, gauche;
+ *	- les six cases de \a bridge: (x+1, y-2), (x+2, y-1), (x+1, y+1), (x-1, y+2), (x-2, y+1), (x-1, y-1).
+ */
+
+#ifndef MOTIFS_H_INCLUDED
+#define MOTIFS_H_INCLUDED
+
+#include <stdbool.h>
+
+#define NB_MOTIFS_ANNEAU 729 ///< Nombre de contenus possibles des six voisines d'une case (vide, noir ou blanc: 3 puissance 6)
+#define NB_MOTIFS_AMIS 64 ///< Nombre d'ensembles possibles de cases amies parmi six (2 puissance 6)
+
+/// Vrai pour les anneaux (codés en base 3: 0 vide, 1 noir, 2 blanc) qui rendent morte la case qu'ils entourent (voir inferieures.c)
+extern const bool motifs_morts[NB_MOTIFS_ANNEAU];
+
+/// Score des \a bridges d'un pion de chaque couleur selon ses cases de \a bridge amies (bit d pour la case d)
+extern const unsigned char poids_losanges[2][NB_MOTIFS_AMIS];
+
+/// Score des connexions directes d'un pion de chaque couleur selon ses voisines amies (bit d pour la voisine d)
+extern const unsigned char poids_connexions[2][NB_MOTIFS_AMIS];
+
+#endif // MOTIFS_H_INCLUDED
@@ -0,0 +1,93 @@
+/*!
+ *	\file	topologie.c
+ *	\brief	Topologie précalculée des plateaux de chaque dimension
+ *	\author	Julien Laurent
+ *
+ *	Une topologie par dimension possible, construite par le premier #nouveau_plateau() de cette
+ *	dimension: les plateaux ne sont construits que par le fil principal, avant le lancement des
+ *	recherches, si bien que la construction n'a pas à être protégée.
+ */
+
+#include "topologie.h"
+
+static topologie topologies[DIM_MAX+1]; ///< Topologie de chaque dimension
+static bool topologies_construites[DIM_MAX+1] = {false}; ///< Vrai une fois la topologie de chaque dimension construite
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	t Topologie à remplir
+ *	\param	dim Dimension du plateau
+ *
+ *	Une voisine hors du plateau appartient à la frontière noire si elle est au-dessus ou au-dessous
+ *	du plateau, et à la frontière blanche si elle est à sa gauche ou à sa droite. Celles qui sont
+ *	à la fois au-dessus (ou au-dessous) et à côté n'appartiennent à aucune frontière en particulier:
+ *	l'anneau de la case n'est alors pas défini.
+ */
+static void construit_topologie(topologie *t, int dim)
+{
+	static const int dx[6] = {0, 1, 1, 0, -1, -1}; // Décalages des six voisins d'une case
+	static const int dy[6] = {-1, -1, 0, 1, 1, 0};
+	static const int puissances[6] = {1, 3, 9, 27, 81, 243}; // Poids de chaque voisine dans le code d'un anneau
+	const int L = dim + 2;
+	int k, d, x, y, vx, vy;
+	bool noire, blanche;
+
+	t->dim = dim;
+	t->largeur = L;
+	t->analysables = bb_nul();
+	for ( k = 0 ; k < BITS_BITBOARD ; k++ ) // (Cases de garde: seuls les numéros sont utiles)
+	{
+		t->numeros[k] = -1;
+	}
+
+	for ( y = 0 ; y < dim ; y++ )
+	{
+		for ( x = 0 ; x < dim ; x++ )
+		{
+			k = (y+2) * L + x;
+			bb_place(&t->analysables, k);
+			t->numeros[k] = y*dim + x;
+			t->distances[k][0] = y;
+			t->distances[k][1] = dim-1 - y;
+			t->distances[k][2] = x;
+			t->distances[k][3] = dim-1 - x;
+			t->codes_bords[k] = 0;
+			for ( d = 0 ; d < 6 ; d++ )
+			{
+				t->voisins[k][d] = k + dy[d]*L + dx[d];
+				vx = x + dx[d];
+				vy = y + dy[d];
+				noire = (vy < 0 || vy >= dim);
+				blanche = (vx < 0 || vx >= dim);
+				if(noire && blanche) // Coin aigu
+				{
+					bb_retire(&t->analysables, k);
+				}
+				else if(noire)
+				{
+					t->codes_bords[k] += puissances[d];
+				}
+				else if(blanche)
+				{
+					t->codes_bords[k] += 2 * puissances[d];
+				}
+			}
+		}
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	dim Dimension du plateau (au plus #DIM_MAX)
+ *	\return	Pointeur sur la topologie, partagée par tous les plateaux de cette dimension
+ */
+const topologie *topologie_plateau(int dim)
+{
+	if(!topologies_construites[dim])
+	{
+		construit_topologie(&topologies[dim], dim);
+		topologies_construites[dim] = true;
+	}
+
+	return &topologies[dim];
+}
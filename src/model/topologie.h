@@ -0,0 +1,43 @@
+/*!
+ *	\file	topologie.h
+ *	\brief	Topologie précalculée des plateaux de chaque dimension
+ *	\author	Julien Laurent
+ *
+ *	La forme du plateau ne dépend que de sa dimension: les voisines de chaque case, sa position par
+ *	rapport aux frontières et le voisinage des cases du bord sont donc calculés une fois pour toutes
+ *	(lors de la première construction d'un plateau de la dimension) et rangés dans des tableaux
+ *	contigus indexés par l'indice de case des #bitboard. Les parcours case par case (analyse locale,
+ *	connexions, circuit électrique, groupes) lisent ces tableaux au lieu de recalculer coordonnées
+ *	et décalages. Les topologies ne sont plus modifiées une fois construites: les fils de recherche
+ *	les partagent sans précaution.
+ */
+
+#ifndef TOPOLOGIE_H_INCLUDED
+#define TOPOLOGIE_H_INCLUDED
+
+#include "bitboard.h"
+
+/*!
+ *	\brief	Topologie d'un plateau d'une dimension donnée
+ *	\author	Julien Laurent
+ *
+ *	Les voisines d'une case sont rangées dans l'ordre circulaire de motifs.h (haut, haut-droite,
+ *	droite, bas, bas-gauche, gauche): celle d'indice d+3 (modulo 6) est opposée à celle d'indice d.
+ *	Les voisines hors du plateau tombent dans les colonnes et lignes de garde, toujours vides.
+ */
+struct topologie
+{
+	int dim; ///< Dimension du plateau
+	int largeur; ///< Largeur d'une ligne dans les #bitboard du plateau
+	short voisins[BITS_BITBOARD][6]; ///< Indices des six voisines de chaque case
+	short numeros[BITS_BITBOARD]; ///< Numéro de chaque case dans les groupes connexes (y * dim + x; -1 pour les cases de garde)
+	unsigned char distances[BITS_BITBOARD][4]; ///< Nombre de lignes (ou de colonnes) séparant chaque case de chaque frontière, dans l'ordre des bords du plateau (haut, bas, gauche, droite)
+	int codes_bords[BITS_BITBOARD]; ///< Code (voir motifs.h) de l'anneau de chaque case quand toutes ses voisines du plateau sont vides: une voisine hors du plateau y compte comme un pion de sa frontière
+	bitboard analysables; ///< Cases dont l'anneau est bien défini (toutes sauf les deux coins aigus, voisins d'un point commun aux deux frontières)
+};
+typedef struct topologie topologie; ///< Raccourci d'utilisation du type #topologie
+
+/// Renvoie la topologie des plateaux de la dimension donnée, construite au premier appel (à faire hors des fils de recherche)
+const topologie *topologie_plateau(int dim);
+
+#endif // TOPOLOGIE_H_INCLUDED
@@ -0,0 +1,161 @@
+/*!
+ *	\file	union_find.c
+ *	\brief	Fonctions de la structure de connexité incrémentale
+ *	\author	Julien Laurent
+ *
+ *	Définitions des opérations de la structure #connexite: recherche de racine, union par rang,
+ *	et annulation des unions coup par coup.
+ */
+
+#include "union_find.h"
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	c Pointeur sur la structure à réinitialiser
+ *	\param	nb_cases Nombre de cases du plateau associé
+ */
+void connexite_initialise(connexite *c, int nb_cases)
+{
+	int couleur, n;
+
+	c->nb_cases = nb_cases;
+	c->nb_unions = 0;
+	c->nb_coups = 0;
+
+	for ( couleur = 0 ; couleur < 2 ; couleur++ )
+	{
+		for ( n = 0 ; n < nb_cases+2 ; n++ )
+		{
+			c->parent[couleur][n] = n;
+			c->rang[couleur][n] = 0;
+		}
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	c Pointeur sur la structure à consulter
+ *	\param	couleur Indice de la couleur considérée
+ *	\param	n Noeud dont on cherche le groupe
+ *	\return	Racine du groupe contenant \a n
+ *
+ *	Grâce à l'union par rang, la hauteur des arbres ne dépasse pas log2(#NOEUDS_CONNEXITE), soit 8:
+ *	la compression de chemin (qui empêcherait l'annulation) n'est donc pas nécessaire.
+ */
+int connexite_racine(const connexite *c, int couleur, int n)
+{
+	while(c->parent[couleur][n] != n)
+	{
+		n = c->parent[couleur][n];
+	}
+	return n;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	c Pointeur sur la structure à modifier
+ *	\param	couleur Indice de la couleur considérée
+ *	\param	a Premier noeud
+ *	\param	b Second noeud
+ *
+ *	La racine de plus faible rang est rattachée à l'autre, et l'opération est empilée dans l'historique
+ *	pour pouvoir être annulée par #connexite_annule_coup().
+ */
+void connexite_unit(connexite *c, int couleur, int a, int b)
+{
+	int tmp;
+
+	a = connexite_racine(c, couleur, a);
+	b = connexite_racine(c, couleur, b);
+
+	if(a == b) // Déjà dans le même groupe: rien à faire (ni à annuler)
+	{
+		return;
+	}
+
+	if(c->rang[couleur][a] > c->rang[couleur][b]) // On rattache toujours a (le plus "bas") à b
+	{
+		tmp = a;
+		a = b;
+		b = tmp;
+	}
+
+	c->parent[couleur][a] = b;
+
+	// Historique: noeud rattaché (8 bits), couleur (1 bit), incrément du rang de b (1 bit)
+	if(c->rang[couleur][a] == c->rang[couleur][b])
+	{
+		c->rang[couleur][b]++;
+		c->historique[c->nb_unions++] = a | (couleur << 8) | (1 << 9);
+	}
+	else
+	{
+		c->historique[c->nb_unions++] = a | (couleur << 8);
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	c Pointeur sur la structure à consulter
+ *	\param	couleur Indice de la couleur considérée
+ *	\param	a Premier noeud
+ *	\param	b Second noeud
+ *	\return	Vrai si les deux noeuds appartiennent au même groupe
+ */
+bool connexite_relies(const connexite *c, int couleur, int a, int b)
+{
+	return connexite_racine(c, couleur, a) == connexite_racine(c, couleur, b);
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	c Pointeur sur la structure à modifier
+ *	\param	n Case jouée
+ */
+void connexite_ouvre_coup(connexite *c, int n)
+{
+	c->debut_coup[c->nb_coups] = c->nb_unions;
+	c->case_coup[c->nb_coups] = n;
+	c->nb_coups++;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	c Pointeur sur la structure à modifier
+ *
+ *	Dépile les unions effectuées depuis l'ouverture du dernier coup, dans l'ordre inverse: chaque noeud
+ *	rattaché redevient une racine, et le rang de son ancien parent est restauré si besoin.
+ */
+void connexite_annule_coup(connexite *c)
+{
+	int n, couleur;
+
+	if(c->nb_coups <= 0)
+	{
+		return;
+	}
+
+	c->nb_coups--;
+	while(c->nb_unions > c->debut_coup[c->nb_coups])
+	{
+		c->nb_unions--;
+		n = c->historique[c->nb_unions] & 0xFF;
+		couleur = (c->historique[c->nb_unions] >> 8) & 1;
+
+		if(c->historique[c->nb_unions] & (1 << 9))
+		{
+			c->rang[couleur][c->parent[couleur][n]]--;
+		}
+		c->parent[couleur][n] = n;
+	}
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	c Pointeur sur la structure à consulter
+ *	\return	Case du dernier coup ouvert, -1 si aucun
+ */
+int connexite_dernier_coup(const connexite *c)
+{
+	return (c->nb_coups > 0) ? c->case_coup[c->nb_coups-1] : -1;
+}
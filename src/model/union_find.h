@@ -0,0 +1,66 @@
+/*!
+ *	\file	union_find.h
+ *	\brief	Structure de connexité incrémentale (union-find réversible)
+ *	\author	Julien Laurent
+ *
+ *	Ce fichier déclare la structure #connexite, qui maintient pour chaque couleur la partition des pions
+ *	en groupes connexes, ainsi que deux noeuds virtuels représentant les frontières de cette couleur.
+ *	Un joueur a gagné dès que ses deux noeuds virtuels appartiennent au même groupe, ce qui se vérifie
+ *	en quelques accès mémoire, sans parcours du plateau.
+ *
+ *	Les unions sont faites par rang, sans compression de chemin, de manière à pouvoir être annulées:
+ *	chaque union est empilée dans un historique, et chaque coup y pose un marqueur. Le retrait d'un pion
+ *	(lors de la remontée dans l'arbre de jeu) dépile alors les unions effectuées par ce coup.
+ */
+
+#ifndef UNION_FIND_H_INCLUDED
+#define UNION_FIND_H_INCLUDED
+
+#include "bitboard.h"
+
+#define NOEUDS_CONNEXITE (DIM_MAX*DIM_MAX+2) ///< Nombre maximal de noeuds par couleur (cases + deux frontières)
+
+/*!
+ *	\brief	Partition des pions de chaque couleur en groupes connexes
+ *	\author	Julien Laurent
+ *
+ *	Les noeuds 0 à nb_cases-1 correspondent aux cases (y * dim + x), les noeuds nb_cases et nb_cases+1
+ *	aux deux frontières de la couleur considérée (haut et bas pour le noir, gauche et droite pour le blanc).
+ *	La structure ne contient aucun pointeur: la copie d'un #plateau par valeur en duplique donc l'état.
+ */
+struct connexite
+{
+	int nb_cases; ///< Nombre de cases du plateau associé
+	unsigned char parent[2][NOEUDS_CONNEXITE]; ///< Parent de chaque noeud, pour chaque couleur (un noeud racine est son propre parent)
+	unsigned char rang[2][NOEUDS_CONNEXITE]; ///< Rang (majorant de la hauteur) de chaque racine, pour chaque couleur
+	unsigned short historique[2*NOEUDS_CONNEXITE]; ///< Pile des unions effectuées (noeud rattaché, couleur, et incrément de rang éventuel)
+	int nb_unions; ///< Hauteur de la pile des unions
+	unsigned short debut_coup[DIM_MAX*DIM_MAX]; ///< Hauteur de la pile des unions au début de chaque coup
+	unsigned char case_coup[DIM_MAX*DIM_MAX]; ///< Case jouée lors de chaque coup
+	int nb_coups; ///< Nombre de coups enregistrés
+};
+typedef struct connexite connexite; ///< Raccourci d'utilisation du type #connexite
+
+
+/// Réinitialise la structure pour un plateau de \a nb_cases cases (tous les noeuds sont isolés)
+void connexite_initialise(connexite *c, int nb_cases);
+
+/// Renvoie la racine du groupe contenant le noeud \a n, pour la couleur d'indice \a couleur
+int connexite_racine(const connexite *c, int couleur, int n);
+
+/// Réunit les groupes des noeuds \a a et \a b pour la couleur d'indice \a couleur
+void connexite_unit(connexite *c, int couleur, int a, int b);
+
+/// Renvoie vrai si les noeuds \a a et \a b appartiennent au même groupe pour la couleur d'indice \a couleur
+bool connexite_relies(const connexite *c, int couleur, int a, int b);
+
+/// Ouvre un nouveau coup (joué sur la case \a n) : les unions suivantes lui seront rattachées
+void connexite_ouvre_coup(connexite *c, int n);
+
+/// Annule toutes les unions effectuées par le dernier coup ouvert
+void connexite_annule_coup(connexite *c);
+
+/// Renvoie la case du dernier coup ouvert, ou -1 si aucun coup n'a été enregistré
+int connexite_dernier_coup(const connexite *c);
+
+#endif // UNION_FIND_H_INCLUDED
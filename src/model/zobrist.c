@@ -0,0 +1,81 @@
+/*!
+ *	\file	zobrist.c
+ *	\brief	Clés de Zobrist pour le hachage des plateaux
+ *	\author	Julien Laurent
+ *
+ *	Les clés sont produites par un générateur "splitmix64" à graine fixe: elles sont donc identiques
+ *	d'une exécution à l'autre, ce qui rend les condensats reproductibles (et comparables entre deux
+ *	sessions de test).
+ */
+
+#include "zobrist.h"
+
+uint64_t cles_zobrist[2][BITS_BITBOARD];
+
+static bool zobrist_initialise = false; ///< Vrai une fois la table des clés remplie
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	etat Pointeur sur l'état du générateur
+ *	\return	Nombre pseudo-aléatoire de 64 bits
+ */
+static uint64_t splitmix64(uint64_t *etat)
+{
+	uint64_t z = (*etat += 0x9E3779B97F4A7C15ULL);
+
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+/*!
+ *	\author	Julien Laurent
+ *
+ *	Appelée à chaque construction de plateau: seul le premier appel remplit effectivement la table.
+ */
+void initialise_zobrist(void)
+{
+	uint64_t etat = 0x486578486578ULL; // Graine fixe
+	int couleur, i;
+
+	if(zobrist_initialise)
+	{
+		return;
+	}
+
+	for ( couleur = 0 ; couleur < 2 ; couleur++ )
+	{
+		for ( i = 0 ; i < BITS_BITBOARD ; i++ )
+		{
+			cles_zobrist[couleur][i] = splitmix64(&etat);
+		}
+	}
+
+	zobrist_initialise = true;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	pions Bitboards des pions noirs (indice 0) et blancs (indice 1)
+ *	\return	"Ou exclusif" des clés de tous les pions
+ *
+ *	Ne sert qu'à (re)calculer une clé de zéro: en cours de partie, la clé est tenue à jour
+ *	par #pose_pion().
+ */
+uint64_t cle_zobrist(const bitboard *pions)
+{
+	uint64_t cle = 0;
+	bitboard b;
+	int couleur, i;
+
+	for ( couleur = 0 ; couleur < 2 ; couleur++ )
+	{
+		b = pions[couleur];
+		while((i = bb_extrait(&b)) >= 0)
+		{
+			cle ^= cles_zobrist[couleur][i];
+		}
+	}
+
+	return cle;
+}
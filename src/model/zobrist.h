@@ -0,0 +1,26 @@
+/*!
+ *	\file	zobrist.h
+ *	\brief	Clés de Zobrist pour le hachage des plateaux
+ *	\author	Julien Laurent
+ *
+ *	Chaque couple (couleur, case) reçoit une clé pseudo-aléatoire de 64 bits. La clé d'un plateau est
+ *	le "ou exclusif" des clés de tous ses pions: poser ou retirer un pion revient donc à un seul XOR,
+ *	quelle que soit la dimension du plateau. Avec 64 bits, la probabilité que deux plateaux différents
+ *	rencontrés au cours d'une partie partagent la même clé est négligeable.
+ */
+
+#ifndef ZOBRIST_H_INCLUDED
+#define ZOBRIST_H_INCLUDED
+
+#include "bitboard.h"
+
+/// Clés de Zobrist, indexées par couleur (0 pour N, 1 pour B) et par indice de case dans les #bitboard
+extern uint64_t cles_zobrist[2][BITS_BITBOARD];
+
+/// Remplit la table des clés de Zobrist (sans effet si elle est déjà remplie)
+void initialise_zobrist(void);
+
+/// Renvoie la clé de Zobrist d'un ensemble de pions noirs et blancs (calcul complet)
+uint64_t cle_zobrist(const bitboard *pions);
+
+#endif // ZOBRIST_H_INCLUDED
@@ -0,0 +1,200 @@
+/*!
+ *	\file	genere_motifs.c
+ *	\brief	Générateur des tables de motifs de voisinage
+ *	\author	Julien Laurent
+ *
+ *	Ce programme indépendant (il n'utilise aucun autre fichier du logiciel) énumère tous les motifs
+ *	de voisinage d'une case, calcule la valeur de chacun, et écrit sur la sortie standard le fichier
+ *	model/motifs.c, qui définit les tables déclarées dans model/motifs.h:
+ *	\code gcc -o genere_motifs outils/genere_motifs.c && ./genere_motifs > model/motifs.c \endcode
+ *	Les pondérations de l'évaluation par les losanges sont regroupées en tête de fichier: les
+ *	modifier (ou les remplacer par des poids appris) ne demande que de régénérer les tables, sans
+ *	toucher aux boucles qui les consultent. Deux cases opposées doivent garder le même poids: une
+ *	connexion (ou un \a bridge) compte alors autant pour chacun de ses deux pions, ce que supposent
+ *	la mise à jour incrémentale de #pose_pion() et le décompte par décalages de #total_losanges().
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#define NB_MOTIFS_ANNEAU 729 ///< Nombre de contenus possibles des six voisines d'une case (3 puissance 6)
+#define NB_MOTIFS_AMIS 64 ///< Nombre d'ensembles possibles de cases amies parmi six (2 puissance 6)
+
+static const int puissances[6] = {1, 3, 9, 27, 81, 243}; ///< Poids de chaque voisine dans le code d'un anneau
+
+/// Poids de chaque case de \a bridge ((x+1, y-2), (x+2, y-1), (x+1, y+1), (x-1, y+2), (x-2, y+1), (x-1, y-1)), pour les Noirs puis les Blancs
+static const int poids_bridges[2][6] = {{3, 1, 2, 3, 1, 2}, {1, 3, 2, 1, 3, 2}};
+
+/// Poids de chaque voisine (haut, haut-droite, droite, bas, bas-gauche, gauche), pour les Noirs puis les Blancs
+static const int poids_voisines[2][6] = {{3, 2, 1, 3, 2, 1}, {1, 2, 3, 1, 2, 3}};
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	motif Code de l'anneau
+ *	\return	Vrai si l'anneau rend morte la case qu'il entoure
+ *
+ *	Une case est morte si, quelle que soit la couleur que prendront les voisines encore vides, les
+ *	pions de chaque couleur de l'anneau forment un seul arc: un pion posé sur la case ne relierait
+ *	alors rien qui ne le soit déjà par l'anneau lui-même, et sa couleur n'a aucune influence sur le
+ *	gagnant.
+ */
+static bool anneau_mort(int motif)
+{
+	int coloriage, i, couleur, arcs, nb_vides = 0;
+	int etats[6], vides[6];
+
+	for ( i = 0 ; i < 6 ; i++ )
+	{
+		etats[i] = (motif / puissances[i]) % 3;
+		if(etats[i] == 0)
+		{
+			vides[nb_vides++] = i;
+		}
+	}
+
+	for ( coloriage = 0 ; coloriage < (1 << nb_vides) ; coloriage++ )
+	{
+		for ( i = 0 ; i < nb_vides ; i++ ) // Chaque voisine vide prend la couleur donnée par le bit correspondant
+		{
+			etats[vides[i]] = 1 + ((coloriage >> i) & 1);
+		}
+
+		for ( couleur = 1 ; couleur <= 2 ; couleur++ )
+		{
+			arcs = 0;
+			for ( i = 0 ; i < 6 ; i++ ) // Nombre de débuts d'arcs de la couleur
+			{
+				if(etats[i] == couleur && etats[(i+5) % 6] != couleur)
+				{
+					arcs++;
+				}
+			}
+			if(arcs > 1)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	motif Code de l'anneau
+ *	\return	Plus petit code des anneaux équivalents
+ *
+ *	La mort d'une case ne dépend ni de l'orientation de son anneau (six rotations, et leurs reflets),
+ *	ni de l'attribution des couleurs: parmi ces 24 anneaux équivalents, seul celui de plus petit
+ *	code est analysé.
+ */
+static int anneau_canonique(int motif)
+{
+	int rotation, reflet, echange, i, code, etat, canonique = motif;
+	int etats[6];
+
+	for ( i = 0 ; i < 6 ; i++ )
+	{
+		etats[i] = (motif / puissances[i]) % 3;
+	}
+
+	for ( rotation = 0 ; rotation < 6 ; rotation++ )
+	{
+		for ( reflet = 0 ; reflet < 2 ; reflet++ )
+		{
+			for ( echange = 0 ; echange < 2 ; echange++ )
+			{
+				code = 0;
+				for ( i = 0 ; i < 6 ; i++ )
+				{
+					etat = etats[reflet ? (rotation + 6 - i) % 6 : (rotation + i) % 6];
+					if(echange && etat != 0)
+					{
+						etat = 3 - etat;
+					}
+					code += etat * puissances[i];
+				}
+				if(code < canonique)
+				{
+					canonique = code;
+				}
+			}
+		}
+	}
+
+	return canonique;
+}
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	nom Nom de la table
+ *	\param	poids Poids de chacune des six cases, pour chaque couleur
+ *
+ *	Écrit la table des sommes des poids des cases amies, pour chaque ensemble de cases amies.
+ */
+static void ecrit_poids(const char *nom, const int poids[2][6])
+{
+	int couleur, masque, d, somme;
+
+	printf("const unsigned char %s[2][NB_MOTIFS_AMIS] =\n{\n", nom);
+	for ( couleur = 0 ; couleur < 2 ; couleur++ )
+	{
+		printf("\t{");
+		for ( masque = 0 ; masque < NB_MOTIFS_AMIS ; masque++ )
+		{
+			somme = 0;
+			for ( d = 0 ; d < 6 ; d++ )
+			{
+				if(masque & (1 << d))
+				{
+					somme += poids[couleur][d];
+				}
+			}
+			printf("%s%s%d", masque ? "," : "", (masque % 16 == 0) ? "\n\t\t" : " ", somme);
+		}
+		printf("\n\t}%s\n", couleur ? "" : ",");
+	}
+	printf("};\n");
+}
+
+int main(void)
+{
+	static bool morts[NB_MOTIFS_ANNEAU];
+	int motif, canonique, analyses = 0;
+
+	for ( motif = 0 ; motif < NB_MOTIFS_ANNEAU ; motif++ ) // (Le représentant d'un anneau le précède toujours)
+	{
+		canonique = anneau_canonique(motif);
+		if(canonique == motif)
+		{
+			morts[motif] = anneau_mort(motif);
+			analyses++;
+		}
+		else
+		{
+			morts[motif] = morts[canonique];
+		}
+	}
+
+	printf("/*!\n");
+	printf(" *\t\\file\tmotifs.c\n");
+	printf(" *\t\\brief\tTables de motifs de voisinage (fichier généré par outils/genere_motifs.c: ne pas modifier)\n");
+	printf(" *\t\\author\tJulien Laurent\n");
+	printf(" *\n");
+	printf(" *\t%d anneaux, dont %d analysés (un par classe de symétrie).\n", NB_MOTIFS_ANNEAU, analyses);
+	printf(" */\n\n");
+	printf("#include \"motifs.h\"\n\n");
+
+	printf("const bool motifs_morts[NB_MOTIFS_ANNEAU] =\n{");
+	for ( motif = 0 ; motif < NB_MOTIFS_ANNEAU ; motif++ )
+	{
+		printf("%s%s%d", motif ? "," : "", (motif % 27 == 0) ? "\n\t" : " ", morts[motif]);
+	}
+	printf("\n};\n\n");
+
+	ecrit_poids("poids_losanges", poids_bridges);
+	printf("\n");
+	ecrit_poids("poids_connexions", poids_voisines);
+
+	return 0;
+}
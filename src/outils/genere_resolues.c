@@ -0,0 +1,53 @@
+/*!
+ *	\file	genere_resolues.c
+ *	\brief	Générateur des tables de positions résolues
+ *	\author	Julien Laurent
+ *
+ *	Ce programme résout toutes les positions d'un petit plateau jusqu'à un nombre de pions donné
+ *	(voir #genere_table_resolue()), et écrit la table dans le fichier de sa dimension
+ *	(#FICHIER_RESOLUES) du répertoire courant. Il se sert du solveur DFPN du jeu, et se compile donc
+ *	avec tous les fichiers du logiciel sauf main.c (depuis le répertoire src):
+ *	\code gcc -O2 -o genere_resolues outils/genere_resolues.c $(find ai model engine interfaces -name '*.c') $(sdl-config --cflags --libs) -lm \endcode
+ *	Le jeu cherche les tables dans le répertoire d'où il est lancé, celui du répertoire images:
+ *	\code cd .. && src/genere_resolues 5 \endcode
+ *	régénère la table 5x5 fournie avec le jeu (un quart d'heure de calcul). La table 4x4 ne sert que
+ *	d'oracle aux bancs d'essai (le jeu ne propose pas de plateau 4x4): elle n'est pas fournie, et
+ *	\code src/genere_resolues 4 \endcode
+ *	la génère en quelques secondes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../engine/engine_functions.h"
+
+/*!
+ *	\author	Julien Laurent
+ *	\param	argc Nombre d'arguments
+ *	\param	argv Dimension du plateau (5 par défaut), puis nombre maximal de pions des positions (#PIONS_MAX_RESOLUES_4 ou #PIONS_MAX_RESOLUES_5 par défaut)
+ *	\return	EXIT_SUCCESS si la table a été écrite, EXIT_FAILURE sinon
+ */
+int main(int argc, char *argv[])
+{
+	int dimension = (argc > 1) ? atoi(argv[1]) : 5;
+	int pions_max = (argc > 2) ? atoi(argv[2]) : (dimension == 4) ? PIONS_MAX_RESOLUES_4 : PIONS_MAX_RESOLUES_5;
+	plateau *p;
+
+	if(dimension < DIMENSION_MIN_RESOLUES || dimension > DIMENSION_MAX_RESOLUES)
+	{
+		fprintf(stderr, "Dimension %d non prise en charge (de %d a %d)\n", dimension, DIMENSION_MIN_RESOLUES, DIMENSION_MAX_RESOLUES);
+		return EXIT_FAILURE;
+	}
+
+	p = nouveau_plateau(dimension);
+	if(p == NULL || genere_table_resolue(p, pions_max) != 0)
+	{
+		fprintf(stderr, "Echec de la generation de la table %dx%d\n", dimension, dimension);
+		detruis_plateau(&p);
+		return EXIT_FAILURE;
+	}
+
+	printf("Table %dx%d ecrite (positions jusqu'a %d pions)\n", dimension, dimension, pions_max);
+	detruis_plateau(&p);
+	return EXIT_SUCCESS;
+}